@@ -0,0 +1,37 @@
+#include <stdlib.h>
+#include "arena.h"
+
+void arenaInit(Arena *arena, size_t block_size) {
+    arena->head = NULL;
+    arena->block_size = block_size > 0 ? block_size : ARENA_BLOCK_SIZE;
+    arena->allocated = 0;
+}
+
+void *arenaAlloc(Arena *arena, size_t bytes, size_t align) {
+    ArenaBlock *block = arena->head;
+    size_t offset = block ? (block->used + align - 1) & ~(align - 1) : 0;
+
+    if (!block || offset > block->size || block->size - offset < bytes) {
+        size_t size = bytes > arena->block_size ? bytes : arena->block_size;
+        block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + size);
+        if (!block) return NULL;
+        block->size = size;
+        block->used = 0;
+        block->next = arena->head;
+        arena->head = block;
+        offset = 0;
+    }
+    void *p = (char*)block->data + offset;
+    block->used = offset + bytes;
+    arena->allocated += bytes;
+    return p;
+}
+
+void arenaFree(Arena *arena) {
+    while (arena->head) {
+        ArenaBlock *next = arena->head->next;
+        free(arena->head);
+        arena->head = next;
+    }
+    arena->allocated = 0;
+}
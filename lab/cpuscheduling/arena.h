@@ -0,0 +1,63 @@
+//arena.h
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE (1 << 20)  /**< Default block size in bytes. */
+
+
+/**
+ * @struct ArenaBlock
+ * @brief One block of an arena; blocks are chained newest first.
+ */
+typedef struct ArenaBlock {
+  struct ArenaBlock *next;  /**< Previously filled block. */
+  size_t size;              /**< Usable bytes in data. */
+  size_t used;              /**< Bytes handed out. */
+  max_align_t data[];       /**< Storage. */
+} ArenaBlock;
+
+
+/**
+ * @struct Arena
+ * @brief Bump allocator for many small objects that are freed together.
+ * Allocations are carved out of large blocks, so a million burst lists cost
+ * a handful of mallocs and sit next to each other in memory. Blocks never
+ * move, so returned pointers stay valid until arenaFree().
+ */
+typedef struct {
+  ArenaBlock *head;    /**< Block being filled, or NULL. */
+  size_t block_size;   /**< Size of new blocks (larger requests get a block of their own). */
+  size_t allocated;    /**< Bytes handed out over all blocks (excluding alignment padding). */
+} Arena;
+
+
+/**
+ * @brief Creates an empty arena.
+ * @param arena Arena to initialize.
+ * @param block_size Bytes per block, or 0 for ARENA_BLOCK_SIZE.
+ */
+void arenaInit(Arena *arena, size_t block_size);
+
+
+/**
+ * @brief Allocates memory with the given alignment.
+ * - Consecutive allocations are packed with no padding beyond the alignment,
+ *   e.g. int arrays allocated with alignof(int) are back to back.
+ * @param arena Arena.
+ * @param bytes Size of the allocation.
+ * @param align Alignment: a power of two no larger than alignof(max_align_t).
+ * @return The memory, or NULL on allocation failure.
+ */
+void *arenaAlloc(Arena *arena, size_t bytes, size_t align);
+
+
+/**
+ * @brief Releases every block of the arena.
+ * @param arena Arena.
+ */
+void arenaFree(Arena *arena);
+
+#endif // ARENA_H
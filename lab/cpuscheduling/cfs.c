@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include "policy.h"
+#include "rbtree.h"
+
+#define NICE_0_WEIGHT 1024  /**< Weight of a nice-0 process. */
+#define VRUNTIME_SHIFT 20   /**< Fixed-point bits of vruntime, so short slices of heavy processes still count. */
+
+/**
+ * @brief Load weight of each nice value from -20 to 19 (Linux's prio_to_weight).
+ * Each step is about 1.25x, i.e. 10% of CPU between neighbouring nice levels.
+ */
+static const int niceWeight[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,
+     3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,
+      335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,
+       36,    29,    23,    18,    15
+};
+
+/**
+ * @struct CfsState
+ * @brief Ready set of the fair scheduler: queued processes in a red-black tree ordered by vruntime.
+ * vruntime is the CPU time a process received scaled by NICE_0_WEIGHT / weight,
+ * so the leftmost process is the one furthest behind its fair share.
+ */
+typedef struct {
+  Process *proc;           /**< Process array being scheduled. */
+  RbTree tree;             /**< Queued processes keyed by vruntime. */
+  long long *vruntime;     /**< Weighted virtual runtime of each process (fixed point). */
+  long long min_vruntime;  /**< Monotonic floor of the queue's vruntimes; arrivals start here. */
+  long long queued_weight; /**< Sum of the weights of the queued processes. */
+  int latency;             /**< Target latency. */
+  int min_granularity;     /**< Shortest slice. */
+} CfsState;
+
+/**
+ * @brief Weight of a process; its priority is used as the nice value, clamped to [-20, 19].
+ */
+static int weightOf(const Process *p) {
+    int nice = p->priority;
+    if (nice < -20) nice = -20;
+    if (nice > 19) nice = 19;
+    return niceWeight[nice + 20];
+}
+
+static int cfsInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    CfsState *s = (CfsState*)calloc(1, sizeof(CfsState));
+    if (!s) return -1;
+    s->vruntime = (long long*)calloc(num_processes > 0 ? num_processes : 1, sizeof(long long));
+    if (!s->vruntime || rbTreeInit(&s->tree, num_processes, s->vruntime) != 0) {
+        free(s->vruntime);
+        free(s);
+        return -1;
+    }
+    s->proc = proc;
+    s->min_granularity = params->cfs_min_granularity > 0 ? params->cfs_min_granularity : 1;
+    s->latency = params->cfs_latency > s->min_granularity ? params->cfs_latency : s->min_granularity;
+    *state = s;
+    return 0;
+}
+
+/**
+ * @brief Queues a process no further behind than min_vruntime.
+ * - New processes (and processes migrating in) therefore cannot claim the
+ *   CPU for all the time they were absent.
+ */
+static void cfsArrival(void *state, int index, int time) {
+    CfsState *s = (CfsState*)state;
+    (void)time;
+    if (s->vruntime[index] < s->min_vruntime) s->vruntime[index] = s->min_vruntime;
+    rbTreeInsert(&s->tree, index);
+    s->queued_weight += weightOf(&s->proc[index]);
+}
+
+/**
+ * @brief Dequeues the process with the smallest vruntime (the cached leftmost node).
+ */
+static int cfsSelect(void *state, int time) {
+    CfsState *s = (CfsState*)state;
+    (void)time;
+    int index = s->tree.first;
+    if (index == -1) return -1;
+    rbTreeErase(&s->tree, index);
+    s->queued_weight -= weightOf(&s->proc[index]);
+    return index;
+}
+
+/**
+ * @brief The process's weighted share of the scheduling period.
+ * - The period is the target latency, stretched to min_granularity per
+ *   runnable process when there are too many to fit.
+ */
+static int cfsSlice(void *state, int index, int time) {
+    CfsState *s = (CfsState*)state;
+    (void)time;
+    long long runnable = s->tree.size + 1;
+    long long weight = weightOf(&s->proc[index]);
+    long long period = s->latency;
+    if (runnable * s->min_granularity > period) period = runnable * s->min_granularity;
+
+    long long slice = period * weight / (s->queued_weight + weight);
+    if (slice < s->min_granularity) slice = s->min_granularity;
+    return slice < INT_MAX ? (int)slice : INT_MAX;
+}
+
+/**
+ * @brief Charges the slice to the process's vruntime and advances min_vruntime.
+ */
+static void cfsTick(void *state, int index, int ran, int time) {
+    CfsState *s = (CfsState*)state;
+    (void)time;
+    s->vruntime[index] += ((long long)ran * NICE_0_WEIGHT << VRUNTIME_SHIFT) / weightOf(&s->proc[index]);
+
+    long long floor = s->vruntime[index];
+    if (s->tree.first != -1 && s->vruntime[s->tree.first] < floor) floor = s->vruntime[s->tree.first];
+    if (floor > s->min_vruntime) s->min_vruntime = floor;
+
+    if (s->proc[index].remaining_time > 0) cfsArrival(s, index, time);
+}
+
+/**
+ * @brief A new process starts from zero (so at min_vruntime when it arrives).
+ */
+static void cfsReset(void *state, int index) {
+    ((CfsState*)state)->vruntime[index] = 0;
+}
+
+static void cfsDestroy(void *state) {
+    CfsState *s = (CfsState*)state;
+    rbTreeFree(&s->tree);
+    free(s->vruntime);
+    free(s);
+}
+
+const Policy cfsPolicy = {
+    "cfs", "Completely Fair Scheduler", 0,
+    cfsInit, cfsArrival, cfsSelect, cfsSlice, cfsTick, cfsDestroy, cfsReset
+};
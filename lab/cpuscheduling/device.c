@@ -0,0 +1,84 @@
+#include <limits.h>
+#include <stdlib.h>
+#include "device.h"
+
+/**
+ * @brief Puts a request on a device from `start`, or from its submission if that is later.
+ * - Completions are retired lazily, so a device may finish before a request
+ *   already queued behind it was even issued.
+ */
+static void startRequest(DeviceQueue *dq, int device, const IoRequest *req, int start) {
+    if (start < req->submitted) start = req->submitted;
+    dq->serving[device] = req->index;
+    dq->done_at[device] = (start > INT_MAX - req->length) ? INT_MAX : start + req->length;
+    dq->busy += req->length;
+    dq->waited += start - req->submitted;
+}
+
+int deviceQueueInit(DeviceQueue *dq, int devices, int capacity) {
+    dq->queue = NULL;
+    dq->serving = dq->done_at = NULL;
+    if (devices < 1) return -1;
+    dq->queue = (IoRequest*)malloc((capacity > 0 ? capacity : 1) * sizeof(IoRequest));
+    dq->serving = (int*)malloc(devices * sizeof(int));
+    dq->done_at = (int*)malloc(devices * sizeof(int));
+    if (!dq->queue || !dq->serving || !dq->done_at) {
+        deviceQueueFree(dq);
+        return -1;
+    }
+    for (int d = 0; d < devices; d++) dq->serving[d] = -1;
+    dq->head = dq->count = 0;
+    dq->capacity = capacity > 0 ? capacity : 1;
+    dq->devices = devices;
+    dq->busy = dq->waited = dq->requests = 0;
+    return 0;
+}
+
+void deviceSubmit(DeviceQueue *dq, int index, int length, int time) {
+    IoRequest req = { index, length, time };
+    dq->requests++;
+    for (int d = 0; d < dq->devices; d++) {
+        if (dq->serving[d] == -1) {
+            startRequest(dq, d, &req, time);
+            return;
+        }
+    }
+    dq->queue[(dq->head + dq->count++) % dq->capacity] = req;
+}
+
+int deviceNextCompletion(const DeviceQueue *dq) {
+    int next = INT_MAX;
+    for (int d = 0; d < dq->devices; d++) {
+        if (dq->serving[d] != -1 && dq->done_at[d] < next) next = dq->done_at[d];
+    }
+    return next;
+}
+
+int deviceComplete(DeviceQueue *dq, int time) {
+    int device = -1;
+    for (int d = 0; d < dq->devices; d++) {
+        if (dq->serving[d] != -1 && dq->done_at[d] <= time && (device == -1 || dq->done_at[d] < dq->done_at[device])) {
+            device = d;
+        }
+    }
+    if (device == -1) return -1;
+
+    int index = dq->serving[device];
+    dq->serving[device] = -1;
+    if (dq->count > 0) {
+        // The device picks up the oldest waiting request the moment it frees up.
+        IoRequest req = dq->queue[dq->head];
+        dq->head = (dq->head + 1) % dq->capacity;
+        dq->count--;
+        startRequest(dq, device, &req, dq->done_at[device]);
+    }
+    return index;
+}
+
+void deviceQueueFree(DeviceQueue *dq) {
+    free(dq->queue);
+    free(dq->serving);
+    free(dq->done_at);
+    dq->queue = NULL;
+    dq->serving = dq->done_at = NULL;
+}
@@ -0,0 +1,84 @@
+//device.h
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+
+/**
+ * @struct IoRequest
+ * @brief An I/O burst waiting for a device.
+ */
+typedef struct {
+  int index;      /**< Process that issued the request. */
+  int length;     /**< Device time the request needs. */
+  int submitted;  /**< Time the request was issued. */
+} IoRequest;
+
+
+/**
+ * @struct DeviceQueue
+ * @brief A pool of identical I/O devices served from one FIFO device queue.
+ * A process that ends a CPU burst issues a request; a free device serves it
+ * at once, otherwise it waits its turn. When a request finishes, the device
+ * starts the next waiting one at that moment.
+ */
+typedef struct {
+  IoRequest *queue;       /**< Ring of waiting requests. */
+  int head;               /**< Oldest waiting request. */
+  int count;              /**< Waiting requests. */
+  int capacity;           /**< Entries in queue. */
+  int devices;            /**< Number of devices. */
+  int *serving;           /**< Process each device is serving, or -1. */
+  int *done_at;           /**< Time each device finishes its request. */
+  long long busy;         /**< Device time spent serving requests (summed over devices). */
+  long long waited;       /**< Time requests spent waiting for a free device. */
+  long long requests;     /**< Requests issued. */
+} DeviceQueue;
+
+
+/**
+ * @brief Creates idle devices and an empty device queue.
+ * @param dq Device queue to initialize.
+ * @param devices Number of devices (at least 1).
+ * @param capacity Most requests outstanding at once (one per process is enough).
+ * @return 0 on success, -1 on invalid parameters or allocation failure.
+ */
+int deviceQueueInit(DeviceQueue *dq, int devices, int capacity);
+
+
+/**
+ * @brief Issues an I/O request.
+ * @param dq Device queue.
+ * @param index Process issuing the request.
+ * @param length Device time needed (at least 1).
+ * @param time Current time.
+ */
+void deviceSubmit(DeviceQueue *dq, int index, int length, int time);
+
+
+/**
+ * @brief Returns when the next request in service finishes.
+ * @param dq Device queue.
+ * @return Completion time, or INT_MAX if every device is idle.
+ */
+int deviceNextCompletion(const DeviceQueue *dq);
+
+
+/**
+ * @brief Retires the earliest request finished by `time`.
+ * - Call repeatedly until it returns -1 to collect every finished request,
+ *   in completion order.
+ * @param dq Device queue.
+ * @param time Current time.
+ * @return Process whose I/O finished, or -1 if none has by `time`.
+ */
+int deviceComplete(DeviceQueue *dq, int time);
+
+
+/**
+ * @brief Releases the device queue.
+ * @param dq Device queue.
+ */
+void deviceQueueFree(DeviceQueue *dq);
+
+#endif // DEVICE_H
@@ -0,0 +1,71 @@
+#include <stdlib.h>
+#include "gantt.h"
+
+/**
+ * @brief Writes one segment to the chart's stream.
+ */
+static void writeSegment(GanttChart *gc, const GanttSegment *seg) {
+    fprintf(gc->stream, "%d,%d,%d\n", seg->process_id, seg->start, seg->end);
+}
+
+void ganttInit(GanttChart *gc, const char *title, FILE *stream) {
+    gc->title = title;
+    gc->segments = NULL;
+    gc->count = gc->capacity = 0;
+    gc->stream = stream;
+    gc->total = 0;
+    if (stream) fprintf(stream, "# %s\n", title);
+}
+
+int ganttRecord(GanttChart *gc, int process_id, int start, int end) {
+    if (gc->count > 0) {
+        GanttSegment *last = &gc->segments[gc->count - 1];
+        if (last->process_id == process_id && last->end == start) {
+            last->end = end;
+            return 0;
+        }
+        // Streaming keeps only the open segment: close it before starting the next one.
+        if (gc->stream) {
+            writeSegment(gc, last);
+            gc->count = 0;
+        }
+    }
+
+    if (gc->count == gc->capacity) {
+        int capacity = gc->capacity ? gc->capacity * 2 : 64;
+        GanttSegment *grown = (GanttSegment*)realloc(gc->segments, capacity * sizeof(GanttSegment));
+        if (!grown) return -1;
+        gc->segments = grown;
+        gc->capacity = capacity;
+    }
+    gc->segments[gc->count++] = (GanttSegment){ process_id, start, end };
+    gc->total++;
+    return 0;
+}
+
+void ganttFlush(GanttChart *gc) {
+    if (!gc->stream) return;
+    if (gc->count > 0) writeSegment(gc, &gc->segments[0]);
+    gc->count = 0;
+    fflush(gc->stream);
+}
+
+void ganttPrint(GanttChart *gc) {
+    if (gc->stream) {
+        ganttFlush(gc);
+        printf("\nGantt Chart Execution Order (%s): %lld segments streamed\n", gc->title, gc->total);
+        return;
+    }
+
+    printf("\nGantt Chart Execution Order (%s):\n", gc->title);
+    for (int i = 0; i < gc->count; i++) {
+        printf("P%d ", gc->segments[i].process_id);
+    }
+    printf("\n");
+}
+
+void ganttFree(GanttChart *gc) {
+    free(gc->segments);
+    gc->segments = NULL;
+    gc->count = gc->capacity = 0;
+}
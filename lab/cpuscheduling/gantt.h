@@ -0,0 +1,80 @@
+//gantt.h
+
+#ifndef GANTT_H
+#define GANTT_H
+
+#include <stdio.h>
+
+
+/**
+ * @struct GanttSegment
+ * @brief One contiguous stretch of CPU time given to a process.
+ */
+typedef struct {
+  int process_id;  /**< Process that ran. */
+  int start;       /**< Time the stretch began. */
+  int end;         /**< Time the stretch ended. */
+} GanttSegment;
+
+
+/**
+ * @struct GanttChart
+ * @brief Run-length-encoded execution history of one scheduling run.
+ * Consecutive slices of the same process are merged into one segment.
+ * In streaming mode each segment is written out as soon as the next process
+ * starts, and only the open segment is kept in memory.
+ */
+typedef struct {
+  const char *title;        /**< Label printed with the chart. */
+  GanttSegment *segments;   /**< Segments kept in memory (only the open one when streaming). */
+  int count;                /**< Entries in segments. */
+  int capacity;             /**< Allocated entries in segments. */
+  FILE *stream;             /**< Destination of closed segments, or NULL to keep them in memory. */
+  long long total;          /**< Segments recorded so far, including streamed ones. */
+} GanttChart;
+
+
+/**
+ * @brief Prepares an empty chart.
+ * @param gc Chart to initialize.
+ * @param title Label used when the chart is printed (e.g. "SJF Preemptive").
+ * @param stream File that receives "pid,start,end" lines, or NULL to keep segments in memory.
+ */
+void ganttInit(GanttChart *gc, const char *title, FILE *stream);
+
+
+/**
+ * @brief Records that a process ran from start to end.
+ * - Merged into the last segment when the same process continues without a gap.
+ * @param gc Gantt chart.
+ * @param process_id Process that ran.
+ * @param start Start time of the slice.
+ * @param end End time of the slice.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int ganttRecord(GanttChart *gc, int process_id, int start, int end);
+
+
+/**
+ * @brief Writes the open segment of a streaming chart to its stream.
+ * - Does nothing for a chart kept in memory.
+ * @param gc Gantt chart.
+ */
+void ganttFlush(GanttChart *gc);
+
+
+/**
+ * @brief Prints the execution order, or a summary when the segments were streamed.
+ * - Flushes the open segment to the stream first (see ganttFlush()).
+ * @param gc Gantt chart.
+ */
+void ganttPrint(GanttChart *gc);
+
+
+/**
+ * @brief Releases the chart's memory (the stream is left open).
+ * @param gc Gantt chart.
+ */
+void ganttFree(GanttChart *gc);
+
+#endif // GANTT_H
@@ -0,0 +1,120 @@
+#include <math.h>
+#include "generator.h"
+
+/**
+ * @brief splitmix64: a small generator with the same sequence everywhere, unlike rand().
+ */
+static uint64_t nextRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Returns a uniform double in (0, 1].
+ */
+static double uniform(uint64_t *state) {
+    return ((nextRandom(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Draws one burst length (at least 1, at most spec->max_burst).
+ */
+static int drawBurst(const WorkloadSpec *spec, uint64_t *state) {
+    double burst;
+    if (spec->bursts == BURST_PARETO) {
+        // Scale chosen so the (unclipped) mean is mean_burst.
+        double scale = spec->mean_burst * (spec->pareto_alpha - 1) / spec->pareto_alpha;
+        burst = scale * pow(uniform(state), -1.0 / spec->pareto_alpha);
+    } else {
+        burst = -spec->mean_burst * log(uniform(state));
+    }
+    if (burst > spec->max_burst) return spec->max_burst;
+    return (burst < 1) ? 1 : (int)ceil(burst);
+}
+
+WorkloadSpec defaultWorkloadSpec(int num_processes, BurstDistribution bursts, uint64_t seed) {
+    WorkloadSpec spec = {
+        .num_processes = num_processes,
+        .load = 0.95,
+        .bursts = bursts,
+        .mean_burst = 10.0,
+        .pareto_alpha = 1.5,
+        .max_burst = 100000,
+        .priority_levels = 32,
+        .priority_skew = 1.2,
+        .seed = seed
+    };
+    return spec;
+}
+
+int generatorInit(WorkloadGenerator *gen, const WorkloadSpec *spec) {
+    if (spec->num_processes <= 0 || spec->load <= 0 || spec->mean_burst < 1 || spec->max_burst < 1 ||
+        spec->priority_levels <= 0 || (spec->bursts == BURST_PARETO && spec->pareto_alpha <= 1)) {
+        printf("Invalid workload parameters\n");
+        return -1;
+    }
+    gen->priority_cdf = (double*)malloc(spec->priority_levels * sizeof(double));
+    if (!gen->priority_cdf) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+
+    // Cumulative Zipf weights, searched by bisection for each process.
+    gen->priority_total = 0;
+    for (int k = 0; k < spec->priority_levels; k++) {
+        gen->priority_total += 1.0 / pow(k + 1, spec->priority_skew);
+        gen->priority_cdf[k] = gen->priority_total;
+    }
+    gen->spec = *spec;
+    gen->state = spec->seed;
+    gen->arrival = 0;
+    gen->generated = 0;
+    return 0;
+}
+
+int generatorNext(WorkloadGenerator *gen, Process *p) {
+    const WorkloadSpec *spec = &gen->spec;
+    if (gen->generated == spec->num_processes) return 0;
+
+    initializeProcess(p);
+    p->process_id = ++gen->generated;
+    p->arrival_time = (gen->arrival < INT_MAX) ? (int)gen->arrival : INT_MAX;
+    p->burst_time = drawBurst(spec, &gen->state);
+    p->remaining_time = p->burst_time;
+
+    double u = uniform(&gen->state) * gen->priority_total;
+    int lo = 0, hi = spec->priority_levels - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (gen->priority_cdf[mid] < u) lo = mid + 1; else hi = mid;
+    }
+    p->priority = lo;
+
+    // Poisson process: exponential gaps between arrivals.
+    gen->arrival += -(spec->mean_burst / spec->load) * log(uniform(&gen->state));
+    return 1;
+}
+
+void generatorFree(WorkloadGenerator *gen) {
+    free(gen->priority_cdf);
+    gen->priority_cdf = NULL;
+}
+
+int generateWorkload(const WorkloadSpec *spec, Process **proc) {
+    WorkloadGenerator gen;
+    if (generatorInit(&gen, spec) != 0) return -1;
+
+    Process *array = (Process*)malloc(spec->num_processes * sizeof(Process));
+    if (!array) {
+        printf("Memory allocation failed\n");
+        generatorFree(&gen);
+        return -1;
+    }
+    for (int i = 0; generatorNext(&gen, &array[i]); i++) {}
+
+    generatorFree(&gen);
+    *proc = array;
+    return 0;
+}
@@ -0,0 +1,100 @@
+//generator.h
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <stdint.h>
+#include "process.h"
+
+
+/**
+ * @enum BurstDistribution
+ * @brief Distribution of generated CPU burst lengths.
+ */
+typedef enum {
+  BURST_EXPONENTIAL,  /**< Exponential with the given mean. */
+  BURST_PARETO        /**< Heavy-tailed Pareto with the given mean and shape. */
+} BurstDistribution;
+
+
+/**
+ * @struct WorkloadSpec
+ * @brief Parameters of a synthetic workload.
+ * The same spec (including the seed) always generates the same processes,
+ * on any machine, so benchmark results can be compared across commits.
+ */
+typedef struct {
+  int num_processes;          /**< Number of processes to generate. */
+  double load;                /**< Offered CPU load; arrivals are Poisson with rate load / mean_burst. */
+  BurstDistribution bursts;   /**< Burst length distribution. */
+  double mean_burst;          /**< Mean burst length. */
+  double pareto_alpha;        /**< Pareto shape (> 1; smaller is heavier-tailed). */
+  int max_burst;              /**< Bursts are clipped to this length. */
+  int priority_levels;        /**< Priorities are 0 .. priority_levels - 1. */
+  double priority_skew;       /**< Zipf exponent: P(priority k) is proportional to 1 / (k + 1)^skew. */
+  uint64_t seed;              /**< Random seed. */
+} WorkloadSpec;
+
+
+/**
+ * @struct WorkloadGenerator
+ * @brief Stream of the processes of a spec, one at a time, in arrival order.
+ * Generates exactly the processes generateWorkload() stores, without keeping them.
+ */
+typedef struct {
+  WorkloadSpec spec;       /**< Workload parameters. */
+  double *priority_cdf;    /**< Cumulative Zipf weights of the priority levels. */
+  double priority_total;   /**< Sum of the Zipf weights. */
+  double arrival;          /**< Arrival time of the next process. */
+  uint64_t state;          /**< Random generator state. */
+  int generated;           /**< Processes generated so far. */
+} WorkloadGenerator;
+
+
+/**
+ * @brief Returns a spec with the default benchmark parameters.
+ * - load 0.95, exponential bursts with mean 10 (Pareto shape 1.5 when selected),
+ *   bursts clipped at 100000, 32 priority levels with skew 1.2.
+ * @param num_processes Number of processes.
+ * @param bursts Burst length distribution.
+ * @param seed Random seed.
+ * @return The spec.
+ */
+WorkloadSpec defaultWorkloadSpec(int num_processes, BurstDistribution bursts, uint64_t seed);
+
+
+/**
+ * @brief Generates a workload into a newly allocated process array.
+ * - Process ids are 1 .. num_processes in arrival order.
+ * @param spec Workload parameters.
+ * @param proc Output: array of processes (free with free()).
+ * @return 0 on success, -1 on invalid parameters or allocation failure.
+ */
+int generateWorkload(const WorkloadSpec *spec, Process **proc);
+
+
+/**
+ * @brief Starts a stream of the processes of a spec.
+ * @param gen Generator to initialize.
+ * @param spec Workload parameters (copied).
+ * @return 0 on success, -1 on invalid parameters or allocation failure (a message is printed).
+ */
+int generatorInit(WorkloadGenerator *gen, const WorkloadSpec *spec);
+
+
+/**
+ * @brief Generates the next process of the stream.
+ * @param gen Generator.
+ * @param p Output: the process, initialized and ready to schedule.
+ * @return 1 if a process was generated, 0 once spec.num_processes have been.
+ */
+int generatorNext(WorkloadGenerator *gen, Process *p);
+
+
+/**
+ * @brief Releases a generator.
+ * @param gen Generator.
+ */
+void generatorFree(WorkloadGenerator *gen);
+
+#endif // GENERATOR_H
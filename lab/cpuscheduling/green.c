@@ -0,0 +1,332 @@
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include "green.h"
+
+static GreenRuntime *runtime;              /**< Runtime being run (only one at a time). */
+static __thread GreenWorker *self;         /**< Worker of this kernel thread, or NULL. */
+static __thread GreenThread *current;      /**< Green thread running on this kernel thread, or NULL. */
+
+static int *errnoOfThread(void) {
+    return &errno;
+}
+
+/**
+ * @brief Finds errno of the kernel thread running the caller. The call goes
+ * through a volatile pointer because the compiler may otherwise reuse the
+ * errno address it computed before a swapcontext(), after which the green
+ * thread can be running on another kernel thread.
+ */
+static int *(*volatile errno_location)(void) = errnoOfThread;
+
+/**
+ * @brief Microseconds since the runtime was created.
+ */
+static long long nowUs(const GreenRuntime *rt) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec - rt->start.tv_sec) * 1000000LL + (ts.tv_nsec - rt->start.tv_nsec) / 1000;
+}
+
+/**
+ * @brief Narrows a time or duration to the int the Policy callbacks and
+ * Process fields take. An int of microseconds runs out after about 35
+ * minutes; from then on the policies see the time stand still at INT_MAX
+ * instead of wrapping negative.
+ */
+static int toInt(long long us) {
+    return us > INT_MAX ? INT_MAX : (int)us;
+}
+
+int greenInit(GreenRuntime *rt, const Policy *policy, const PolicyParams *params, const GreenConfig *config) {
+    memset(rt, 0, sizeof(*rt));
+    if (config->workers < 1 || config->workers > GREEN_MAX_WORKERS || config->tick_us < 0 ||
+        config->stack_size < 16384 || config->capacity < 1 || params->quantum < 1) {
+        printf("Invalid workers, tick, stack size, capacity or quantum\n");
+        return -1;
+    }
+    rt->policy = policy;
+    rt->params = *params;
+    rt->config = *config;
+    rt->proc = (Process*)malloc(config->capacity * sizeof(Process));
+    rt->thread = (GreenThread*)calloc(config->capacity, sizeof(GreenThread));
+    rt->in_use = (unsigned char*)calloc(config->capacity, 1);
+    if (!rt->proc || !rt->thread || !rt->in_use) {
+        printf("Memory allocation failed\n");
+        greenFree(rt);
+        return -1;
+    }
+    for (int i = 0; i < config->capacity; i++) initializeProcess(&rt->proc[i]);
+    if (policy->init(&rt->state, rt->proc, config->capacity, &rt->params) != 0) {
+        printf("Memory allocation failed\n");
+        rt->state = NULL;
+        greenFree(rt);
+        return -1;
+    }
+    pthread_mutex_init(&rt->lock, NULL);
+    pthread_cond_init(&rt->ready, NULL);
+    for (int i = 0; i < GREEN_MAX_WORKERS; i++) rt->worker[i].last = -1;
+    sketchInit(&rt->turnaround);
+    sketchInit(&rt->response);
+    clock_gettime(CLOCK_MONOTONIC, &rt->start);
+    return 0;
+}
+
+/**
+ * @brief First function of every green thread: runs the body, then hands the worker back for good.
+ */
+static void greenStart(int index) {
+    GreenThread *t = &runtime->thread[index];
+    t->masked--;
+    t->fn(t->arg);
+    t->masked++;
+    // The thread may have moved to another kernel thread: self is read again here.
+    self->reason = GREEN_FINISHED;
+    setcontext(&self->context);
+}
+
+/**
+ * @brief Points a slot's context at greenStart() on its stack.
+ * - Kept out of greenSpawn(): getcontext() returns twice as far as the compiler knows.
+ */
+static void prepareContext(GreenThread *t, int index, int stack_size) {
+    getcontext(&t->context);
+    t->context.uc_stack.ss_sp = t->stack;
+    t->context.uc_stack.ss_size = stack_size;
+    t->context.uc_link = NULL;
+    makecontext(&t->context, (void (*)(void))greenStart, 1, index);
+}
+
+int greenSpawn(GreenRuntime *rt, GreenFunc fn, void *arg, int burst, int priority) {
+    GreenThread *caller = current;
+    int id = -1;
+
+    if (caller) caller->masked++;
+    pthread_mutex_lock(&rt->lock);
+    if (rt->live < rt->config.capacity) {
+        // Next free slot round the array, as in onlineSubmit().
+        int index = rt->cursor;
+        while (rt->in_use[index]) index = (index + 1 == rt->config.capacity) ? 0 : index + 1;
+        GreenThread *t = &rt->thread[index];
+        if (!t->stack) t->stack = (char*)malloc(rt->config.stack_size);
+        if (t->stack) {
+            rt->cursor = (index + 1 == rt->config.capacity) ? 0 : index + 1;
+            prepareContext(t, index, rt->config.stack_size);
+            t->fn = fn;
+            t->arg = arg;
+            t->masked = 1; // Until greenStart() runs.
+            t->first_run = -1;
+
+            long long now = nowUs(rt);
+            Process *p = &rt->proc[index];
+            initializeProcess(p);
+            p->process_id = id = rt->next_id++;
+            p->arrival_time = toInt(now);
+            t->arrived = now;
+            p->burst_time = p->remaining_time = burst > 0 ? burst : 1;
+            p->priority = priority;
+            if (rt->policy->reset) rt->policy->reset(rt->state, index);
+            rt->in_use[index] = 1;
+            rt->live++;
+            rt->arrivals++;
+            rt->policy->onArrival(rt->state, index, toInt(now));
+            pthread_cond_signal(&rt->ready);
+        }
+    }
+    pthread_mutex_unlock(&rt->lock);
+    if (caller) caller->masked--;
+    return id;
+}
+
+void greenYield(void) {
+    GreenThread *t = current;
+    if (!t) return;
+    t->masked++;
+    GreenWorker *w = self;
+    int saved_errno = errno;
+    w->reason = GREEN_YIELDED;
+    swapcontext(&t->context, &w->context);
+    *errno_location() = saved_errno;
+    t->masked--;
+}
+
+void greenPreemptDisable(void) {
+    GreenThread *t = current;
+    if (t) t->masked++;
+}
+
+void greenPreemptEnable(void) {
+    GreenThread *t = current;
+    if (t) t->masked--;
+}
+
+/**
+ * @brief GREEN_SIGNAL handler: sends the running green thread back to its
+ * worker if its slice is used up, or if a preemptive policy has a new arrival.
+ * The thread resumes here, possibly on another kernel thread, when it is next dispatched.
+ */
+static void onTimer(int sig) {
+    (void)sig;
+    GreenThread *t = current;
+    GreenWorker *w = self;
+    if (!t || t->masked) return;
+
+    int saved_errno = errno;
+    long long now = nowUs(runtime);
+    if (now - w->dispatched >= w->slice || (runtime->policy->preemptive && runtime->arrivals != w->arrivals_seen)) {
+        t->masked++;
+        w->reason = GREEN_PREEMPTED;
+        swapcontext(&t->context, &w->context);
+        // Resumed, maybe on another kernel thread: the thread gets its errno back there
+        *errno_location() = saved_errno;
+        t->masked--;
+        return;
+    }
+    errno = saved_errno;
+}
+
+/**
+ * @brief Dispatch loop of a worker: runs the policy's choices until no thread is left.
+ */
+static void workerLoop(GreenRuntime *rt, GreenWorker *w) {
+    const Policy *policy = rt->policy;
+
+    self = w;
+    pthread_mutex_lock(&rt->lock);
+    while (1) {
+        long long now = nowUs(rt);
+        int index = policy->selectNext(rt->state, toInt(now));
+        if (index == -1) {
+            if (rt->live == 0) break;
+            pthread_cond_wait(&rt->ready, &rt->lock); // Threads are running elsewhere and may come back.
+            continue;
+        }
+        GreenThread *t = &rt->thread[index];
+        Process *p = &rt->proc[index];
+        rt->dispatches++;
+        if (p->process_id != w->last) rt->switches++;
+        w->last = p->process_id;
+        if (t->first_run == -1) {
+            t->first_run = now;
+            sketchAdd(&rt->response, toInt(now - t->arrived));
+        }
+        w->slice = policy->sliceLength(rt->state, index, toInt(now));
+        w->arrivals_seen = rt->arrivals;
+        w->dispatched = now;
+        pthread_mutex_unlock(&rt->lock);
+
+        // t->masked is still 1, so a tick before the switch leaves it alone.
+        current = t;
+        w->running = 1;
+        swapcontext(&w->context, &t->context);
+        w->running = 0;
+        current = NULL;
+
+        pthread_mutex_lock(&rt->lock);
+        now = nowUs(rt);
+        int ran = toInt(now - w->dispatched);
+        if (w->reason == GREEN_FINISHED) {
+            p->remaining_time = 0;
+            p->is_completed = 1;
+            p->completion_time = toInt(now);
+        } else {
+            // A thread that outlives its estimate stays runnable, with the least time left.
+            p->remaining_time = p->remaining_time - ran > 0 ? p->remaining_time - ran : 1;
+            if (w->reason == GREEN_PREEMPTED) rt->preemptions++; else rt->yields++;
+        }
+        policy->onTick(rt->state, index, ran, toInt(now));
+        if (p->is_completed) {
+            rt->in_use[index] = 0;
+            rt->live--;
+            rt->completed++;
+            sketchAdd(&rt->turnaround, toInt(now - t->arrived));
+            if (rt->live == 0) pthread_cond_broadcast(&rt->ready);
+        } else {
+            pthread_cond_signal(&rt->ready); // Back in the ready set: an idle worker may take it.
+        }
+    }
+    pthread_mutex_unlock(&rt->lock);
+    self = NULL;
+}
+
+/**
+ * @brief Body of the extra worker kernel threads.
+ */
+static void *workerMain(void *arg) {
+    workerLoop(runtime, (GreenWorker*)arg);
+    return NULL;
+}
+
+/**
+ * @brief Body of the ticker: signals every worker running a green thread once per tick.
+ */
+static void *tickerMain(void *arg) {
+    GreenRuntime *rt = (GreenRuntime*)arg;
+    struct timespec period = { rt->config.tick_us / 1000000, (rt->config.tick_us % 1000000) * 1000L };
+
+    while (!rt->stop) {
+        nanosleep(&period, NULL);
+        for (int i = 0; i < rt->config.workers; i++) {
+            if (rt->worker[i].running) pthread_kill(rt->worker[i].tid, GREEN_SIGNAL);
+        }
+    }
+    return NULL;
+}
+
+int greenRun(GreenRuntime *rt) {
+    struct sigaction action, previous;
+    int status = 0, started = 1, ticking = 0;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onTimer;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    runtime = rt;
+    sigaction(GREEN_SIGNAL, &action, &previous);
+    long long start = nowUs(rt);
+
+    rt->stop = 0;
+    rt->worker[0].tid = pthread_self();
+    for (; started < rt->config.workers; started++) {
+        if (pthread_create(&rt->worker[started].tid, NULL, workerMain, &rt->worker[started]) != 0) {
+            printf("Unable to start worker %d; running on %d\n", started, started);
+            status = -1;
+            break;
+        }
+    }
+    if (rt->config.tick_us > 0) {
+        if (pthread_create(&rt->ticker, NULL, tickerMain, rt) == 0) {
+            ticking = 1;
+        } else {
+            printf("Unable to start the preemption timer; threads only yield\n");
+            status = -1;
+        }
+    }
+
+    workerLoop(rt, &rt->worker[0]);
+    for (int i = 1; i < started; i++) pthread_join(rt->worker[i].tid, NULL);
+    if (ticking) {
+        rt->stop = 1;
+        pthread_join(rt->ticker, NULL);
+    }
+    rt->elapsed_ms = (nowUs(rt) - start) / 1000.0;
+    sigaction(GREEN_SIGNAL, &previous, NULL);
+    runtime = NULL;
+    return status;
+}
+
+void greenFree(GreenRuntime *rt) {
+    if (rt->state) {
+        rt->policy->destroy(rt->state);
+        pthread_mutex_destroy(&rt->lock);
+        pthread_cond_destroy(&rt->ready);
+    }
+    if (rt->thread) {
+        for (int i = 0; i < rt->config.capacity; i++) free(rt->thread[i].stack);
+    }
+    free(rt->thread);
+    free(rt->proc);
+    free(rt->in_use);
+    memset(rt, 0, sizeof(*rt));
+}
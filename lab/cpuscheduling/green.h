@@ -0,0 +1,183 @@
+//green.h
+
+#ifndef GREEN_H
+#define GREEN_H
+
+#include <pthread.h>
+#include <signal.h>
+#include <ucontext.h>
+#include "policy.h"
+#include "stats.h"
+
+#define GREEN_SIGNAL SIGURG          /**< Preemption signal sent to the workers (ignored by default elsewhere). */
+#define GREEN_MAX_WORKERS 64         /**< Most worker kernel threads. */
+
+
+/**
+ * @brief Body of a green thread.
+ */
+typedef void (*GreenFunc)(void *arg);
+
+
+/**
+ * @enum GreenReason
+ * @brief Why a green thread gave its worker back.
+ */
+typedef enum {
+  GREEN_YIELDED,    /**< It called greenYield(). */
+  GREEN_PREEMPTED,  /**< The timer cut its slice. */
+  GREEN_FINISHED    /**< Its body returned. */
+} GreenReason;
+
+
+/**
+ * @struct GreenConfig
+ * @brief Machine side of a green-thread runtime.
+ */
+typedef struct {
+  int workers;      /**< Kernel threads running green threads (1 .. GREEN_MAX_WORKERS). */
+  int tick_us;      /**< Preemption timer period in microseconds (0: cooperative, threads only yield). */
+  int stack_size;   /**< Stack of each green thread in bytes. */
+  int capacity;     /**< Most green threads alive at once. */
+} GreenConfig;
+
+
+/**
+ * @struct GreenThread
+ * @brief A green thread: its stack, saved context and body.
+ */
+typedef struct {
+  ucontext_t context;           /**< Saved registers while it is not running. */
+  char *stack;                  /**< Stack (kept for the next thread of the slot). */
+  GreenFunc fn;                 /**< Body. */
+  void *arg;                    /**< Argument of the body. */
+  volatile sig_atomic_t masked; /**< Nesting depth of sections the timer must not preempt (>0 outside the body). */
+  long long arrived;            /**< Time it was spawned (arrival_time, unclamped). */
+  long long first_run;          /**< Time it was first dispatched, or -1. */
+} GreenThread;
+
+
+/**
+ * @struct GreenWorker
+ * @brief A kernel thread dispatching green threads.
+ */
+typedef struct {
+  pthread_t tid;                   /**< Kernel thread. */
+  ucontext_t context;              /**< Dispatcher context, resumed when a green thread gives up the CPU. */
+  volatile sig_atomic_t running;   /**< 1 while a green thread runs on it (the ticker signals it then). */
+  volatile sig_atomic_t reason;    /**< Why the last green thread came back (GreenReason). */
+  long long dispatched;            /**< Time the running green thread was dispatched. */
+  int slice;                       /**< Its slice, from the policy. */
+  int arrivals_seen;               /**< Arrivals counted when it was dispatched. */
+  int last;                        /**< process_id of the thread dispatched last, or -1. */
+} GreenWorker;
+
+
+/**
+ * @struct GreenRuntime
+ * @brief Green threads multiplexed on worker kernel threads by a scheduling policy.
+ * The Policy callbacks are the ready set, exactly as in simulate(): every
+ * green thread is a Process slot whose burst_time is the caller's estimate
+ * (what SJF orders by) and whose remaining_time counts down as it runs.
+ * Time is in microseconds since greenInit(), kept in long long; the Policy
+ * callbacks and Process fields get it as an int that stops at INT_MAX (after
+ * about 35 minutes) rather than wrapping. Slots are reused round the array
+ * as in OnlineScheduler, so ties stay first-come first-served.
+ *
+ * Preemption: a ticker thread sends GREEN_SIGNAL to every busy worker each
+ * tick_us; the handler switches back to the dispatcher when the slice is used
+ * up or, for a preemptive policy, when a thread arrived since the dispatch.
+ * A green thread may be stopped anywhere outside greenPreemptDisable()
+ * sections, so calls into non-reentrant code (malloc, stdio) that other green
+ * threads on the same runtime also make belong in such a section.
+ *
+ * Only one runtime runs at a time.
+ */
+typedef struct {
+  const Policy *policy;           /**< Policy dispatching the threads. */
+  PolicyParams params;            /**< Its tunables (quantum in microseconds). */
+  GreenConfig config;             /**< Machine parameters. */
+  void *state;                    /**< Policy state. */
+  Process *proc;                  /**< What the policy sees of each slot. */
+  GreenThread *thread;            /**< Green threads, indexed by slot. */
+  unsigned char *in_use;          /**< 1 for each slot holding a live thread. */
+  int cursor;                     /**< Slot after the one handed out last. */
+  int live;                       /**< Threads spawned and not finished. */
+  int next_id;                    /**< process_id of the next thread. */
+  volatile int arrivals;          /**< Threads made ready so far (preemptive policies watch it). */
+  pthread_mutex_t lock;           /**< Protects everything above and the counters below. */
+  pthread_cond_t ready;           /**< Signalled when a thread becomes ready or the last one finishes. */
+  GreenWorker worker[GREEN_MAX_WORKERS]; /**< Workers; worker 0 is the thread calling greenRun(). */
+  pthread_t ticker;               /**< Preemption timer thread. */
+  volatile int stop;              /**< Tells the ticker to exit. */
+  struct timespec start;          /**< Time origin. */
+  long long completed;            /**< Threads finished. */
+  long long dispatches;           /**< Threads dispatched. */
+  long long switches;             /**< Dispatches of a different thread than the worker ran last. */
+  long long preemptions;          /**< Slices cut by the timer. */
+  long long yields;               /**< Slices ended by greenYield(). */
+  QuantileSketch turnaround;      /**< Spawn to finish, per thread (microseconds). */
+  QuantileSketch response;        /**< Spawn to first dispatch, per thread (microseconds). */
+  double elapsed_ms;              /**< Wall-clock time of greenRun(). */
+} GreenRuntime;
+
+
+/**
+ * @brief Creates a runtime with no threads.
+ * @param rt Runtime to initialize.
+ * @param policy Policy dispatching the threads.
+ * @param params Tunables passed to the policy (copied; quantum in microseconds).
+ * @param config Machine parameters (copied).
+ * @return 0 on success, -1 on invalid parameters or allocation failure (a message is printed).
+ */
+int greenInit(GreenRuntime *rt, const Policy *policy, const PolicyParams *params, const GreenConfig *config);
+
+
+/**
+ * @brief Creates a green thread, ready at once.
+ * - May be called before greenRun(), from a green thread, or from any other kernel thread.
+ * @param rt Runtime.
+ * @param fn Body.
+ * @param arg Argument of the body.
+ * @param burst Estimated run time in microseconds (at least 1; SJF and SRTF order by it).
+ * @param priority Priority (lower runs first under the priority policies).
+ * @return The thread's process_id, or -1 if every slot is in use or its stack could not be allocated.
+ */
+int greenSpawn(GreenRuntime *rt, GreenFunc fn, void *arg, int burst, int priority);
+
+
+/**
+ * @brief Gives up the CPU: the policy takes the calling thread back and picks the next one.
+ * - Does nothing outside a green thread.
+ */
+void greenYield(void);
+
+
+/**
+ * @brief Keeps the timer from preempting the calling green thread until greenPreemptEnable().
+ * - Sections nest. Does nothing outside a green thread.
+ */
+void greenPreemptDisable(void);
+
+
+/**
+ * @brief Ends a greenPreemptDisable() section.
+ */
+void greenPreemptEnable(void);
+
+
+/**
+ * @brief Runs the threads on config.workers kernel threads until every one has finished.
+ * @param rt Runtime.
+ * @return 0 on success, -1 if a worker or the ticker could not be started.
+ */
+int greenRun(GreenRuntime *rt);
+
+
+/**
+ * @brief Releases the runtime.
+ * @param rt Runtime.
+ */
+void greenFree(GreenRuntime *rt);
+
+#endif // GREEN_H
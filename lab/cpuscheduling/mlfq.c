@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include "policy.h"
+
+#define MLFQ_MAX_LEVELS 30  /**< Levels fit in the bits of the non-empty mask. */
+
+/**
+ * @struct MlfqState
+ * @brief Ready set of the multi-level feedback queue.
+ * Each level is an intrusive FIFO list threaded through next[], so moving a
+ * process between levels and boosting every level never allocates. A bit per
+ * level marks the non-empty lists, so the highest ready level is one ctz away.
+ */
+typedef struct {
+  Process *proc;           /**< Process array being scheduled. */
+  int *next;               /**< Next process in the same level list, or -1. */
+  int *level;              /**< Current level of each process (valid while stamp matches). */
+  int *used;               /**< Time used of the current level's allotment. */
+  int *stamp;              /**< Boost count when level and used were last set. */
+  int head[MLFQ_MAX_LEVELS];     /**< First process of each level, or -1. */
+  int tail[MLFQ_MAX_LEVELS];     /**< Last process of each level, or -1. */
+  int allotment[MLFQ_MAX_LEVELS]; /**< Time a process may use at each level before demotion. */
+  unsigned nonempty;       /**< Bit i set if level i has queued processes. */
+  int levels;              /**< Number of levels. */
+  int boost;               /**< Boost interval, or 0. */
+  int next_boost;          /**< Time of the next boost. */
+  int boosts;              /**< Boosts so far. */
+} MlfqState;
+
+static int mlfqInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    size_t n = num_processes > 0 ? num_processes : 1;
+    MlfqState *s = (MlfqState*)calloc(1, sizeof(MlfqState));
+    if (!s) return -1;
+    s->next = (int*)malloc(n * sizeof(int));
+    s->level = (int*)calloc(n, sizeof(int));
+    s->used = (int*)calloc(n, sizeof(int));
+    s->stamp = (int*)calloc(n, sizeof(int));
+    if (!s->next || !s->level || !s->used || !s->stamp) {
+        free(s->next);
+        free(s->level);
+        free(s->used);
+        free(s->stamp);
+        free(s);
+        return -1;
+    }
+
+    s->proc = proc;
+    s->levels = params->mlfq_levels;
+    if (s->levels < 1) s->levels = 1;
+    if (s->levels > MLFQ_MAX_LEVELS) s->levels = MLFQ_MAX_LEVELS;
+    for (int i = 0; i < s->levels; i++) {
+        long long allotment = (long long)params->quantum << i;
+        s->allotment[i] = allotment < INT_MAX ? (int)allotment : INT_MAX;
+        s->head[i] = s->tail[i] = -1;
+    }
+    s->boost = params->mlfq_boost > 0 ? params->mlfq_boost : 0;
+    s->next_boost = s->boost ? s->boost : INT_MAX;
+    *state = s;
+    return 0;
+}
+
+static void pushBack(MlfqState *s, int level, int index) {
+    s->next[index] = -1;
+    if (s->tail[level] == -1) s->head[level] = index;
+    else s->next[s->tail[level]] = index;
+    s->tail[level] = index;
+    s->nonempty |= 1u << level;
+}
+
+static void pushFront(MlfqState *s, int level, int index) {
+    s->next[index] = s->head[level];
+    if (s->head[level] == -1) s->tail[level] = index;
+    s->head[level] = index;
+    s->nonempty |= 1u << level;
+}
+
+/**
+ * @brief Moves every queued process to the top level once a boost is due.
+ * - Lists are concatenated in level order; levels and allotments of all
+ *   processes (queued or running) reset lazily through the boost stamp.
+ */
+static void boostIfDue(MlfqState *s, int time) {
+    if (time < s->next_boost) return;
+    for (int i = 1; i < s->levels; i++) {
+        if (s->head[i] == -1) continue;
+        if (s->tail[0] == -1) s->head[0] = s->head[i];
+        else s->next[s->tail[0]] = s->head[i];
+        s->tail[0] = s->tail[i];
+        s->head[i] = s->tail[i] = -1;
+    }
+    s->nonempty = s->head[0] != -1;
+    s->boosts++;
+    long long next = ((long long)time / s->boost + 1) * s->boost;
+    s->next_boost = next < INT_MAX ? (int)next : INT_MAX;
+}
+
+/**
+ * @brief Returns the level of a process, applying any boost it has missed.
+ */
+static int levelOf(MlfqState *s, int index) {
+    if (s->stamp[index] != s->boosts) {
+        s->stamp[index] = s->boosts;
+        s->level[index] = 0;
+        s->used[index] = 0;
+    }
+    return s->level[index];
+}
+
+/**
+ * @brief A new process starts at the top level with a fresh allotment.
+ * - Slots are zeroed by mlfqInit(), so only a reused slot needs this.
+ */
+static void mlfqReset(void *state, int index) {
+    MlfqState *s = (MlfqState*)state;
+    s->stamp[index] = s->boosts;
+    s->level[index] = 0;
+    s->used[index] = 0;
+}
+
+/**
+ * @brief Queues a process at its current level, keeping what it used of the allotment.
+ * - A new process is at the top level (see mlfqReset()); one back from I/O
+ *   returns where it left off, so I/O between bursts does not undo demotion.
+ * - Per-CPU runqueues (see smp.h) each keep their own levels: a process
+ *   migrating in gets the level it last had on that CPU.
+ */
+static void mlfqArrival(void *state, int index, int time) {
+    MlfqState *s = (MlfqState*)state;
+    boostIfDue(s, time);
+    pushBack(s, levelOf(s, index), index);
+}
+
+static int mlfqSelect(void *state, int time) {
+    MlfqState *s = (MlfqState*)state;
+    boostIfDue(s, time);
+    if (!s->nonempty) return -1;
+
+    int level = __builtin_ctz(s->nonempty);
+    int index = s->head[level];
+    s->head[level] = s->next[index];
+    if (s->head[level] == -1) {
+        s->tail[level] = -1;
+        s->nonempty &= ~(1u << level);
+    }
+    return index;
+}
+
+/**
+ * @brief The rest of the allotment at the process's level.
+ */
+static int mlfqSlice(void *state, int index, int time) {
+    MlfqState *s = (MlfqState*)state;
+    (void)time;
+    int level = levelOf(s, index);
+    return s->allotment[level] - s->used[index];
+}
+
+/**
+ * @brief Charges the slice; a process that used up its allotment drops a level.
+ * - A process preempted by an arrival keeps its place at the head of its
+ *   level, so it only yields to higher levels.
+ * - A burst ending in I/O is charged too: the allotment spans the bursts.
+ */
+static void mlfqTick(void *state, int index, int ran, int time) {
+    MlfqState *s = (MlfqState*)state;
+    boostIfDue(s, time);
+    int level = levelOf(s, index);
+
+    s->used[index] += ran;
+    int demoted = s->used[index] >= s->allotment[level];
+    if (demoted) {
+        if (level + 1 < s->levels) level++;
+        s->level[index] = level;
+        s->used[index] = 0;
+    }
+    if (s->proc[index].remaining_time == 0) return;
+    if (demoted) pushBack(s, level, index);
+    else pushFront(s, level, index);
+}
+
+static void mlfqDestroy(void *state) {
+    MlfqState *s = (MlfqState*)state;
+    free(s->next);
+    free(s->level);
+    free(s->used);
+    free(s->stamp);
+    free(s);
+}
+
+const Policy mlfqPolicy = {
+    "mlfq", "Multi-Level Feedback Queue", 1,
+    mlfqInit, mlfqArrival, mlfqSelect, mlfqSlice, mlfqTick, mlfqDestroy, mlfqReset
+};
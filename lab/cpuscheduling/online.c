@@ -0,0 +1,230 @@
+#include <string.h>
+#include "online.h"
+#include "workload.h"
+
+int onlineInit(OnlineScheduler *sched, const Policy *policy, const PolicyParams *params, int capacity) {
+    memset(sched, 0, sizeof(*sched));
+    if (capacity < 1 || params->io_devices < 1) {
+        printf("Invalid capacity or number of I/O devices\n");
+        return -1;
+    }
+    sched->policy = policy;
+    sched->params = *params;
+    sched->capacity = capacity;
+    sched->slot = (Process*)malloc(capacity * sizeof(Process));
+    sched->first_run = (int*)malloc(capacity * sizeof(int));
+    sched->burst = (int*)calloc(capacity, sizeof(int));
+    sched->in_use = (unsigned char*)calloc(capacity, 1);
+    sched->sketch = (RunSketches*)malloc(sizeof(RunSketches));
+    if (!sched->slot || !sched->first_run || !sched->burst || !sched->in_use || !sched->sketch ||
+        fifoQueueInit(&sched->pending, capacity) != 0 || deviceQueueInit(&sched->io, params->io_devices, capacity) != 0) {
+        printf("Memory allocation failed\n");
+        onlineFree(sched);
+        return -1;
+    }
+
+    // The policy sees a full array of processes, of which only the submitted ones ever arrive.
+    for (int i = 0; i < capacity; i++) {
+        initializeProcess(&sched->slot[i]);
+        sched->first_run[i] = -1;
+    }
+    if (policy->init(&sched->state, sched->slot, capacity, &sched->params) != 0) {
+        printf("Memory allocation failed\n");
+        sched->state = NULL;
+        onlineFree(sched);
+        return -1;
+    }
+    sketchInit(&sched->sketch->waiting);
+    sketchInit(&sched->sketch->turnaround);
+    sketchInit(&sched->sketch->response);
+    sched->running = sched->last_index = -1;
+    sched->result.policy = policy;
+    sched->result.cpus = 1;
+    return 0;
+}
+
+int onlineSubmit(OnlineScheduler *sched, const Process *p) {
+    if (sched->live == sched->capacity || p->arrival_time < sched->horizon || p->arrival_time < sched->last_arrival) {
+        return -1;
+    }
+
+    // Next free slot round the array, so slots (and ties) follow submission order.
+    int index = sched->cursor;
+    while (sched->in_use[index]) index = (index + 1 == sched->capacity) ? 0 : index + 1;
+    sched->cursor = (index + 1 == sched->capacity) ? 0 : index + 1;
+    sched->in_use[index] = 1;
+    sched->live++;
+    Process *slot = &sched->slot[index];
+    *slot = *p;
+    slot->remaining_time = slot->bursts ? slot->bursts[0] : slot->burst_time;
+    slot->completion_time = 0;
+    slot->is_completed = 0;
+    sched->first_run[index] = -1;
+    sched->burst[index] = 0;
+    if (sched->policy->reset) sched->policy->reset(sched->state, index);
+
+    fifoQueuePush(&sched->pending, index);
+    sched->last_arrival = p->arrival_time;
+    sched->submitted++;
+    return 0;
+}
+
+/**
+ * @brief Records a finished process: its metrics go into the sketches and its completion into done.
+ * @return 0 on success, -1 if done could not grow.
+ */
+static int recordCompletion(OnlineScheduler *sched, int index) {
+    Process *p = &sched->slot[index];
+    if (sched->num_done == sched->done_capacity) {
+        int capacity = sched->done_capacity ? sched->done_capacity * 2 : 1024;
+        OnlineCompletion *grown = (OnlineCompletion*)realloc(sched->done, capacity * sizeof(OnlineCompletion));
+        if (!grown) {
+            printf("Memory allocation failed\n");
+            return -1;
+        }
+        sched->done = grown;
+        sched->done_capacity = capacity;
+    }
+    sched->done[sched->num_done++] = (OnlineCompletion){
+        p->process_id, p->arrival_time, sched->first_run[index], p->completion_time,
+        p->burst_time, p->io_time, p->priority
+    };
+
+    sketchAdd(&sched->sketch->waiting, calculateWaitingTime(p));
+    sketchAdd(&sched->sketch->turnaround, calculateTurnarroundTime(p));
+    sketchAdd(&sched->sketch->response, sched->first_run[index] - p->arrival_time);
+    if (p->completion_time > sched->result.makespan) sched->result.makespan = p->completion_time;
+    sched->completed++;
+    return 0;
+}
+
+int onlineAdvance(OnlineScheduler *sched, int until) {
+    const Policy *policy = sched->policy;
+    Process *proc = sched->slot;
+    FifoQueue *pending = &sched->pending;
+    SimResult *result = &sched->result;
+    int time = sched->time, status = 0;
+    double start = wallClockMs();
+
+    if (until > sched->horizon) sched->horizon = until;
+    // Every arrival before `until` has been submitted, so every event before it can be handled.
+    while (time < until && status == 0) {
+        int delivered = 0;
+        while (pending->size > 0 && proc[pending->slots[pending->head]].arrival_time <= time) {
+            policy->onArrival(sched->state, fifoQueuePop(pending), time);
+            delivered = 1;
+        }
+        for (int index; (index = deviceComplete(&sched->io, time)) != -1; ) {
+            proc[index].remaining_time = proc[index].bursts[++sched->burst[index]];
+            policy->onArrival(sched->state, index, time);
+            delivered = 1;
+        }
+
+        // The next known event that can hand the policy a process.
+        int event = pending->size > 0 ? proc[pending->slots[pending->head]].arrival_time : INT_MAX;
+        int io_done = deviceNextCompletion(&sched->io);
+        if (io_done < event) event = io_done;
+
+        int index;
+        if (sched->cut && !delivered) {
+            // Nothing arrived where the dispatch was cut: it goes on as if it never was.
+            index = sched->running;
+        } else {
+            if (sched->running != -1) {
+                policy->onTick(sched->state, sched->running, sched->ran, time);
+                if (proc[sched->running].is_completed) {
+                    // Retired: the slot is free for the next submission.
+                    sched->in_use[sched->running] = 0;
+                    sched->live--;
+                    if (sched->last_index == sched->running) sched->last_index = -1;
+                }
+                sched->running = -1;
+            }
+            index = policy->selectNext(sched->state, time);
+            if (index == -1) {
+                time = event < until ? event : until; // CPU idle: jump to the next event, or stop at the horizon.
+                continue;
+            }
+            result->decisions++;
+            int overhead = sched->params.dispatch_cost;
+            if (index != sched->last_index) {
+                result->context_switches++;
+                overhead += sched->params.switch_cost;
+            }
+            result->overhead += overhead;
+            time += overhead;
+            sched->last_index = index;
+            sched->ran = 0;
+            sched->slice_left = policy->sliceLength(sched->state, index, time);
+        }
+        sched->cut = 0;
+
+        // Run until the burst ends, the slice ends, or the next event if it may preempt.
+        // A preemptible slice also stops at the horizon, where an unseen arrival may preempt it.
+        int ran = proc[index].remaining_time;
+        if (sched->slice_left < ran) ran = sched->slice_left;
+        if (policy->preemptive) {
+            if (event - time < ran) ran = event - time;
+            if (until - time < ran) {
+                ran = until - time;
+                sched->cut = 1;
+            }
+            if (ran < 0) ran = 0; // Arrived during the dispatch overhead, or past the horizon.
+        }
+        if (ran > 0 && sched->first_run[index] == -1) sched->first_run[index] = time;
+        proc[index].remaining_time -= ran;
+        time += ran;
+        result->busy += ran;
+        sched->ran += ran;
+        sched->slice_left -= ran;
+
+        if (proc[index].remaining_time == 0) {
+            if (sched->burst[index] + 1 < proc[index].num_bursts) {
+                // An I/O burst follows: the process leaves the CPU for the device queue.
+                deviceSubmit(&sched->io, index, proc[index].bursts[++sched->burst[index]], time);
+            } else {
+                proc[index].completion_time = time;
+                proc[index].is_completed = 1;
+                status = recordCompletion(sched, index);
+            }
+        }
+        sched->running = index;
+    }
+    sched->time = time;
+    result->elapsed_ms += wallClockMs() - start;
+    return status;
+}
+
+const OnlineCompletion *onlineCompletions(OnlineScheduler *sched, int *count) {
+    *count = sched->num_done;
+    sched->num_done = 0;
+    return sched->done;
+}
+
+void onlineSummary(OnlineScheduler *sched, SimResult *result) {
+    *result = sched->result;
+    result->num_processes = sched->completed < INT_MAX ? (int)sched->completed : INT_MAX;
+    result->waiting = sketchSummary(&sched->sketch->waiting);
+    result->turnaround = sketchSummary(&sched->sketch->turnaround);
+    result->response = sketchSummary(&sched->sketch->response);
+    result->io_requests = sched->io.requests;
+    result->io_busy = sched->io.busy;
+    result->io_wait = sched->io.waited;
+    if (result->makespan > 0) result->throughput = (double)sched->completed / result->makespan;
+    // Live processes have run past the last completion: measure busy time up to the clock then.
+    int span = sched->live > 0 && sched->time > result->makespan ? sched->time : result->makespan;
+    if (span > 0) result->utilization = (double)result->busy / span;
+}
+
+void onlineFree(OnlineScheduler *sched) {
+    if (sched->state) sched->policy->destroy(sched->state);
+    fifoQueueFree(&sched->pending);
+    deviceQueueFree(&sched->io);
+    free(sched->slot);
+    free(sched->first_run);
+    free(sched->burst);
+    free(sched->in_use);
+    free(sched->sketch);
+    free(sched->done);
+    memset(sched, 0, sizeof(*sched));
+}
@@ -0,0 +1,133 @@
+//online.h
+
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include "simulate.h"
+#include "ready_queue.h"
+#include "device.h"
+
+
+/**
+ * @struct OnlineCompletion
+ * @brief A process that finished, as reported by onlineCompletions().
+ */
+typedef struct {
+  int process_id;       /**< Process identifier. */
+  int arrival_time;     /**< Time the process arrived. */
+  int first_run;        /**< Time it first ran. */
+  int completion_time;  /**< Time it completed. */
+  int burst_time;       /**< Total CPU time. */
+  int io_time;          /**< Total I/O time. */
+  int priority;         /**< Priority. */
+} OnlineCompletion;
+
+
+/**
+ * @struct OnlineScheduler
+ * @brief A policy run incrementally: processes are submitted as they arrive
+ * and time is advanced on request.
+ * Live processes occupy slots of a fixed-size Process array that the policy
+ * indexes as usual; a completed process is summarized into quantile sketches,
+ * reported once through onlineCompletions() and its slot reused, so memory
+ * depends on the number of processes alive at once, not on the length of the run.
+ * Slots are handed out round the array in submission order, so the policies'
+ * lowest-index tie-break stays first-come first-served, except between
+ * processes on either side of the point where the allocation wraps around.
+ */
+typedef struct {
+  const Policy *policy;         /**< Policy being run. */
+  PolicyParams params;          /**< Tunables passed to the policy. */
+  void *state;                  /**< Policy state. */
+  Process *slot;                /**< Live processes, indexed by slot. */
+  int *first_run;               /**< Time each slot's process first ran, or -1. */
+  int *burst;                   /**< Position of each slot's process in its burst list. */
+  unsigned char *in_use;        /**< 1 for each slot holding a live process. */
+  int live;                     /**< Slots in use. */
+  int cursor;                   /**< Slot after the one handed out last. */
+  int capacity;                 /**< Number of slots. */
+  FifoQueue pending;            /**< Submitted slots that have not arrived yet, in arrival order. */
+  int last_arrival;             /**< Arrival time of the latest submission. */
+  DeviceQueue io;               /**< Devices serving I/O bursts. */
+  int time;                     /**< Simulated clock. */
+  int horizon;                  /**< Time the run was last advanced to; later arrivals may still come. */
+  int running;                  /**< Slot that ran last and awaits onTick(), or -1. */
+  int ran;                      /**< Time it ran in its current dispatch. */
+  int slice_left;               /**< Rest of its slice in the current dispatch. */
+  int cut;                      /**< 1 if the dispatch was cut at the horizon and may continue. */
+  int last_index;               /**< Slot dispatched last (for context-switch accounting), -1 once retired. */
+  OnlineCompletion *done;       /**< Completions since the last onlineCompletions() call. */
+  int num_done;                 /**< Entries in done. */
+  int done_capacity;            /**< Allocated entries in done. */
+  long long submitted;          /**< Processes submitted so far. */
+  long long completed;          /**< Processes completed so far. */
+  RunSketches *sketch;          /**< Waiting, turnaround and response times of completed processes. */
+  SimResult result;             /**< Counters of the run so far (see onlineSummary()). */
+} OnlineScheduler;
+
+
+/**
+ * @brief Creates an online run of a policy with no processes.
+ * @param sched Scheduler to initialize.
+ * @param policy Policy to run.
+ * @param params Tunables passed to the policy (copied).
+ * @param capacity Most processes alive at once (submitted and not yet retired).
+ * @return 0 on success, -1 on invalid capacity or allocation failure (a message is printed).
+ */
+int onlineInit(OnlineScheduler *sched, const Policy *policy, const PolicyParams *params, int capacity);
+
+
+/**
+ * @brief Submits a process.
+ * - Arrival times must not decrease from one submission to the next, and must
+ *   not be earlier than the time the run was last advanced to.
+ * - The process is copied; its burst list (if any) must stay valid until it completes.
+ * - A process is retired at the first event after it completes, freeing its slot.
+ * @param sched Scheduler.
+ * @param p Process to submit (remaining_time is set from its first CPU burst).
+ * @return 0 on success, -1 if every slot is in use or the arrival is out of order.
+ */
+int onlineSubmit(OnlineScheduler *sched, const Process *p);
+
+
+/**
+ * @brief Runs the schedule up to a time.
+ * - Handles every event before `until`; the caller promises to submit no
+ *   process arriving before it afterwards. A slice that started earlier may
+ *   end later, and a non-preemptive one is then completed at once.
+ * - The schedule is the one simulate() produces for the same processes in
+ *   arrival order, as long as the slots have not wrapped around while
+ *   processes with equal keys were alive.
+ * @param sched Scheduler.
+ * @param until Time to advance to (INT_MAX to drain every submitted process).
+ * @return 0 on success, -1 if a completion could not be recorded.
+ */
+int onlineAdvance(OnlineScheduler *sched, int until);
+
+
+/**
+ * @brief Returns the processes that completed since the previous call.
+ * @param sched Scheduler.
+ * @param count Output: number of completions.
+ * @return The completions, valid until the next call to onlineAdvance().
+ */
+const OnlineCompletion *onlineCompletions(OnlineScheduler *sched, int *count);
+
+
+/**
+ * @brief Summarizes the processes completed so far.
+ * - makespan is the latest completion time and throughput is measured over
+ *   it; utilization is measured up to the clock while processes are live.
+ * @param sched Scheduler.
+ * @param result Output: summary in the form simulate() returns.
+ */
+void onlineSummary(OnlineScheduler *sched, SimResult *result);
+
+
+/**
+ * @brief Releases the scheduler.
+ * @param sched Scheduler.
+ */
+void onlineFree(OnlineScheduler *sched);
+
+#endif // ONLINE_H
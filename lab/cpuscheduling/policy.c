@@ -0,0 +1,322 @@
+#include <string.h>
+#include "policy.h"
+#include "ready_queue.h"
+#include "process_table.h"
+
+/**
+ * @struct QueueState
+ * @brief Ready set shared by the built-in policies: a FIFO or a keyed min-heap.
+ */
+typedef struct {
+  Process *proc;      /**< Process array being scheduled. */
+  FifoQueue fifo;     /**< Ready set of FCFS and RR. */
+  ReadyQueue heap;    /**< Ready set of SJF, SRTF and the priority policies. */
+  int quantum;        /**< RR time quantum. */
+} QueueState;
+
+/**
+ * @brief Creates a FIFO-ordered ready set.
+ */
+static int fifoInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    QueueState *s = (QueueState*)calloc(1, sizeof(QueueState));
+    if (!s || fifoQueueInit(&s->fifo, num_processes) != 0) {
+        free(s);
+        return -1;
+    }
+    s->proc = proc;
+    s->quantum = params->quantum;
+    *state = s;
+    return 0;
+}
+
+static void fifoArrival(void *state, int index, int time) {
+    (void)time;
+    fifoQueuePush(&((QueueState*)state)->fifo, index);
+}
+
+static int fifoSelect(void *state, int time) {
+    (void)time;
+    return fifoQueuePop(&((QueueState*)state)->fifo);
+}
+
+/**
+ * @brief Unfinished processes rejoin the tail, behind the arrivals of their slice.
+ */
+static void fifoTick(void *state, int index, int ran, int time) {
+    QueueState *s = (QueueState*)state;
+    (void)ran;
+    (void)time;
+    if (s->proc[index].remaining_time > 0) fifoQueuePush(&s->fifo, index);
+}
+
+static void fifoDestroy(void *state) {
+    QueueState *s = (QueueState*)state;
+    fifoQueueFree(&s->fifo);
+    free(s);
+}
+
+/**
+ * @brief Creates a min-heap ordered by the given key.
+ */
+static int heapInit(void **state, Process proc[], int num_processes, ReadyKey key) {
+    QueueState *s = (QueueState*)calloc(1, sizeof(QueueState));
+    if (!s || readyQueueInit(&s->heap, proc, num_processes, key) != 0) {
+        free(s);
+        return -1;
+    }
+    s->proc = proc;
+    *state = s;
+    return 0;
+}
+
+static int burstInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    (void)params;
+    return heapInit(state, proc, num_processes, KEY_BURST);
+}
+
+static int remainingInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    (void)params;
+    return heapInit(state, proc, num_processes, KEY_REMAINING);
+}
+
+static int priorityInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    (void)params;
+    return heapInit(state, proc, num_processes, KEY_PRIORITY);
+}
+
+static void heapArrival(void *state, int index, int time) {
+    (void)time;
+    readyQueuePush(&((QueueState*)state)->heap, index);
+}
+
+static int heapSelect(void *state, int time) {
+    (void)time;
+    return readyQueuePop(&((QueueState*)state)->heap);
+}
+
+/**
+ * @brief A preempted process competes with the new arrivals again.
+ */
+static void heapTick(void *state, int index, int ran, int time) {
+    QueueState *s = (QueueState*)state;
+    (void)ran;
+    (void)time;
+    if (s->proc[index].remaining_time > 0) readyQueuePush(&s->heap, index);
+}
+
+static void heapDestroy(void *state) {
+    QueueState *s = (QueueState*)state;
+    readyQueueFree(&s->heap);
+    free(s);
+}
+
+static int untilDone(void *state, int index, int time) {
+    (void)state;
+    (void)index;
+    (void)time;
+    return INT_MAX;
+}
+
+static int oneQuantum(void *state, int index, int time) {
+    (void)index;
+    (void)time;
+    return ((QueueState*)state)->quantum;
+}
+
+/**
+ * @struct ScanState
+ * @brief Ready set of the linear-scan policies: the entries of a ProcessTable with remaining_time > 0.
+ * The table's remaining_time column doubles as the membership mask: it is
+ * zero for processes that have not arrived, are running, or have finished.
+ */
+typedef struct {
+  Process *proc;         /**< Process array being scheduled. */
+  ProcessTable table;    /**< SoA copy scanned by the SIMD kernels. */
+  const int *key;        /**< Column to minimize. */
+  int first;             /**< No process below this index is queued. */
+  int end;               /**< No process at or above this index is queued. */
+} ScanState;
+
+/**
+ * @brief Creates an empty process table; key selects the column to minimize.
+ */
+static int scanInit(void **state, Process proc[], int num_processes, ReadyKey key) {
+    ScanState *s = (ScanState*)calloc(1, sizeof(ScanState));
+    if (!s || processTableInit(&s->table, proc, num_processes) != 0) {
+        free(s);
+        return -1;
+    }
+    memset(s->table.remaining_time, 0, s->table.padded * sizeof(int));
+    s->proc = proc;
+    s->key = (key == KEY_BURST) ? s->table.burst_time
+           : (key == KEY_REMAINING) ? s->table.remaining_time : s->table.priority;
+    s->first = num_processes;
+    *state = s;
+    return 0;
+}
+
+static int burstScanInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    (void)params;
+    return scanInit(state, proc, num_processes, KEY_BURST);
+}
+
+static int remainingScanInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    (void)params;
+    return scanInit(state, proc, num_processes, KEY_REMAINING);
+}
+
+static int priorityScanInit(void **state, Process proc[], int num_processes, const PolicyParams *params) {
+    (void)params;
+    return scanInit(state, proc, num_processes, KEY_PRIORITY);
+}
+
+/**
+ * @brief Marks a process queued and widens the scanned range to include it.
+ */
+static void scanEnqueue(ScanState *s, int index) {
+    s->table.remaining_time[index] = s->proc[index].remaining_time;
+    if (index < s->first) s->first = index;
+    if (index >= s->end) s->end = index + 1;
+}
+
+static void scanArrival(void *state, int index, int time) {
+    (void)time;
+    scanEnqueue((ScanState*)state, index);
+}
+
+/**
+ * @brief Scans [first, end) for the queued process with the smallest key and dequeues it.
+ * - Both ends shrink past entries that are no longer queued, so when processes
+ *   are stored in arrival order (as generated workloads are), the range stays
+ *   close to the set of ready processes.
+ */
+static int scanSelect(void *state, int time) {
+    ScanState *s = (ScanState*)state;
+    int index = processTableSelect(&s->table, s->key, time, s->first, s->end);
+    if (index == -1) return -1;
+
+    s->table.remaining_time[index] = 0;
+    while (s->first < s->end && s->table.remaining_time[s->first] == 0) s->first++;
+    while (s->end > s->first && s->table.remaining_time[s->end - 1] == 0) s->end--;
+    return index;
+}
+
+/**
+ * @brief Queues the process again with its new remaining time unless it finished.
+ */
+static void scanTick(void *state, int index, int ran, int time) {
+    ScanState *s = (ScanState*)state;
+    (void)ran;
+    (void)time;
+    if (s->proc[index].remaining_time > 0) scanEnqueue(s, index);
+}
+
+/**
+ * @brief Copies the new process's columns into the table.
+ */
+static void scanReset(void *state, int index) {
+    ScanState *s = (ScanState*)state;
+    s->table.arrival_time[index] = s->proc[index].arrival_time;
+    s->table.burst_time[index] = s->proc[index].burst_time;
+    s->table.priority[index] = s->proc[index].priority;
+}
+
+static void scanDestroy(void *state) {
+    ScanState *s = (ScanState*)state;
+    processTableFree(&s->table);
+    free(s);
+}
+
+static const Policy fcfsPolicy = {
+    "fcfs", "FCFS", 0,
+    fifoInit, fifoArrival, fifoSelect, untilDone, fifoTick, fifoDestroy, NULL
+};
+
+static const Policy sjfPolicy = {
+    "sjf", "SJF Non-Preemptive", 0,
+    burstInit, heapArrival, heapSelect, untilDone, heapTick, heapDestroy, NULL
+};
+
+static const Policy srtfPolicy = {
+    "srtf", "SJF Preemptive", 1,
+    remainingInit, heapArrival, heapSelect, untilDone, heapTick, heapDestroy, NULL
+};
+
+static const Policy priorityPolicy = {
+    "priority", "Priority Non-Preemptive", 0,
+    priorityInit, heapArrival, heapSelect, untilDone, heapTick, heapDestroy, NULL
+};
+
+static const Policy priorityPreemptivePolicy = {
+    "priority-p", "Priority Preemptive", 1,
+    priorityInit, heapArrival, heapSelect, untilDone, heapTick, heapDestroy, NULL
+};
+
+static const Policy rrPolicy = {
+    "rr", "Round Robin", 0,
+    fifoInit, fifoArrival, fifoSelect, oneQuantum, fifoTick, fifoDestroy, NULL
+};
+
+static const Policy sjfScanPolicy = {
+    "sjf-scan", "SJF Non-Preemptive (scan)", 0,
+    burstScanInit, scanArrival, scanSelect, untilDone, scanTick, scanDestroy, scanReset
+};
+
+static const Policy srtfScanPolicy = {
+    "srtf-scan", "SJF Preemptive (scan)", 1,
+    remainingScanInit, scanArrival, scanSelect, untilDone, scanTick, scanDestroy, scanReset
+};
+
+static const Policy priorityScanPolicy = {
+    "priority-scan", "Priority Non-Preemptive (scan)", 0,
+    priorityScanInit, scanArrival, scanSelect, untilDone, scanTick, scanDestroy, scanReset
+};
+
+static const Policy priorityPreemptiveScanPolicy = {
+    "priority-p-scan", "Priority Preemptive (scan)", 1,
+    priorityScanInit, scanArrival, scanSelect, untilDone, scanTick, scanDestroy, scanReset
+};
+
+const Policy *const policyList[] = {
+    &fcfsPolicy,
+    &sjfPolicy,
+    &srtfPolicy,
+    &priorityPolicy,
+    &priorityPreemptivePolicy,
+    &rrPolicy,
+    &mlfqPolicy,
+    &cfsPolicy,
+    NULL
+};
+
+const Policy *const scanPolicyList[] = {
+    &sjfScanPolicy,
+    &srtfScanPolicy,
+    &priorityScanPolicy,
+    &priorityPreemptiveScanPolicy,
+    NULL
+};
+
+PolicyParams defaultPolicyParams(int quantum) {
+    PolicyParams params = {
+        .quantum = quantum,
+        .mlfq_levels = 3,
+        .mlfq_boost = 100 * quantum,
+        .cfs_latency = 6 * quantum,
+        .cfs_min_granularity = quantum,
+        .switch_cost = 0,
+        .dispatch_cost = 0,
+        .io_devices = 1
+    };
+    return params;
+}
+
+const Policy *findPolicy(const char *name) {
+    for (int i = 0; policyList[i]; i++) {
+        if (strcmp(policyList[i]->name, name) == 0) return policyList[i];
+    }
+    for (int i = 0; scanPolicyList[i]; i++) {
+        if (strcmp(scanPolicyList[i]->name, name) == 0) return scanPolicyList[i];
+    }
+    return NULL;
+}
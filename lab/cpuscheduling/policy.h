@@ -0,0 +1,140 @@
+//policy.h
+
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "process.h"
+
+
+/**
+ * @struct PolicyParams
+ * @brief Tunables of a simulation run: the policy's, then the simulated machine's.
+ */
+typedef struct {
+  int quantum;              /**< Time quantum of RR; MLFQ level i uses quantum << i. */
+  int mlfq_levels;          /**< Number of MLFQ queues (1 .. 30). */
+  int mlfq_boost;           /**< Interval between MLFQ priority boosts (0 disables them). */
+  int cfs_latency;          /**< CFS target latency: period in which every runnable process runs once. */
+  int cfs_min_granularity;  /**< Shortest CFS slice. */
+  int switch_cost;          /**< CPU time lost switching to a different process (charged by the simulator). */
+  int dispatch_cost;        /**< CPU time lost on every dispatch, including re-dispatching the same process. */
+  int io_devices;           /**< Identical I/O devices serving the device queue (at least 1). */
+} PolicyParams;
+
+
+/**
+ * @struct Policy
+ * @brief A scheduling algorithm as a set of callbacks driven by simulate().
+ * The simulator owns time, arrivals and execution; the policy only owns its
+ * ready set. A process is either running (outside the ready set) or queued.
+ *
+ * At every event (arrival, completion or end of a slice) the simulator:
+ * - calls onArrival() for each process that has arrived by now, in arrival order;
+ * - calls onTick() for the process that just ran, after those arrivals, so a
+ *   policy that re-queues it puts it behind them;
+ * - calls selectNext() to take the next process out of the ready set.
+ */
+typedef struct {
+  const char *name;    /**< Short name used on the command line (e.g. "srtf"). */
+  const char *title;   /**< Label for tables and Gantt charts. */
+  int preemptive;      /**< 1 if every arrival ends the running slice so the choice is re-evaluated. */
+
+  /**
+   * @brief Creates the policy's ready set.
+   * @param state Output: policy state passed to the other callbacks.
+   * @param proc Process array the simulation runs on.
+   * @param num_processes Number of processes.
+   * @param params Tunables (each policy reads the ones it uses).
+   * @return 0 on success, -1 on allocation failure.
+   */
+  int (*init)(void **state, Process proc[], int num_processes, const PolicyParams *params);
+
+  /**
+   * @brief A process arrived and is ready to run.
+   */
+  void (*onArrival)(void *state, int index, int time);
+
+  /**
+   * @brief Removes the next process to run from the ready set.
+   * @return Index of the process, or -1 if nothing is ready.
+   */
+  int (*selectNext)(void *state, int time);
+
+  /**
+   * @brief Longest slice the selected process may run before the policy is asked again.
+   * @return Slice length, or INT_MAX to run until completion (or the next arrival if preemptive).
+   */
+  int (*sliceLength)(void *state, int index, int time);
+
+  /**
+   * @brief The process ran for `ran` time units ending at `time`.
+   * - Called after every slice; if the CPU burst is not finished
+   *   (remaining_time > 0) the policy must put it back in its ready set.
+   * - A process that finished a CPU burst followed by I/O comes back through
+   *   onArrival() with remaining_time set to its next CPU burst.
+   */
+  void (*onTick)(void *state, int index, int ran, int time);
+
+  /**
+   * @brief Releases the policy state.
+   */
+  void (*destroy)(void *state);
+
+  /**
+   * @brief A new process takes over a slot of the process array.
+   * - Online runs (see online.h) reuse the slots of retired processes; the
+   *   policy forgets any state it kept for the old one. Called before the
+   *   new process's onArrival(). NULL if the policy keeps no such state.
+   */
+  void (*reset)(void *state, int index);
+} Policy;
+
+
+/**
+ * @brief Returns the default tunables for a quantum.
+ * - 3 MLFQ levels boosted every 100 quanta; CFS latency of 6 quanta with a
+ *   minimum granularity of one quantum; free context switches and dispatches;
+ *   one I/O device.
+ * @param quantum Base time quantum.
+ * @return The parameters.
+ */
+PolicyParams defaultPolicyParams(int quantum);
+
+
+/**
+ * @brief Multi-level feedback queue (mlfq.c).
+ */
+extern const Policy mlfqPolicy;
+
+
+/**
+ * @brief CFS-style fair scheduler over a vruntime red-black tree (cfs.c).
+ */
+extern const Policy cfsPolicy;
+
+
+/**
+ * @brief Built-in policies, terminated by NULL.
+ * - fcfs, sjf, srtf, priority, priority-p, rr, mlfq, cfs
+ */
+extern const Policy *const policyList[];
+
+
+/**
+ * @brief Linear-scan variants of the heap policies, terminated by NULL.
+ * - sjf-scan, srtf-scan, priority-scan, priority-p-scan
+ * - Each decision scans a structure-of-arrays ProcessTable with a SIMD kernel
+ *   (see process_table.h): O(n) per decision but no queue upkeep, which wins
+ *   for small n with frequent decisions. Not run by default; select by name.
+ */
+extern const Policy *const scanPolicyList[];
+
+
+/**
+ * @brief Looks up a built-in policy by name.
+ * @param name Policy name (see policyList and scanPolicyList).
+ * @return The policy, or NULL if there is none with that name.
+ */
+const Policy *findPolicy(const char *name);
+
+#endif // POLICY_H
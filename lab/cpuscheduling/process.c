@@ -9,6 +9,9 @@ void initializeProcess(Process *p) {
     p->is_completed = 0;
     p->priority = 0;
     p->time_quantum = 0;
+    p->num_bursts = 0;
+    p->io_time = 0;
+    p->bursts = NULL;
 }
 
 int calculateTurnarroundTime(Process *p) {
@@ -16,7 +19,7 @@ int calculateTurnarroundTime(Process *p) {
 }
 
 int calculateWaitingTime(Process *p) {
-    return calculateTurnarroundTime(p) - p->burst_time;
+    return calculateTurnarroundTime(p) - p->burst_time - p->io_time;
 }
 
 void printProcesses(Process proc[], int num_processes) {
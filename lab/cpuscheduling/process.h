@@ -17,11 +17,14 @@ typedef struct {
   int process_id;      /**< Unique identifier for the process. */
   int arrival_time;    /**< Time at which the process arrives. */
   int burst_time;      /**< Total CPU time required. */
-  int remaining_time;  /**< Remaining CPU time (used in preemptive scheduling). */
+  int remaining_time;  /**< Remaining CPU time of the current CPU burst (used in preemptive scheduling). */
   int completion_time; /**< Time at which the process completes execution. */
   int is_completed;    /**< Flag to indicate if the process has completed. */
   int priority;        /**< Original priority (lower number means higher priority). */
   int time_quantum;    /**< Time quantum for Round Robin scheduling (if needed). */
+  int num_bursts;      /**< Entries in bursts (odd), or 0 for a single CPU burst of burst_time. */
+  int io_time;         /**< Total I/O time (sum of the I/O bursts). */
+  const int *bursts;   /**< Alternating CPU and I/O burst lengths, CPU first and last (shared, read-only), or NULL. */
 } Process;
 
 
@@ -42,6 +45,7 @@ int calculateTurnarroundTime(Process *p);
 
 /**
  * @brief Calculates the waiting time of a process.
+ * - Time spent neither running nor doing I/O: turnaround minus CPU and I/O time.
  * @param p Pointer to the Process.
  * @return Waiting time.
  */
@@ -0,0 +1,174 @@
+#include <string.h>
+#include "process_table.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_KERNELS 1
+#endif
+
+/**
+ * @brief Allocates one zeroed, aligned column.
+ * aligned_alloc() needs a size that is a multiple of the alignment, which
+ * padded entries alone (a multiple of TABLE_LANES) need not be.
+ */
+static int *allocColumn(int padded) {
+    size_t size = (padded * sizeof(int) + TABLE_ALIGN - 1) / TABLE_ALIGN * TABLE_ALIGN;
+    int *column = (int*)aligned_alloc(TABLE_ALIGN, size);
+    if (column) memset(column, 0, size);
+    return column;
+}
+
+/**
+ * @brief Portable kernel: one pass keeping the first minimum.
+ */
+static int selectScalar(const int *key, const int *arrival, const int *remaining, int n, int time) {
+    int best = -1;
+    for (int i = 0; i < n; i++) {
+        if (arrival[i] <= time && remaining[i] > 0 && (best == -1 || key[i] < key[best])) best = i;
+    }
+    return best;
+}
+
+#ifdef HAVE_X86_KERNELS
+
+/**
+ * @brief Combines per-lane winners: smallest key, then lowest index.
+ * Each lane already holds the first minimum of the entries it saw.
+ */
+static int reduceLanes(const int *keys, const int *indices, int lanes) {
+    int best = -1;
+    for (int l = 0; l < lanes; l++) {
+        if (indices[l] == -1) continue;
+        if (best == -1 || keys[l] < keys[best] || (keys[l] == keys[best] && indices[l] < indices[best])) best = l;
+    }
+    return (best == -1) ? -1 : indices[best];
+}
+
+/**
+ * @brief SSE2 kernel: four lanes, each keeping its own running minimum and index.
+ */
+static int selectSse2(const int *key, const int *arrival, const int *remaining, int n, int time) {
+    const __m128i now = _mm_set1_epi32(time), zero = _mm_setzero_si128(), none = _mm_set1_epi32(-1);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i best_key = _mm_set1_epi32(INT_MAX), best_index = none;
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    int keys[4], indices[4];
+
+    for (int i = 0; i < n; i += 4) {
+        __m128i k = _mm_load_si128((const __m128i*)(key + i));
+        __m128i a = _mm_load_si128((const __m128i*)(arrival + i));
+        __m128i r = _mm_load_si128((const __m128i*)(remaining + i));
+
+        // take = arrived && unfinished && (lane empty || strictly smaller key)
+        __m128i eligible = _mm_andnot_si128(_mm_cmpgt_epi32(a, now), _mm_cmpgt_epi32(r, zero));
+        __m128i better = _mm_or_si128(_mm_cmplt_epi32(k, best_key), _mm_cmpeq_epi32(best_index, none));
+        __m128i take = _mm_and_si128(eligible, better);
+
+        best_key = _mm_or_si128(_mm_and_si128(take, k), _mm_andnot_si128(take, best_key));
+        best_index = _mm_or_si128(_mm_and_si128(take, index), _mm_andnot_si128(take, best_index));
+        index = _mm_add_epi32(index, step);
+    }
+    _mm_storeu_si128((__m128i*)keys, best_key);
+    _mm_storeu_si128((__m128i*)indices, best_index);
+    return reduceLanes(keys, indices, 4);
+}
+
+/**
+ * @brief AVX2 kernel: the SSE2 kernel widened to eight lanes.
+ */
+__attribute__((target("avx2")))
+static int selectAvx2(const int *key, const int *arrival, const int *remaining, int n, int time) {
+    const __m256i now = _mm256_set1_epi32(time), zero = _mm256_setzero_si256(), none = _mm256_set1_epi32(-1);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i best_key = _mm256_set1_epi32(INT_MAX), best_index = none;
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    int keys[8], indices[8];
+
+    for (int i = 0; i < n; i += 8) {
+        __m256i k = _mm256_load_si256((const __m256i*)(key + i));
+        __m256i a = _mm256_load_si256((const __m256i*)(arrival + i));
+        __m256i r = _mm256_load_si256((const __m256i*)(remaining + i));
+
+        __m256i eligible = _mm256_andnot_si256(_mm256_cmpgt_epi32(a, now), _mm256_cmpgt_epi32(r, zero));
+        __m256i better = _mm256_or_si256(_mm256_cmpgt_epi32(best_key, k), _mm256_cmpeq_epi32(best_index, none));
+        __m256i take = _mm256_and_si256(eligible, better);
+
+        best_key = _mm256_blendv_epi8(best_key, k, take);
+        best_index = _mm256_blendv_epi8(best_index, index, take);
+        index = _mm256_add_epi32(index, step);
+    }
+    _mm256_storeu_si256((__m256i*)keys, best_key);
+    _mm256_storeu_si256((__m256i*)indices, best_index);
+    return reduceLanes(keys, indices, 8);
+}
+
+#endif // HAVE_X86_KERNELS
+
+/**
+ * @brief Picks the widest kernel the running CPU supports, unless SCHED_KERNEL asks otherwise.
+ */
+static void chooseKernel(ProcessTable *table) {
+    const char *want = getenv("SCHED_KERNEL");
+
+    table->select = selectScalar;
+    table->kernel = "scalar";
+    if (want && strcmp(want, "scalar") == 0) return;
+
+#ifdef HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    int avx2 = __builtin_cpu_supports("avx2");
+    if (avx2 && !(want && strcmp(want, "sse2") == 0)) {
+        table->select = selectAvx2;
+        table->kernel = "avx2";
+    } else {
+        table->select = selectSse2;  // SSE2 is part of every x86-64 CPU.
+        table->kernel = "sse2";
+    }
+#endif
+}
+
+int processTableInit(ProcessTable *table, Process proc[], int num_processes) {
+    int padded = (num_processes + TABLE_LANES - 1) / TABLE_LANES * TABLE_LANES;
+    if (padded == 0) padded = TABLE_LANES;
+
+    memset(table, 0, sizeof(*table));
+    table->arrival_time = allocColumn(padded);
+    table->burst_time = allocColumn(padded);
+    table->remaining_time = allocColumn(padded);
+    table->priority = allocColumn(padded);
+    if (!table->arrival_time || !table->burst_time || !table->remaining_time || !table->priority) {
+        processTableFree(table);
+        return -1;
+    }
+
+    for (int i = 0; i < num_processes; i++) {
+        table->arrival_time[i] = proc[i].arrival_time;
+        table->burst_time[i] = proc[i].burst_time;
+        table->remaining_time[i] = proc[i].remaining_time;
+        table->priority[i] = proc[i].priority;
+    }
+    table->count = num_processes;
+    table->padded = padded;
+    chooseKernel(table);
+    return 0;
+}
+
+int processTableSelect(const ProcessTable *table, const int *key, int time, int first, int end) {
+    // Whole vectors only: round first down and end up to TABLE_LANES, which keeps the alignment.
+    int base = first - first % TABLE_LANES;
+    int limit = (end + TABLE_LANES - 1) / TABLE_LANES * TABLE_LANES;
+    if (limit > table->padded) limit = table->padded;
+    if (base >= limit) return -1;
+
+    int index = table->select(key + base, table->arrival_time + base, table->remaining_time + base,
+                              limit - base, time);
+    return (index == -1) ? -1 : base + index;
+}
+
+void processTableFree(ProcessTable *table) {
+    free(table->arrival_time);
+    free(table->burst_time);
+    free(table->remaining_time);
+    free(table->priority);
+    memset(table, 0, sizeof(*table));
+}
@@ -0,0 +1,73 @@
+//process_table.h
+
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include "process.h"
+
+#define TABLE_ALIGN 64  /**< Column alignment in bytes (one cache line). */
+#define TABLE_LANES 8   /**< Columns are padded to a multiple of this many entries (one AVX2 vector). */
+
+
+/**
+ * @brief Signature of a selection kernel.
+ * Returns the index of the smallest key[i] among the eligible entries
+ * (arrival[i] <= time and remaining[i] > 0), or -1 if none is eligible.
+ * Equal keys resolve to the lowest index, like a scan that keeps the first minimum.
+ * n must be a multiple of TABLE_LANES and the columns TABLE_ALIGN-aligned.
+ */
+typedef int (*SelectKernel)(const int *key, const int *arrival, const int *remaining, int n, int time);
+
+
+/**
+ * @struct ProcessTable
+ * @brief Structure-of-arrays copy of the fields a selection scan reads.
+ * A scan over Process[] pulls all eight fields of every process through the
+ * cache; the table keeps each field in its own aligned column instead.
+ * Entries with remaining_time 0 (including the padding) are never eligible.
+ */
+typedef struct {
+  int *arrival_time;    /**< Arrival time column. */
+  int *burst_time;      /**< Burst time column. */
+  int *remaining_time;  /**< Remaining time column (kept in sync by the caller). */
+  int *priority;        /**< Priority column. */
+  int count;            /**< Number of processes. */
+  int padded;           /**< count rounded up to a multiple of TABLE_LANES. */
+  SelectKernel select;  /**< Kernel chosen for this CPU. */
+  const char *kernel;   /**< Name of the chosen kernel ("avx2", "sse2" or "scalar"). */
+} ProcessTable;
+
+
+/**
+ * @brief Builds a table from a process array and picks the fastest kernel the CPU supports.
+ * - The environment variable SCHED_KERNEL=avx2|sse2|scalar overrides the choice
+ *   (an unsupported request falls back to the automatic choice).
+ * @param table Table to initialize.
+ * @param proc Array of processes.
+ * @param num_processes Number of processes.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int processTableInit(ProcessTable *table, Process proc[], int num_processes);
+
+
+/**
+ * @brief Selects the eligible process with the smallest key.
+ * - Only entries in [first, end) are scanned (widened to whole vectors); the
+ *   caller guarantees every eligible process lies in that range.
+ * @param table Process table.
+ * @param key Column to minimize (burst_time, remaining_time or priority of the table).
+ * @param time Current time; processes that arrive later are not eligible.
+ * @param first Lowest index that may be eligible.
+ * @param end One past the highest index that may be eligible.
+ * @return Index of the selected process, or -1 if none is eligible.
+ */
+int processTableSelect(const ProcessTable *table, const int *key, int time, int first, int end);
+
+
+/**
+ * @brief Releases the table's columns.
+ * @param table Process table.
+ */
+void processTableFree(ProcessTable *table);
+
+#endif // PROCESS_TABLE_H
@@ -0,0 +1,227 @@
+#include <stdlib.h>
+#include "rbtree.h"
+
+/**
+ * @brief Returns 1 if node a sorts before node b.
+ */
+static int before(const RbTree *t, int a, int b) {
+    return t->key[a] < t->key[b] || (t->key[a] == t->key[b] && a < b);
+}
+
+static int isRed(const RbTree *t, int node) {
+    return node != -1 && t->red[node];
+}
+
+static int leftmost(const RbTree *t, int node) {
+    while (t->left[node] != -1) node = t->left[node];
+    return node;
+}
+
+/**
+ * @brief Puts node v in place of node u under u's parent.
+ */
+static void replaceChild(RbTree *t, int u, int v) {
+    int p = t->parent[u];
+    if (p == -1) t->root = v;
+    else if (t->left[p] == u) t->left[p] = v;
+    else t->right[p] = v;
+    if (v != -1) t->parent[v] = p;
+}
+
+static void rotateLeft(RbTree *t, int x) {
+    int y = t->right[x];
+    t->right[x] = t->left[y];
+    if (t->left[y] != -1) t->parent[t->left[y]] = x;
+    replaceChild(t, x, y);
+    t->left[y] = x;
+    t->parent[x] = y;
+}
+
+static void rotateRight(RbTree *t, int x) {
+    int y = t->left[x];
+    t->left[x] = t->right[y];
+    if (t->right[y] != -1) t->parent[t->right[y]] = x;
+    replaceChild(t, x, y);
+    t->right[y] = x;
+    t->parent[x] = y;
+}
+
+int rbTreeInit(RbTree *tree, int capacity, const long long *key) {
+    size_t n = capacity > 0 ? capacity : 1;
+    tree->left = (int*)malloc(n * sizeof(int));
+    tree->right = (int*)malloc(n * sizeof(int));
+    tree->parent = (int*)malloc(n * sizeof(int));
+    tree->red = (unsigned char*)malloc(n);
+    tree->root = -1;
+    tree->first = -1;
+    tree->size = 0;
+    tree->key = key;
+    if (!tree->left || !tree->right || !tree->parent || !tree->red) {
+        rbTreeFree(tree);
+        return -1;
+    }
+    return 0;
+}
+
+void rbTreeInsert(RbTree *tree, int index) {
+    int parent = -1, node = tree->root, is_first = 1;
+
+    while (node != -1) {
+        parent = node;
+        if (before(tree, index, node)) {
+            node = tree->left[node];
+        } else {
+            node = tree->right[node];
+            is_first = 0;
+        }
+    }
+    tree->left[index] = tree->right[index] = -1;
+    tree->parent[index] = parent;
+    tree->red[index] = 1;
+    if (parent == -1) tree->root = index;
+    else if (before(tree, index, parent)) tree->left[parent] = index;
+    else tree->right[parent] = index;
+    if (is_first) tree->first = index;
+    tree->size++;
+
+    // Restore the red-black properties: no red node has a red parent.
+    node = index;
+    while (isRed(tree, tree->parent[node])) {
+        int p = tree->parent[node], g = tree->parent[p];
+        if (p == tree->left[g]) {
+            int uncle = tree->right[g];
+            if (isRed(tree, uncle)) {
+                tree->red[p] = tree->red[uncle] = 0;
+                tree->red[g] = 1;
+                node = g;
+                continue;
+            }
+            if (node == tree->right[p]) {
+                rotateLeft(tree, p);
+                node = p;
+                p = tree->parent[node];
+            }
+            tree->red[p] = 0;
+            tree->red[g] = 1;
+            rotateRight(tree, g);
+        } else {
+            int uncle = tree->left[g];
+            if (isRed(tree, uncle)) {
+                tree->red[p] = tree->red[uncle] = 0;
+                tree->red[g] = 1;
+                node = g;
+                continue;
+            }
+            if (node == tree->left[p]) {
+                rotateRight(tree, p);
+                node = p;
+                p = tree->parent[node];
+            }
+            tree->red[p] = 0;
+            tree->red[g] = 1;
+            rotateLeft(tree, g);
+        }
+    }
+    tree->red[tree->root] = 0;
+}
+
+void rbTreeErase(RbTree *tree, int index) {
+    int removed_red = tree->red[index];
+    int child, parent;
+
+    if (tree->first == index) {
+        // The leftmost node has no left child: its successor is the right subtree or the parent.
+        tree->first = tree->right[index] != -1 ? leftmost(tree, tree->right[index]) : tree->parent[index];
+    }
+
+    if (tree->left[index] == -1 || tree->right[index] == -1) {
+        child = tree->left[index] != -1 ? tree->left[index] : tree->right[index];
+        parent = tree->parent[index];
+        replaceChild(tree, index, child);
+    } else {
+        // Two children: the successor takes the node's place and colour.
+        int next = leftmost(tree, tree->right[index]);
+        removed_red = tree->red[next];
+        child = tree->right[next];
+        if (tree->parent[next] == index) {
+            parent = next;
+        } else {
+            parent = tree->parent[next];
+            replaceChild(tree, next, child);
+            tree->right[next] = tree->right[index];
+            tree->parent[tree->right[next]] = next;
+        }
+        replaceChild(tree, index, next);
+        tree->left[next] = tree->left[index];
+        tree->parent[tree->left[next]] = next;
+        tree->red[next] = tree->red[index];
+    }
+    tree->size--;
+    if (removed_red) return;
+
+    // A black node left its path: push the missing black up until it can be absorbed.
+    while (child != tree->root && !isRed(tree, child)) {
+        if (child == tree->left[parent]) {
+            int sibling = tree->right[parent];
+            if (isRed(tree, sibling)) {
+                tree->red[sibling] = 0;
+                tree->red[parent] = 1;
+                rotateLeft(tree, parent);
+                sibling = tree->right[parent];
+            }
+            if (!isRed(tree, tree->left[sibling]) && !isRed(tree, tree->right[sibling])) {
+                tree->red[sibling] = 1;
+                child = parent;
+                parent = tree->parent[child];
+                continue;
+            }
+            if (!isRed(tree, tree->right[sibling])) {
+                tree->red[tree->left[sibling]] = 0;
+                tree->red[sibling] = 1;
+                rotateRight(tree, sibling);
+                sibling = tree->right[parent];
+            }
+            tree->red[sibling] = tree->red[parent];
+            tree->red[parent] = 0;
+            tree->red[tree->right[sibling]] = 0;
+            rotateLeft(tree, parent);
+        } else {
+            int sibling = tree->left[parent];
+            if (isRed(tree, sibling)) {
+                tree->red[sibling] = 0;
+                tree->red[parent] = 1;
+                rotateRight(tree, parent);
+                sibling = tree->left[parent];
+            }
+            if (!isRed(tree, tree->left[sibling]) && !isRed(tree, tree->right[sibling])) {
+                tree->red[sibling] = 1;
+                child = parent;
+                parent = tree->parent[child];
+                continue;
+            }
+            if (!isRed(tree, tree->left[sibling])) {
+                tree->red[tree->right[sibling]] = 0;
+                tree->red[sibling] = 1;
+                rotateLeft(tree, sibling);
+                sibling = tree->left[parent];
+            }
+            tree->red[sibling] = tree->red[parent];
+            tree->red[parent] = 0;
+            tree->red[tree->left[sibling]] = 0;
+            rotateRight(tree, parent);
+        }
+        child = tree->root;
+    }
+    if (child != -1) tree->red[child] = 0;
+}
+
+void rbTreeFree(RbTree *tree) {
+    free(tree->left);
+    free(tree->right);
+    free(tree->parent);
+    free(tree->red);
+    tree->left = tree->right = tree->parent = NULL;
+    tree->red = NULL;
+    tree->root = tree->first = -1;
+    tree->size = 0;
+}
@@ -0,0 +1,59 @@
+//rbtree.h
+
+#ifndef RBTREE_H
+#define RBTREE_H
+
+
+/**
+ * @struct RbTree
+ * @brief Red-black tree of process indices ordered by a 64-bit key.
+ * Nodes live in arrays indexed by process index, so inserting and erasing
+ * never allocate. Equal keys are ordered by index. The leftmost node is
+ * cached, so the smallest entry is found in O(1).
+ * A process's key must not change while it is in the tree.
+ */
+typedef struct {
+  int *left;              /**< Left child of each node, or -1. */
+  int *right;             /**< Right child of each node, or -1. */
+  int *parent;            /**< Parent of each node, or -1 for the root. */
+  unsigned char *red;     /**< 1 if the node is red. */
+  int root;               /**< Root node, or -1 if the tree is empty. */
+  int first;              /**< Leftmost (smallest) node, or -1 if the tree is empty. */
+  int size;               /**< Number of nodes in the tree. */
+  const long long *key;   /**< Ordering key of each index. */
+} RbTree;
+
+
+/**
+ * @brief Creates an empty tree.
+ * @param tree Tree to initialize.
+ * @param capacity Number of indices (0 .. capacity - 1) that may be inserted.
+ * @param key Ordering key of each index (owned by the caller).
+ * @return 0 on success, -1 on allocation failure.
+ */
+int rbTreeInit(RbTree *tree, int capacity, const long long *key);
+
+
+/**
+ * @brief Inserts an index in O(log n).
+ * @param tree Red-black tree.
+ * @param index Index that is not in the tree.
+ */
+void rbTreeInsert(RbTree *tree, int index);
+
+
+/**
+ * @brief Removes an index in O(log n).
+ * @param tree Red-black tree.
+ * @param index Index that is in the tree.
+ */
+void rbTreeErase(RbTree *tree, int index);
+
+
+/**
+ * @brief Releases the tree's memory.
+ * @param tree Red-black tree.
+ */
+void rbTreeFree(RbTree *tree);
+
+#endif // RBTREE_H
@@ -0,0 +1,143 @@
+#include <string.h>
+#include "ready_queue.h"
+
+/**
+ * @brief Returns the ordering key of a process.
+ */
+static int keyOf(const ReadyQueue *rq, int index) {
+    const Process *p = &rq->proc[index];
+    switch (rq->key) {
+        case KEY_BURST:     return p->burst_time;
+        case KEY_REMAINING: return p->remaining_time;
+        default:            return p->priority;
+    }
+}
+
+/**
+ * @brief Returns 1 if process a must leave the queue before process b.
+ */
+static int before(const ReadyQueue *rq, int a, int b) {
+    int ka = keyOf(rq, a), kb = keyOf(rq, b);
+    return ka < kb || (ka == kb && a < b);
+}
+
+int readyQueueInit(ReadyQueue *rq, Process proc[], int capacity, ReadyKey key) {
+    rq->heap = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    rq->size = 0;
+    rq->capacity = capacity;
+    rq->proc = proc;
+    rq->key = key;
+    return rq->heap ? 0 : -1;
+}
+
+void readyQueuePush(ReadyQueue *rq, int index) {
+    int pos = rq->size++;
+
+    // Sift up: move parents down until the new entry's slot is found.
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!before(rq, index, rq->heap[parent])) break;
+        rq->heap[pos] = rq->heap[parent];
+        pos = parent;
+    }
+    rq->heap[pos] = index;
+}
+
+int readyQueuePop(ReadyQueue *rq) {
+    if (rq->size == 0) return -1;
+
+    int top = rq->heap[0];
+    int last = rq->heap[--rq->size];
+    int pos = 0;
+
+    // Sift down: move the smaller child up until the last entry fits.
+    while (1) {
+        int child = 2 * pos + 1;
+        if (child >= rq->size) break;
+        if (child + 1 < rq->size && before(rq, rq->heap[child + 1], rq->heap[child])) child++;
+        if (!before(rq, rq->heap[child], last)) break;
+        rq->heap[pos] = rq->heap[child];
+        pos = child;
+    }
+    if (rq->size > 0) rq->heap[pos] = last;
+    return top;
+}
+
+int readyQueuePeek(const ReadyQueue *rq) {
+    return (rq->size > 0) ? rq->heap[0] : -1;
+}
+
+void readyQueueFree(ReadyQueue *rq) {
+    free(rq->heap);
+    rq->heap = NULL;
+    rq->size = rq->capacity = 0;
+}
+
+int *sortByArrival(Process proc[], int num_processes) {
+    int *order = (int*)malloc((num_processes > 0 ? num_processes : 1) * sizeof(int));
+    int *scratch = (int*)malloc((num_processes > 0 ? num_processes : 1) * sizeof(int));
+    if (!order || !scratch) {
+        free(order);
+        free(scratch);
+        return NULL;
+    }
+
+    for (int i = 0; i < num_processes; i++) order[i] = i;
+
+    // Bottom-up merge sort: stable, so equal arrivals stay in array order.
+    for (int width = 1; width < num_processes; width *= 2) {
+        for (int lo = 0; lo < num_processes; lo += 2 * width) {
+            int mid = (lo + width < num_processes) ? lo + width : num_processes;
+            int hi = (lo + 2 * width < num_processes) ? lo + 2 * width : num_processes;
+            int a = lo, b = mid, k = lo;
+            while (a < mid && b < hi) {
+                scratch[k++] = (proc[order[b]].arrival_time < proc[order[a]].arrival_time) ? order[b++] : order[a++];
+            }
+            while (a < mid) scratch[k++] = order[a++];
+            while (b < hi) scratch[k++] = order[b++];
+        }
+        memcpy(order, scratch, num_processes * sizeof(int));
+    }
+
+    free(scratch);
+    return order;
+}
+
+int admitArrivals(ReadyQueue *rq, const int order[], int num_processes, int next, int time) {
+    while (next < num_processes && rq->proc[order[next]].arrival_time <= time) {
+        readyQueuePush(rq, order[next++]);
+    }
+    return next;
+}
+
+int nextArrival(Process proc[], const int order[], int num_processes, int next) {
+    return (next < num_processes) ? proc[order[next]].arrival_time : INT_MAX;
+}
+
+int fifoQueueInit(FifoQueue *fq, int capacity) {
+    fq->slots = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    fq->head = fq->size = 0;
+    fq->capacity = capacity > 0 ? capacity : 1;
+    return fq->slots ? 0 : -1;
+}
+
+void fifoQueuePush(FifoQueue *fq, int index) {
+    int tail = fq->head + fq->size++;
+    if (tail >= fq->capacity) tail -= fq->capacity;
+    fq->slots[tail] = index;
+}
+
+int fifoQueuePop(FifoQueue *fq) {
+    if (fq->size == 0) return -1;
+
+    int index = fq->slots[fq->head];
+    if (++fq->head == fq->capacity) fq->head = 0;
+    fq->size--;
+    return index;
+}
+
+void fifoQueueFree(FifoQueue *fq) {
+    free(fq->slots);
+    fq->slots = NULL;
+    fq->head = fq->size = fq->capacity = 0;
+}
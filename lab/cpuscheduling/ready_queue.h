@@ -0,0 +1,157 @@
+//ready_queue.h
+
+#ifndef READY_QUEUE_H
+#define READY_QUEUE_H
+
+#include "process.h"
+
+
+/**
+ * @enum ReadyKey
+ * @brief Field a ReadyQueue orders processes by (smallest first).
+ */
+typedef enum {
+  KEY_BURST,      /**< burst_time (non-preemptive SJF). */
+  KEY_REMAINING,  /**< remaining_time (SRTF). */
+  KEY_PRIORITY    /**< priority (lower number means higher priority). */
+} ReadyKey;
+
+
+/**
+ * @struct ReadyQueue
+ * @brief Binary min-heap of process indices.
+ * Equal keys are ordered by index, so the queue picks the same process as a
+ * linear scan that keeps the first minimum it sees.
+ * A process's key must not change while it is in the queue; preemptive
+ * schedulers pop the running process and push it back when it is preempted.
+ */
+typedef struct {
+  int *heap;        /**< Process indices in heap order. */
+  int size;         /**< Number of queued processes. */
+  int capacity;     /**< Allocated entries in heap. */
+  Process *proc;    /**< Process array the indices refer to. */
+  ReadyKey key;     /**< Ordering field. */
+} ReadyQueue;
+
+
+/**
+ * @brief Creates an empty ready queue.
+ * @param rq Queue to initialize.
+ * @param proc Process array the queue will index into.
+ * @param capacity Maximum number of processes queued at once.
+ * @param key Field to order by.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int readyQueueInit(ReadyQueue *rq, Process proc[], int capacity, ReadyKey key);
+
+
+/**
+ * @brief Adds a process to the queue in O(log n).
+ * @param rq Ready queue.
+ * @param index Index of the process in the process array.
+ */
+void readyQueuePush(ReadyQueue *rq, int index);
+
+
+/**
+ * @brief Removes the process with the smallest key in O(log n).
+ * @param rq Ready queue.
+ * @return Index of the removed process, or -1 if the queue is empty.
+ */
+int readyQueuePop(ReadyQueue *rq);
+
+
+/**
+ * @brief Returns the process with the smallest key without removing it.
+ * @param rq Ready queue.
+ * @return Index of the process, or -1 if the queue is empty.
+ */
+int readyQueuePeek(const ReadyQueue *rq);
+
+
+/**
+ * @brief Releases the queue's memory.
+ * @param rq Ready queue.
+ */
+void readyQueueFree(ReadyQueue *rq);
+
+
+/**
+ * @brief Builds the list of process indices ordered by arrival time.
+ * Processes arriving at the same time keep their array order.
+ * @param proc Array of processes.
+ * @param num_processes Number of processes.
+ * @return Newly allocated array of num_processes indices, or NULL on allocation failure.
+ */
+int *sortByArrival(Process proc[], int num_processes);
+
+
+/**
+ * @brief Pushes every process that has arrived by the given time onto the queue.
+ * @param rq Ready queue.
+ * @param order Process indices sorted by arrival time (see sortByArrival).
+ * @param num_processes Number of entries in order.
+ * @param next Position in order of the first process not yet admitted.
+ * @param time Current system time.
+ * @return Position in order of the first process still to arrive.
+ */
+int admitArrivals(ReadyQueue *rq, const int order[], int num_processes, int next, int time);
+
+
+/**
+ * @brief Returns the arrival time of the next process that has not been admitted.
+ * Event-driven schedulers jump the clock straight to it when nothing is ready,
+ * and never run a preemptible process past it.
+ * @param proc Array of processes.
+ * @param order Process indices sorted by arrival time.
+ * @param num_processes Number of entries in order.
+ * @param next Position in order of the first process not yet admitted.
+ * @return Arrival time, or INT_MAX if every process has arrived.
+ */
+int nextArrival(Process proc[], const int order[], int num_processes, int next);
+
+
+/**
+ * @struct FifoQueue
+ * @brief Circular first-in first-out queue of process indices (Round Robin).
+ */
+typedef struct {
+  int *slots;       /**< Ring of process indices. */
+  int head;         /**< Position of the oldest entry. */
+  int size;         /**< Number of queued processes. */
+  int capacity;     /**< Allocated entries in slots. */
+} FifoQueue;
+
+
+/**
+ * @brief Creates an empty FIFO queue.
+ * @param fq Queue to initialize.
+ * @param capacity Maximum number of processes queued at once.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int fifoQueueInit(FifoQueue *fq, int capacity);
+
+
+/**
+ * @brief Appends a process at the tail in O(1).
+ * @param fq FIFO queue.
+ * @param index Index of the process in the process array.
+ */
+void fifoQueuePush(FifoQueue *fq, int index);
+
+
+/**
+ * @brief Removes the process at the head in O(1).
+ * @param fq FIFO queue.
+ * @return Index of the removed process, or -1 if the queue is empty.
+ */
+int fifoQueuePop(FifoQueue *fq);
+
+
+/**
+ * @brief Releases the queue's memory.
+ * @param fq FIFO queue.
+ */
+void fifoQueueFree(FifoQueue *fq);
+
+#endif // READY_QUEUE_H
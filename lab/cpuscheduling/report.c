@@ -0,0 +1,59 @@
+#include <string.h>
+#include "report.h"
+
+static const char *const metricNames[] = { "waiting", "turnaround", "response" };
+
+static const MetricSummary *metricOf(const SimResult *r, int metric) {
+    return metric == 0 ? &r->waiting : (metric == 1) ? &r->turnaround : &r->response;
+}
+
+int parseReportFormat(const char *name, ReportFormat *format) {
+    if (strcmp(name, "table") == 0) *format = REPORT_TABLE;
+    else if (strcmp(name, "json") == 0) *format = REPORT_JSON;
+    else if (strcmp(name, "csv") == 0) *format = REPORT_CSV;
+    else return -1;
+    return 0;
+}
+
+void printResultsJson(const SimResult *results[], int num_results) {
+    printf("{\n  \"results\": [");
+    for (int i = 0; i < num_results; i++) {
+        const SimResult *r = results[i];
+        printf("%s\n    {\"policy\": \"%s\", \"title\": \"%s\", \"processes\": %d, \"cpus\": %d, "
+               "\"makespan\": %d, \"throughput\": %.6f, \"utilization\": %.6f, \"busy\": %lld, "
+               "\"overhead\": %lld, \"context_switches\": %lld, \"decisions\": %lld, \"io_requests\": %lld, "
+               "\"io_busy\": %lld, \"io_wait\": %lld, \"elapsed_ms\": %.3f",
+               i ? "," : "", r->policy->name, r->policy->title, r->num_processes, r->cpus, r->makespan,
+               r->throughput, r->utilization, r->busy, r->overhead, r->context_switches, r->decisions,
+               r->io_requests, r->io_busy, r->io_wait, r->elapsed_ms);
+        for (int m = 0; m < 3; m++) {
+            const MetricSummary *s = metricOf(r, m);
+            printf(",\n     \"%s\": {\"mean\": %.3f, \"p50\": %.1f, \"p95\": %.1f, \"p99\": %.1f, \"max\": %.0f}",
+                   metricNames[m], s->mean, s->p50, s->p95, s->p99, s->max);
+        }
+        printf("}");
+    }
+    printf("\n  ]\n}\n");
+}
+
+void printResultsCsv(const SimResult *results[], int num_results) {
+    printf("policy,processes,cpus,makespan,throughput,utilization,busy,overhead,context_switches,decisions,"
+           "io_requests,io_busy,io_wait,elapsed_ms");
+    for (int m = 0; m < 3; m++) {
+        printf(",%s_mean,%s_p50,%s_p95,%s_p99,%s_max", metricNames[m], metricNames[m], metricNames[m],
+               metricNames[m], metricNames[m]);
+    }
+    printf("\n");
+
+    for (int i = 0; i < num_results; i++) {
+        const SimResult *r = results[i];
+        printf("%s,%d,%d,%d,%.6f,%.6f,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%.3f", r->policy->name, r->num_processes,
+               r->cpus, r->makespan, r->throughput, r->utilization, r->busy, r->overhead, r->context_switches,
+               r->decisions, r->io_requests, r->io_busy, r->io_wait, r->elapsed_ms);
+        for (int m = 0; m < 3; m++) {
+            const MetricSummary *s = metricOf(r, m);
+            printf(",%.3f,%.1f,%.1f,%.1f,%.0f", s->mean, s->p50, s->p95, s->p99, s->max);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,49 @@
+//report.h
+
+#ifndef REPORT_H
+#define REPORT_H
+
+#include "simulate.h"
+
+
+/**
+ * @enum ReportFormat
+ * @brief How run results are printed.
+ */
+typedef enum {
+  REPORT_TABLE,  /**< Human-readable comparison table. */
+  REPORT_JSON,   /**< One JSON document. */
+  REPORT_CSV     /**< One CSV row per run, with a header row. */
+} ReportFormat;
+
+
+/**
+ * @brief Parses a format name ("table", "json" or "csv").
+ * @param name Format name.
+ * @param format Output: the format.
+ * @return 0 on success, -1 if the name is unknown.
+ */
+int parseReportFormat(const char *name, ReportFormat *format);
+
+
+/**
+ * @brief Prints results as a JSON document on stdout.
+ * - {"results": [{"policy", "title", "processes", "cpus", "makespan",
+ *   "throughput", "utilization", "busy", "overhead", "context_switches",
+ *   "decisions", "io_requests", "io_busy", "io_wait", "elapsed_ms", "waiting", "turnaround", "response"}, ...]} where each of
+ *   the last three is {"mean", "p50", "p95", "p99", "max"}.
+ * @param results Results to print.
+ * @param num_results Number of results.
+ */
+void printResultsJson(const SimResult *results[], int num_results);
+
+
+/**
+ * @brief Prints results as CSV on stdout: a header row, then one row per result.
+ * - Columns follow the JSON fields, with waiting_mean .. response_max flattened.
+ * @param results Results to print.
+ * @param num_results Number of results.
+ */
+void printResultsCsv(const SimResult *results[], int num_results);
+
+#endif // REPORT_H
@@ -0,0 +1,202 @@
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "generator.h"
+#include "process_table.h"
+#include "simulate.h"
+#include "workload.h"
+
+#define BENCH_SEED 20240601ULL  /**< Default seed: fixed so runs are comparable across commits. */
+
+/**
+ * @struct BenchSample
+ * @brief What a benchmark child reports back to the parent.
+ */
+typedef struct {
+  int status;            /**< 0 on success. */
+  long long decisions;   /**< Scheduling decisions made. */
+  double elapsed_ms;     /**< Time spent in simulate(). */
+} BenchSample;
+
+static const char *burstName(BurstDistribution bursts) {
+    return (bursts == BURST_PARETO) ? "pareto" : "exponential";
+}
+
+/**
+ * @brief Generates a workload and simulates one policy over it (runs in a child process).
+ */
+static BenchSample benchOnce(const Policy *policy, const WorkloadSpec *spec, int quantum) {
+    BenchSample sample = { -1, 0, 0 };
+    PolicyParams params = defaultPolicyParams(quantum);
+    Process *proc = NULL;
+    SimResult result;
+
+    if (generateWorkload(spec, &proc) != 0) return sample;
+    if (simulate(policy, proc, spec->num_processes, &params, NULL, &result) == 0) {
+        sample.status = 0;
+        sample.decisions = result.decisions;
+        sample.elapsed_ms = result.elapsed_ms;
+    }
+    free(proc);
+    return sample;
+}
+
+/**
+ * @brief Runs one benchmark case in a forked child so its peak memory is measured alone.
+ * @param peak_kb Output: peak resident set size of the child in KiB.
+ */
+static BenchSample benchCase(const Policy *policy, const WorkloadSpec *spec, int quantum, long *peak_kb) {
+    BenchSample sample = { -1, 0, 0 };
+    struct rusage usage;
+    int fds[2], status;
+
+    fflush(stdout);
+    if (pipe(fds) != 0) {
+        perror("pipe failed");
+        return sample;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork failed");
+        close(fds[0]);
+        close(fds[1]);
+        return sample;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        sample = benchOnce(policy, spec, quantum);
+        ssize_t written = write(fds[1], &sample, sizeof(sample));
+        _exit(written == (ssize_t)sizeof(sample) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    if (read(fds[0], &sample, sizeof(sample)) != (ssize_t)sizeof(sample)) sample.status = -1;
+    close(fds[0]);
+    *peak_kb = (wait4(pid, &status, 0, &usage) == pid) ? usage.ru_maxrss : 0;
+    return sample;
+}
+
+/**
+ * @brief Parses a comma-separated list of policy names.
+ * @return Number of policies, or -1 if a name is unknown.
+ */
+static int parsePolicies(char *list, const Policy *out[], int max) {
+    int n = 0;
+    for (char *name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        const Policy *policy = findPolicy(name);
+        if (!policy || n == max) {
+            printf("Unknown or too many policies: %s\n", name);
+            return -1;
+        }
+        out[n++] = policy;
+    }
+    return n;
+}
+
+/**
+ * @brief Main function of the scheduler benchmark.
+ * - Usage: ./schedule_bench_exec [-m min_processes] [-n max_processes] [-p policy,...]
+ *          [-b exponential|pareto|all] [-q quantum] [-s seed] [-c] [-o workload_file]
+ * - Generates Poisson-arrival workloads with skewed priorities at every power of ten
+ *   from -m (default 100) to -n (default 1000000) and times each policy on them.
+ * - Reports decisions/sec, ns/decision and the peak RSS of the process that ran the case.
+ * - -c prints CSV instead of a table; -o writes the largest generated workload to
+ *   a binary workload file (see workload.h) and exits.
+ */
+int main(int argc, char *argv[]) {
+    const Policy *policies[16];
+    BurstDistribution bursts[2] = { BURST_EXPONENTIAL, BURST_PARETO };
+    const char *output_path = NULL;
+    uint64_t seed = BENCH_SEED;
+    int min_processes = 100, max_processes = 1000000, quantum = 4, csv = 0, opt;
+    int num_policies = 0, first_burst = 0, last_burst = 1;
+
+    while ((opt = getopt(argc, argv, "m:n:p:b:q:s:co:")) != -1) {
+        if (opt == 'm') {
+            min_processes = atoi(optarg);
+        } else if (opt == 'n') {
+            max_processes = atoi(optarg);
+        } else if (opt == 'p') {
+            if ((num_policies = parsePolicies(optarg, policies, 16)) <= 0) return 1;
+        } else if (opt == 'b' && strcmp(optarg, "exponential") == 0) {
+            first_burst = last_burst = 0;
+        } else if (opt == 'b' && strcmp(optarg, "pareto") == 0) {
+            first_burst = last_burst = 1;
+        } else if (opt == 'b' && strcmp(optarg, "all") == 0) {
+            first_burst = 0;
+            last_burst = 1;
+        } else if (opt == 'q') {
+            quantum = atoi(optarg);
+        } else if (opt == 's') {
+            seed = strtoull(optarg, NULL, 10);
+        } else if (opt == 'c') {
+            csv = 1;
+        } else if (opt == 'o') {
+            output_path = optarg;
+        } else {
+            printf("Usage: %s [-m min_processes] [-n max_processes] [-p policy,...] "
+                   "[-b exponential|pareto|all] [-q quantum] [-s seed] [-c] [-o workload_file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (min_processes <= 0 || max_processes < min_processes || quantum <= 0) {
+        printf("Invalid sizes or quantum\n");
+        return 1;
+    }
+    if (num_policies == 0) {
+        while (policyList[num_policies] && num_policies < 16) {
+            policies[num_policies] = policyList[num_policies];
+            num_policies++;
+        }
+    }
+
+    if (output_path) {
+        WorkloadSpec spec = defaultWorkloadSpec(max_processes, bursts[first_burst], seed);
+        Process *proc = NULL;
+        if (generateWorkload(&spec, &proc) != 0) return 1;
+        int status = workloadWriteBinary(output_path, proc, max_processes);
+        if (status == 0) {
+            printf("Wrote %d %s-burst processes to %s\n", max_processes, burstName(bursts[first_burst]), output_path);
+        } else {
+            printf("Unable to write %s\n", output_path);
+        }
+        free(proc);
+        return status == 0 ? 0 : 1;
+    }
+
+    if (csv) {
+        printf("bursts,processes,policy,decisions,ms,decisions_per_sec,ns_per_decision,peak_rss_kb\n");
+    } else {
+        ProcessTable probe;
+        if (processTableInit(&probe, NULL, 0) != 0) return 1;
+        printf("Seed %llu, quantum %d, scan kernel %s\n", (unsigned long long)seed, quantum, probe.kernel);
+        processTableFree(&probe);
+        printf("%-12s %10s %-30s %10s %10s %14s %12s %10s\n", "Bursts", "Processes", "Policy",
+               "Decisions", "Time (ms)", "Decisions/s", "ns/decision", "Peak MB");
+    }
+
+    for (int b = first_burst; b <= last_burst; b++) {
+        for (long long n = min_processes; n <= max_processes; n *= 10) {
+            WorkloadSpec spec = defaultWorkloadSpec((int)n, bursts[b], seed);
+            for (int p = 0; p < num_policies; p++) {
+                long peak_kb = 0;
+                BenchSample sample = benchCase(policies[p], &spec, quantum, &peak_kb);
+                if (sample.status != 0) {
+                    printf("%s %lld %s failed\n", burstName(bursts[b]), n, policies[p]->name);
+                    continue;
+                }
+                double per_sec = sample.elapsed_ms > 0 ? sample.decisions / (sample.elapsed_ms / 1000.0) : 0;
+                double ns = sample.decisions > 0 ? sample.elapsed_ms * 1e6 / sample.decisions : 0;
+                if (csv) {
+                    printf("%s,%lld,%s,%lld,%.3f,%.0f,%.1f,%ld\n", burstName(bursts[b]), n, policies[p]->name,
+                           sample.decisions, sample.elapsed_ms, per_sec, ns, peak_kb);
+                } else {
+                    printf("%-12s %10lld %-30s %10lld %10.2f %14.0f %12.1f %10.1f\n", burstName(bursts[b]), n,
+                           policies[p]->title, sample.decisions, sample.elapsed_ms, per_sec, ns, peak_kb / 1024.0);
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,380 @@
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "simulate.h"
+#include "smp.h"
+#include "report.h"
+#include "workload.h"
+
+#define MAX_RUNS 16  /**< Most policies compared in one invocation. */
+
+/**
+ * @struct PolicyRun
+ * @brief One policy simulated on its own thread over a private copy of the workload.
+ */
+typedef struct {
+  const Policy *policy;   /**< Policy to simulate. */
+  const Process *input;   /**< Shared, read-only workload. */
+  Process *proc;          /**< Private copy the simulation modifies. */
+  int num_processes;      /**< Number of processes. */
+  const PolicyParams *params; /**< Policy tunables. */
+  int verbose;            /**< Keep the Gantt chart for printing afterwards. */
+  const SmpConfig *smp;   /**< Multi-CPU parameters, or NULL for one CPU. */
+  GanttChart gantt;       /**< Execution history (only filled when verbose on one CPU). */
+  SimResult result;       /**< Summary of the run. */
+  SmpResult smp_result;   /**< Per-CPU counters (multi-CPU runs). */
+  int status;             /**< 0 on success, -1 on failure. */
+  pthread_t thread;       /**< Thread running the simulation. */
+} PolicyRun;
+
+/**
+ * @brief Thread body: copies the workload and simulates one policy over it.
+ */
+static void *runPolicy(void *arg) {
+    PolicyRun *run = (PolicyRun*)arg;
+
+    run->status = -1;
+    run->proc = (Process*)malloc((run->num_processes > 0 ? run->num_processes : 1) * sizeof(Process));
+    if (!run->proc) {
+        printf("Memory allocation failed\n");
+        return NULL;
+    }
+    memcpy(run->proc, run->input, run->num_processes * sizeof(Process));
+
+    ganttInit(&run->gantt, run->policy->title, NULL);
+    if (run->smp) {
+        run->status = simulateSmp(run->policy, run->proc, run->num_processes, run->params,
+                                  run->smp, &run->smp_result);
+        run->result = run->smp_result.summary;
+    } else {
+        run->status = simulate(run->policy, run->proc, run->num_processes, run->params,
+                               run->verbose ? &run->gantt : NULL, &run->result);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Prints one row per policy, side by side.
+ * - CPU % is the busy time over makespan times the number of CPUs, Ovh % the
+ *   share of that capacity lost to dispatches and context switches.
+ * - Runs with I/O bursts get a line of device statistics.
+ */
+static void printComparison(PolicyRun runs[], int num_runs) {
+    printf("\n%-30s %10s %10s %10s %10s %10s %9s %9s %6s %6s %10s %10s\n", "Policy", "Avg Wait", "P99 Wait",
+           "Avg TAT", "Avg Resp", "P99 Resp", "Max Wait", "Makespan", "CPU %", "Ovh %", "Switches", "Time (ms)");
+    for (int i = 0; i < num_runs; i++) {
+        const SimResult *r = &runs[i].result;
+        if (runs[i].status != 0) {
+            printf("%-30s %s\n", runs[i].policy->title, "failed");
+            continue;
+        }
+        double capacity = (double)r->makespan * r->cpus;
+        printf("%-30s %10.2f %10.0f %10.2f %10.2f %10.0f %9.0f %9d %6.1f %6.1f %10lld %10.2f\n", runs[i].policy->title,
+               r->waiting.mean, r->waiting.p99, r->turnaround.mean, r->response.mean, r->response.p99,
+               r->waiting.max, r->makespan, 100.0 * r->utilization, capacity > 0 ? 100.0 * r->overhead / capacity : 0.0,
+               r->context_switches, r->elapsed_ms);
+    }
+    for (int i = 0; i < num_runs; i++) {
+        const SimResult *r = &runs[i].result;
+        if (runs[i].status != 0 || r->io_requests == 0) continue;
+        printf("%-30s I/O: %lld requests, device busy %lld, queued %lld (%.2f per request)\n", runs[i].policy->title,
+               r->io_requests, r->io_busy, r->io_wait, (double)r->io_wait / r->io_requests);
+    }
+}
+
+/**
+ * @brief Prints the utilization and migration counters of every CPU for each policy.
+ */
+static void printCpuStats(PolicyRun runs[], int num_runs) {
+    printf("\n%-30s %4s %7s %9s %11s %9s %9s\n", "Policy", "CPU", "Util %", "Stall", "Dispatches",
+           "Mig In", "Mig Out");
+    for (int i = 0; i < num_runs; i++) {
+        const SmpResult *r = &runs[i].smp_result;
+        if (runs[i].status != 0) continue;
+        for (int c = 0; c < r->cpus; c++) {
+            const SmpCpuStats *cpu = &r->cpu[c];
+            printf("%-30s %4d %7.1f %9lld %11lld %9lld %9lld\n", c == 0 ? runs[i].policy->title : "", c,
+                   r->summary.makespan > 0 ? 100.0 * cpu->busy / r->summary.makespan : 0.0, cpu->stall,
+                   cpu->dispatches, cpu->migrations_in, cpu->migrations_out);
+        }
+        printf("%-30s steals %lld, balanced %lld\n", "", r->steals, r->balanced);
+    }
+}
+
+/**
+ * @brief Checks that MLFQ demotion survives I/O.
+ * - Quantum 2, two levels, no boost. An I/O-bound process alternates 1-unit
+ *   CPU and I/O bursts beside a CPU-bound one. Its top-level allotment is used
+ *   up over two bursts, so it drops to the bottom level, behind the CPU-bound
+ *   process, which then runs for its whole bottom-level allotment (4) before
+ *   the I/O-bound one gets the CPU back. If a return from I/O restarted it at
+ *   the top, it would preempt the CPU-bound process after every unit, and
+ *   nothing but the top-level allotment (2) would ever run in one stretch.
+ * @return 0 if the check passes, 1 otherwise.
+ */
+static int checkMlfqIo(void) {
+    static const int io_bound[] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+    Process proc[2];
+    PolicyParams params = defaultPolicyParams(2);
+    GanttChart gantt;
+    SimResult result;
+
+    for (int i = 0; i < 2; i++) initializeProcess(&proc[i]);
+    proc[0].process_id = 1;
+    proc[0].num_bursts = sizeof(io_bound) / sizeof(io_bound[0]);
+    proc[0].bursts = io_bound;
+    proc[0].burst_time = proc[0].num_bursts / 2 + 1;
+    proc[0].io_time = proc[0].num_bursts / 2;
+    proc[0].remaining_time = io_bound[0];
+    proc[1].process_id = 2;
+    proc[1].burst_time = proc[1].remaining_time = 12;
+    params.mlfq_levels = 2;
+    params.mlfq_boost = 0;
+
+    ganttInit(&gantt, mlfqPolicy.title, NULL);
+    if (simulate(&mlfqPolicy, proc, 2, &params, &gantt, &result) != 0) {
+        ganttFree(&gantt);
+        return 1;
+    }
+    // Longest stretch of the CPU-bound process while the I/O-bound one was still running.
+    int longest = 0;
+    for (int i = 0; i < gantt.count; i++) {
+        const GanttSegment *g = &gantt.segments[i];
+        int end = g->end < proc[0].completion_time ? g->end : proc[0].completion_time;
+        if (g->process_id == 2 && end - g->start > longest) longest = end - g->start;
+    }
+    ganttPrint(&gantt);
+    ganttFree(&gantt);
+
+    int ok = longest > params.quantum;
+    printf("MLFQ with I/O: the CPU-bound process ran up to %d units at a time beside the I/O-bound one: %s\n",
+           longest, ok ? "demoted across I/O" : "never demoted (FAILED)");
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Parses a comma-separated list of policy names.
+ * @return Number of policies, or -1 if a name is unknown.
+ */
+static int parsePolicies(char *list, const Policy *out[], int max) {
+    int n = 0;
+    for (char *name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        const Policy *policy = findPolicy(name);
+        if (!policy) {
+            printf("Unknown policy: %s\n", name);
+            return -1;
+        }
+        if (n == max) {
+            printf("At most %d policies can be compared\n", max);
+            return -1;
+        }
+        out[n++] = policy;
+    }
+    return n;
+}
+
+/**
+ * @brief Main function of the unified driver.
+ * - Usage: ./schedule_driver_exec [-p policy,...] [-q quantum] [-w workload_file] [-s] [-v]
+ *          [-f table|json|csv] [-k switch_cost] [-d dispatch_cost] [-i io_devices] [-L mlfq_levels] [-B mlfq_boost] [-l cfs_latency] [-g cfs_min_granularity]
+ *          [-c cpus [-m migration_cost] [-e epoch] [-b balance_interval] [-t]] [-x]
+ * - Runs each policy (default: all of policyList) over the same workload, each on
+ *   its own thread with its own copy of the process array, then prints a comparison table.
+ * - -s runs the policies one after another instead, -v prints each policy's
+ *   Gantt chart and process table.
+ * - -f prints the results as a table (default), a JSON document or CSV rows;
+ *   the machine-readable formats print nothing else (see report.h).
+ * - -k charges that much CPU time for every context switch, -d for every
+ *   dispatch; -i sets the number of I/O devices serving processes whose
+ *   workload lines carry CPU/I-O burst lists (see workload.h).
+ * - -L and -B set the number of MLFQ levels and the boost interval (0 disables
+ *   boosting); -l and -g the CFS target latency and minimum granularity.
+ *   Unset values follow the quantum (see defaultPolicyParams()).
+ * - -c simulates that many CPUs with per-CPU runqueues (see smp.h): -m sets the
+ *   migration cost, -e the epoch between work-stealing points, -b the periodic
+ *   balancing interval (0 disables it) and -t advances each CPU on its own thread.
+ *   Per-CPU utilization and migration counts are printed after the comparison.
+ * - -x only runs the built-in I/O case that checks MLFQ demotion (see checkMlfqIo()).
+ */
+int main(int argc, char *argv[]) {
+    const Policy *policies[MAX_RUNS];
+    PolicyRun runs[MAX_RUNS];
+    const char *workload_path = NULL;
+    Process *proc = NULL;
+    Arena bursts;
+    int num_processes = 0, num_runs = 0, quantum = 4, serial = 0, verbose = 0, opt;
+    ReportFormat format = REPORT_TABLE;
+    int switch_cost = 0, dispatch_cost = 0, io_devices = 1, levels = -1, boost = -1, latency = -1, granularity = -1;
+    SmpConfig smp = { .cpus = 0, .migration_cost = 2, .epoch = 10, .balance_interval = 100, .threads = 0 };
+
+    while ((opt = getopt(argc, argv, "p:q:w:svf:k:d:i:L:B:l:g:c:m:e:b:tx")) != -1) {
+        if (opt == 'p') {
+            if ((num_runs = parsePolicies(optarg, policies, MAX_RUNS)) <= 0) return 1;
+        } else if (opt == 'q') {
+            quantum = atoi(optarg);
+        } else if (opt == 'w') {
+            workload_path = optarg;
+        } else if (opt == 's') {
+            serial = 1;
+        } else if (opt == 'v') {
+            verbose = 1;
+        } else if (opt == 'f') {
+            if (parseReportFormat(optarg, &format) != 0) {
+                printf("Unknown format: %s (table, json or csv)\n", optarg);
+                return 1;
+            }
+        } else if (opt == 'k') {
+            switch_cost = atoi(optarg);
+        } else if (opt == 'd') {
+            dispatch_cost = atoi(optarg);
+        } else if (opt == 'i') {
+            io_devices = atoi(optarg);
+        } else if (opt == 'L') {
+            levels = atoi(optarg);
+        } else if (opt == 'B') {
+            boost = atoi(optarg);
+        } else if (opt == 'l') {
+            latency = atoi(optarg);
+        } else if (opt == 'g') {
+            granularity = atoi(optarg);
+        } else if (opt == 'c') {
+            smp.cpus = atoi(optarg);
+        } else if (opt == 'm') {
+            smp.migration_cost = atoi(optarg);
+        } else if (opt == 'e') {
+            smp.epoch = atoi(optarg);
+        } else if (opt == 'b') {
+            smp.balance_interval = atoi(optarg);
+        } else if (opt == 't') {
+            smp.threads = 1;
+        } else if (opt == 'x') {
+            return checkMlfqIo();
+        } else {
+            printf("Usage: %s [-p policy,...] [-q quantum] [-w workload_file] [-s] [-v]\n"
+                   "       [-f table|json|csv] [-k switch_cost] [-d dispatch_cost] [-i io_devices] [-L mlfq_levels] [-B mlfq_boost] [-l cfs_latency] [-g cfs_min_granularity]\n"
+                   "       [-c cpus [-m migration_cost] [-e epoch] [-b balance_interval] [-t]] [-x]\n", argv[0]);
+            printf("Policies:");
+            for (int i = 0; policyList[i]; i++) printf(" %s", policyList[i]->name);
+            for (int i = 0; scanPolicyList[i]; i++) printf(" %s", scanPolicyList[i]->name);
+            printf("\n");
+            return 1;
+        }
+    }
+    if (quantum <= 0) {
+        printf("Quantum must be positive\n");
+        return 1;
+    }
+    PolicyParams params = defaultPolicyParams(quantum);
+    params.switch_cost = switch_cost;
+    params.dispatch_cost = dispatch_cost;
+    params.io_devices = io_devices;
+    if (levels != -1) params.mlfq_levels = levels;
+    if (boost != -1) params.mlfq_boost = boost;
+    if (latency != -1) params.cfs_latency = latency;
+    if (granularity != -1) params.cfs_min_granularity = granularity;
+    if (params.switch_cost < 0 || params.dispatch_cost < 0 || params.io_devices < 1 || params.mlfq_levels < 1 || params.mlfq_levels > 30 || params.mlfq_boost < 0 ||
+        params.cfs_latency <= 0 || params.cfs_min_granularity <= 0) {
+        printf("Invalid switch or dispatch cost, I/O devices, MLFQ levels (1-30), boost interval, CFS latency or granularity\n");
+        return 1;
+    }
+    if (smp.cpus < 0 || (smp.cpus > 0 && (smp.epoch <= 0 || smp.migration_cost < 0 || smp.balance_interval < 0))) {
+        printf("Invalid CPU count, epoch, migration cost or balance interval\n");
+        return 1;
+    }
+    if (num_runs == 0) {
+        while (policyList[num_runs] && num_runs < MAX_RUNS) {
+            policies[num_runs] = policyList[num_runs];
+            num_runs++;
+        }
+    }
+
+    arenaInit(&bursts, 0);
+    if (workload_path) {
+        double load_start = wallClockMs();
+        if (workloadLoadBursts(workload_path, &proc, &num_processes, &bursts) != 0) return 1;
+        if (format == REPORT_TABLE) printf("Loaded %d processes from %s in %.2f ms\n", num_processes, workload_path, wallClockMs() - load_start);
+    } else {
+        int input[][4] = {
+            {1, 0, 8, 3},  /* {process_id, arrival_time, burst_time, priority} */
+            {2, 1, 4, 1},
+            {3, 2, 9, 4},
+            {4, 3, 5, 2}
+        };
+
+        num_processes = sizeof(input) / sizeof(input[0]);
+        proc = (Process*)malloc(num_processes * sizeof(Process));
+
+        // Initialize processes.
+        for (int i = 0; i < num_processes; i++) {
+            initializeProcess(&proc[i]);
+            proc[i].process_id = input[i][0];
+            proc[i].arrival_time = input[i][1];
+            proc[i].burst_time = input[i][2];
+            proc[i].remaining_time = proc[i].burst_time;
+            proc[i].priority = input[i][3];
+        }
+    }
+    if (smp.cpus > 0) {
+        for (int i = 0; i < num_processes; i++) {
+            if (proc[i].num_bursts > 1) {
+                printf("I/O bursts are only simulated on one CPU (process %d has some); drop -c\n", proc[i].process_id);
+                free(proc);
+                arenaFree(&bursts);
+                return 1;
+            }
+        }
+    }
+
+    double start = wallClockMs();
+    for (int i = 0; i < num_runs; i++) {
+        runs[i] = (PolicyRun){ .policy = policies[i], .input = proc, .num_processes = num_processes,
+                               .params = &params, .verbose = verbose, .smp = smp.cpus > 0 ? &smp : NULL,
+                               .status = -1 };
+        if (serial) {
+            runPolicy(&runs[i]);
+        } else if (pthread_create(&runs[i].thread, NULL, runPolicy, &runs[i]) != 0) {
+            printf("Unable to start a thread for %s\n", policies[i]->title);
+            num_runs = i;
+            break;
+        }
+    }
+    if (!serial) {
+        for (int i = 0; i < num_runs; i++) pthread_join(runs[i].thread, NULL);
+    }
+    double elapsed = wallClockMs() - start;
+
+    if (format != REPORT_TABLE) {
+        const SimResult *results[MAX_RUNS];
+        int num_results = 0;
+        for (int i = 0; i < num_runs; i++) {
+            if (runs[i].status == 0) results[num_results++] = &runs[i].result;
+        }
+        if (format == REPORT_JSON) printResultsJson(results, num_results);
+        else printResultsCsv(results, num_results);
+        verbose = 0;
+    }
+    for (int i = 0; verbose && i < num_runs; i++) {
+        if (runs[i].status != 0) continue;
+        if (smp.cpus > 0) {
+            printf("\n%s on %d CPUs:\n", runs[i].policy->title, smp.cpus);
+        } else {
+            ganttPrint(&runs[i].gantt);
+        }
+        printProcesses(runs[i].proc, num_processes);
+    }
+    if (format == REPORT_TABLE) {
+        printComparison(runs, num_runs);
+        if (smp.cpus > 0) printCpuStats(runs, num_runs);
+        printf("\n%d policies over %d processes (quantum %d) in %.2f ms %s\n", num_runs, num_processes, quantum,
+               elapsed, serial ? "one after another" : "on parallel threads");
+    }
+
+    for (int i = 0; i < num_runs; i++) {
+        ganttFree(&runs[i].gantt);
+        smpResultFree(&runs[i].smp_result);
+        free(runs[i].proc);
+    }
+    free(proc);
+    arenaFree(&bursts);
+    return 0;
+}
@@ -1,57 +1,34 @@
-#include "process.h"
-
-/**
- * @brief Finds the next available process based on FCFS.
- * - Selects the process that arrived first and has not completed.
- *
- * @param proc Array of processes.
- * @param num_processes Number of processes.
- * @param time Current system time.
- * @return Index of the selected process, or -1 if no process is available.
- */
-int findNextFCFSProcess(Process proc[], int num_processes, int time) {
-    int min_index = -1;
-    int earliest_arrival = INT_MAX; // Large initial value
-
-    for (int i = 0; i < num_processes; i++) {
-        if (proc[i].arrival_time <= time && proc[i].remaining_time > 0) {
-            if (proc[i].arrival_time < earliest_arrival) {
-                earliest_arrival = proc[i].arrival_time;
-                min_index = i;
-            }
-        }
-    }
-    return min_index;
-}
+#include <unistd.h>
+#include "ready_queue.h"
+#include "gantt.h"
+#include "workload.h"
+#include "trace.h"
 
 /**
  * @brief Executes the selected process for FCFS scheduling.
  * - Updates execution log and Gantt Chart.
- * - Prints the "Process starts" message only when switching to a new process.
+ * - Logs the "Process starts" event only when switching to a new process.
  *
  * @param proc Array of processes.
  * @param index Index of the selected process.
  * @param time Pointer to current time.
- * @param gantt_chart Array storing execution order.
- * @param gc_index Pointer to Gantt chart index.
+ * @param gantt Gantt chart receiving the executed slice.
  * @param last_index Pointer to variable tracking the last executed process index.
  */
-void executeProcessFCFS(Process proc[], int index, int *time, int gantt_chart[], int *gc_index, int *last_index) {
-    // If the process is different from the last one executed, print the "Process starts" message.
+void executeProcessFCFS(Process proc[], int index, int *time, GanttChart *gantt, int *last_index) {
+    // If the process is different from the last one executed, log "Process starts".
     if (*last_index != index) {
-        printf("Time %d: Process %d starts, (Burst time: %d)\n", *time, proc[index].process_id, proc[index].remaining_time);
+        LOG_EVENT(TRACE_START, *time, proc[index].process_id, proc[index].remaining_time, 0);
         *last_index = index; // Update last_index to current process index.
-
-        // Log this process in the Gantt chart.
-        gantt_chart[(*gc_index)++] = proc[index].process_id;
     }
 
     // Execute for the full burst time (non-preemptive).
     *time += proc[index].burst_time;
+    ganttRecord(gantt, proc[index].process_id, *time - proc[index].burst_time, *time);
     proc[index].remaining_time = 0;
     proc[index].completion_time = *time;
 
-    printf("Time %d: Process %d completes\n", *time, proc[index].process_id);
+    LOG_EVENT(TRACE_COMPLETE, *time, proc[index].process_id, 0, 0);
 }
 
 /**
@@ -60,60 +37,123 @@ void executeProcessFCFS(Process proc[], int index, int *time, int gantt_chart[],
  *
  * @param proc Array of processes.
  * @param num_processes Number of processes.
+ * @param gantt Gantt chart to record into.
  */
-void fcfsScheduling(Process proc[], int num_processes) {
+void fcfsScheduling(Process proc[], int num_processes, GanttChart *gantt) {
     int time = 0, completed = 0;
-    int gantt_chart[100], gc_index = 0;
     int last_index = -1;  // Track the index of the last process that started execution
+    int *order = sortByArrival(proc, num_processes);
 
-    printf("\n=== First-Come, First-Served (FCFS) Scheduling ===\n");
+    if (!order) {
+        printf("Memory allocation failed\n");
+        return;
+    }
+
+    LOG_EVENT(TRACE_BEGIN, time, 0, TRACE_FCFS, 0);
 
-    // Loop until all processes have completed.
+    // Processes run in arrival order; an idle CPU jumps straight to the next arrival.
     while (completed < num_processes) {
-        int index = findNextFCFSProcess(proc, num_processes, time);
+        int index = order[completed];
 
-        if (index != -1) {
-            executeProcessFCFS(proc, index, &time, gantt_chart, &gc_index, &last_index);
-            completed++; // Process finishes in one execution
-        } else {
-            time++; // Move time forward if no process is available
-        }
+        if (proc[index].arrival_time > time) time = proc[index].arrival_time;
+        executeProcessFCFS(proc, index, &time, gantt, &last_index);
+        completed++; // Process finishes in one execution
     }
+    free(order);
 
     // Print Gantt Chart Execution Order.
-    printf("\nGantt Chart Execution Order (FCFS):\n");
-    for (int i = 0; i < gc_index; i++) {
-        printf("P%d ", gantt_chart[i]);
-    }
-    printf("\n");
+    if (LOG_ENABLED(LOG_SUMMARY)) ganttPrint(gantt); else ganttFlush(gantt);
 }
 
 /**
  * @brief Main function for FCFS Scheduling.
+ * - Usage: ./schedule_fcfs_exec [-w workload_file] [-g gantt_file]
+ *          [-l quiet|summary|events] [-t trace_file]
+ * - -w loads the workload from a CSV or binary file (see workload.h); load time
+ *   and scheduling time are reported separately. Without -w, the built-in example runs.
+ * - -g streams the Gantt chart to a file instead of keeping it in memory.
+ * - -l selects the output: quiet (times only), summary (no per-event lines) or
+ *   events (default). Building with -DSCHED_LOG_LEVEL=LOG_QUIET removes the
+ *   logging code altogether (see trace.h).
+ * - -t writes every event to a binary trace file, whatever the output level;
+ *   trace_render_exec turns it back into the event log.
  */
-int main() {
-    int input[][3] = {
-        {1, 0, 8},  /* {process_id, arrival_time, burst_time} */
-        {2, 1, 4},
-        {3, 2, 9},
-        {4, 3, 5}
-    };
-
-    int num_processes = sizeof(input) / sizeof(input[0]);
-    Process* proc = (Process*)malloc(num_processes * sizeof(Process));
-
-    // Initialize processes.
-    for (int i = 0; i < num_processes; i++) {
-        initializeProcess(&proc[i]);
-        proc[i].process_id = input[i][0];
-        proc[i].arrival_time = input[i][1];
-        proc[i].burst_time = input[i][2];
-        proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set
+int main(int argc, char *argv[]) {
+    const char *gantt_path = NULL, *workload_path = NULL, *trace_path = NULL;
+    static TraceWriter trace;
+    FILE *gantt_out = NULL;
+    GanttChart gantt;
+    Process *proc = NULL;
+    int num_processes = 0, opt;
+
+    while ((opt = getopt(argc, argv, "w:g:l:t:")) != -1) {
+        if (opt == 'w') {
+            workload_path = optarg;
+        } else if (opt == 'g') {
+            gantt_path = optarg;
+        } else if (opt == 'l' && parseLogLevel(optarg) != -1) {
+            log_level = parseLogLevel(optarg);
+        } else if (opt == 't') {
+            trace_path = optarg;
+        } else {
+            printf("Usage: %s [-w workload_file] [-g gantt_file]\n"
+                   "       [-l quiet|summary|events] [-t trace_file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (gantt_path && !(gantt_out = fopen(gantt_path, "w"))) {
+        perror("Unable to open Gantt chart file");
+        return 1;
+    }
+    if (trace_path) {
+        if (traceOpen(&trace, trace_path) != 0) return 1;
+        event_trace = &trace;
     }
 
-    fcfsScheduling(proc, num_processes);
-    printProcesses(proc, num_processes);
+    if (workload_path) {
+        double load_start = wallClockMs();
+        if (workloadLoad(workload_path, &proc, &num_processes) != 0) return 1;
+        printf("Loaded %d processes from %s in %.2f ms\n", num_processes, workload_path, wallClockMs() - load_start);
+    } else {
+        int input[][3] = {
+            {1, 0, 8},  /* {process_id, arrival_time, burst_time} */
+            {2, 1, 4},
+            {3, 2, 9},
+            {4, 3, 5}
+        };
+
+        num_processes = sizeof(input) / sizeof(input[0]);
+        proc = (Process*)malloc(num_processes * sizeof(Process));
+
+        // Initialize processes.
+        for (int i = 0; i < num_processes; i++) {
+            initializeProcess(&proc[i]);
+            proc[i].process_id = input[i][0];
+            proc[i].arrival_time = input[i][1];
+            proc[i].burst_time = input[i][2];
+            proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set.
+        }
+    }
+
+    double start = wallClockMs();
+    ganttInit(&gantt, "FCFS", gantt_out);
+    fcfsScheduling(proc, num_processes, &gantt);
+    ganttFree(&gantt);
+    if (workload_path) printf("Scheduling time: %.2f ms\n", wallClockMs() - start);
+    if (LOG_ENABLED(LOG_SUMMARY)) printProcesses(proc, num_processes);
+
+    int status = 0;
+    if (event_trace) {
+        long long events = trace.total;
+        if (traceClose(&trace) != 0) {
+            printf("Unable to write trace file %s\n", trace_path);
+            status = 1;
+        } else {
+            printf("Traced %lld events to %s\n", events, trace_path);
+        }
+    }
 
     free(proc);
-    return 0;
-}
\ No newline at end of file
+    if (gantt_out) fclose(gantt_out);
+    return status;
+}
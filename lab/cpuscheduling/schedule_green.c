@@ -0,0 +1,410 @@
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "generator.h"
+#include "green.h"
+
+#define GREEN_SEED 20240601ULL        /**< Default seed of the generated workload (same as the benchmark). */
+#define GREEN_STACK (64 * 1024)       /**< Stack of every green thread and pthread in the benchmark. */
+#define GREEN_RUNTIMES 4              /**< Policies run as real dispatchers by default. */
+#define ERRNO_THREADS 16              /**< Green threads of the errno check. */
+#define ERRNO_CHECKS 2000             /**< Times each of them checks its errno. */
+
+/**
+ * @struct GreenTask
+ * @brief One task of the workload: spins for its burst and records when it ran.
+ */
+typedef struct {
+  long long iterations;  /**< Spin loop iterations of its burst. */
+  int burst_us;          /**< Its burst in microseconds (the estimate handed to SJF). */
+  int priority;          /**< Priority from the generator. */
+  double started;        /**< Time it first ran (pthreads baseline). */
+  double finished;       /**< Time it finished (pthreads baseline). */
+} GreenTask;
+
+/**
+ * @struct PingPong
+ * @brief Two pthreads handing a token back and forth.
+ */
+typedef struct {
+  pthread_mutex_t lock;  /**< Protects turn. */
+  pthread_cond_t turned; /**< Signalled at every handoff. */
+  int turn;              /**< Thread whose turn it is (0 or 1). */
+  long long rounds;      /**< Handoffs each thread makes. */
+} PingPong;
+
+/**
+ * @struct PingPongPlayer
+ * @brief Argument of one ping-pong thread.
+ */
+typedef struct {
+  PingPong *game;        /**< Shared state. */
+  int me;                /**< 0 or 1. */
+} PingPongPlayer;
+
+/**
+ * @struct ErrnoProbe
+ * @brief One green thread of the errno check.
+ */
+typedef struct {
+  int value;             /**< errno value the thread sets and expects to keep. */
+  long long iterations;  /**< Spin loop iterations between checks. */
+  int mismatches;        /**< Checks that found another errno. */
+  int migrations;        /**< Checks that found it on another kernel thread than the last one. */
+} ErrnoProbe;
+
+static volatile unsigned spin_sink;  /**< Keeps the spin loop from being optimized away. */
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void spin(long long iterations) {
+    for (long long i = 0; i < iterations; i++) spin_sink += (unsigned)i;
+}
+
+/**
+ * @brief Spin loop iterations per microsecond on this machine.
+ */
+static double calibrateSpin(void) {
+    long long iterations = 1000000;
+    while (1) {
+        double start = nowMs();
+        spin(iterations);
+        double elapsed = nowMs() - start;
+        if (elapsed >= 50) return iterations / (elapsed * 1000.0);
+        iterations *= 2;
+    }
+}
+
+static void greenTaskBody(void *arg) {
+    spin(((GreenTask*)arg)->iterations);
+}
+
+static void *pthreadTaskBody(void *arg) {
+    GreenTask *task = (GreenTask*)arg;
+    task->started = nowMs();
+    spin(task->iterations);
+    task->finished = nowMs();
+    return NULL;
+}
+
+static void yieldBody(void *arg) {
+    long long rounds = *(long long*)arg;
+    for (long long i = 0; i < rounds; i++) greenYield();
+}
+
+static void emptyBody(void *arg) {
+    (void)arg;
+}
+
+static void *pingPongBody(void *arg) {
+    PingPongPlayer *player = (PingPongPlayer*)arg;
+    PingPong *game = player->game;
+    pthread_mutex_lock(&game->lock);
+    for (long long i = 0; i < game->rounds; i++) {
+        while (game->turn != player->me) pthread_cond_wait(&game->turned, &game->lock);
+        game->turn = !player->me;
+        pthread_cond_signal(&game->turned);
+    }
+    pthread_mutex_unlock(&game->lock);
+    return NULL;
+}
+
+static void *emptyThreadBody(void *arg) {
+    return arg;
+}
+
+static int *errnoOfThread(void) {
+    return &errno;
+}
+
+/**
+ * @brief Finds errno anew at every call, like a library function would: a plain
+ * errno read may reuse the address of the kernel thread the caller ran on before.
+ */
+static int *(*volatile errno_location)(void) = errnoOfThread;
+static pthread_t (*volatile thread_id)(void) = pthread_self;  /**< Same for the kernel thread. */
+
+static void errnoBody(void *arg) {
+    ErrnoProbe *probe = (ErrnoProbe*)arg;
+    pthread_t last = thread_id();
+    *errno_location() = probe->value;
+    for (int i = 0; i < ERRNO_CHECKS; i++) {
+        spin(probe->iterations);
+        if (*errno_location() != probe->value) {
+            probe->mismatches++;
+            *errno_location() = probe->value;
+        }
+        if (!pthread_equal(thread_id(), last)) {
+            probe->migrations++;
+            last = thread_id();
+        }
+    }
+}
+
+/**
+ * @brief Prints one row of the workload table (without switch counts if rt is NULL).
+ */
+static void printRow(const char *runtime, const char *policy, int tasks, double elapsed_ms, MetricSummary tat,
+                     MetricSummary resp, const GreenRuntime *rt) {
+    printf("%-9s %-30s %9.1f %10.0f %10.0f %10.0f %10.0f", runtime, policy, elapsed_ms,
+           tasks / (elapsed_ms / 1000.0), tat.mean, tat.p99, resp.mean);
+    if (rt) printf(" %9lld %9lld\n", rt->switches, rt->preemptions); else printf(" %9s %9s\n", "-", "-");
+}
+
+/**
+ * @brief Runs the workload as green threads under one policy.
+ * @return 0 on success, -1 on failure.
+ */
+static int runGreen(const Policy *policy, GreenTask tasks[], int num_tasks, const PolicyParams *params,
+                    const GreenConfig *config) {
+    GreenRuntime rt;
+    GreenConfig sized = *config;
+    sized.capacity = num_tasks;
+    if (greenInit(&rt, policy, params, &sized) != 0) return -1;
+    for (int i = 0; i < num_tasks; i++) {
+        if (greenSpawn(&rt, greenTaskBody, &tasks[i], tasks[i].burst_us, tasks[i].priority) == -1) {
+            printf("Unable to spawn green thread %d\n", i);
+            greenFree(&rt);
+            return -1;
+        }
+    }
+    int status = greenRun(&rt);
+    printRow("green", policy->title, num_tasks, rt.elapsed_ms, sketchSummary(&rt.turnaround),
+             sketchSummary(&rt.response), &rt);
+    greenFree(&rt);
+    return status;
+}
+
+/**
+ * @brief Runs the workload as one pthread per task, scheduled by the kernel.
+ * @return 0 on success, -1 on failure.
+ */
+static int runPthreads(GreenTask tasks[], int num_tasks) {
+    pthread_t *threads = (pthread_t*)malloc(num_tasks * sizeof(pthread_t));
+    pthread_attr_t attr;
+    QuantileSketch tat, resp;
+    int created = 0;
+
+    if (!threads) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, GREEN_STACK);
+    double start = nowMs();
+    while (created < num_tasks && pthread_create(&threads[created], &attr, pthreadTaskBody, &tasks[created]) == 0) {
+        created++;
+    }
+    for (int i = 0; i < created; i++) pthread_join(threads[i], NULL);
+    double elapsed = nowMs() - start;
+    pthread_attr_destroy(&attr);
+    free(threads);
+    if (created < num_tasks) {
+        printf("Unable to create pthread %d\n", created);
+        return -1;
+    }
+
+    sketchInit(&tat);
+    sketchInit(&resp);
+    for (int i = 0; i < num_tasks; i++) {
+        sketchAdd(&tat, (int)((tasks[i].finished - start) * 1000.0));
+        sketchAdd(&resp, (int)((tasks[i].started - start) * 1000.0));
+    }
+    printRow("pthreads", "Kernel scheduler", num_tasks, elapsed, sketchSummary(&tat), sketchSummary(&resp), NULL);
+    return 0;
+}
+
+/**
+ * @brief Measures a switch between two threads: green threads yielding to each
+ * other on one worker, against pthreads handing off through a condition variable.
+ */
+static void benchSwitch(long long rounds, const PolicyParams *params) {
+    GreenConfig config = { 1, 0, GREEN_STACK, 2 };
+    GreenRuntime rt;
+    PingPong game = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, rounds };
+    PingPongPlayer players[2] = { { &game, 0 }, { &game, 1 } };
+    pthread_t threads[2];
+
+    printf("\nContext switch (%lld handoffs each way)\n", rounds);
+    if (greenInit(&rt, findPolicy("rr"), params, &config) == 0) {
+        greenSpawn(&rt, yieldBody, &rounds, 1, 0);
+        greenSpawn(&rt, yieldBody, &rounds, 1, 0);
+        greenRun(&rt);
+        printf("  green yield:      %8.1f ns per switch (%lld dispatches)\n",
+               rt.elapsed_ms * 1e6 / rt.dispatches, rt.dispatches);
+        greenFree(&rt);
+    }
+
+    double start = nowMs();
+    if (pthread_create(&threads[0], NULL, pingPongBody, &players[0]) == 0) {
+        if (pthread_create(&threads[1], NULL, pingPongBody, &players[1]) == 0) {
+            pthread_join(threads[1], NULL);
+            pthread_join(threads[0], NULL);
+            printf("  pthread condvar:  %8.1f ns per switch\n", (nowMs() - start) * 1e6 / (2 * rounds));
+        } else {
+            game.rounds = 0;
+            pthread_join(threads[0], NULL);
+        }
+    }
+}
+
+/**
+ * @brief Measures creating, running and reaping empty threads.
+ */
+static void benchSpawn(int count, const PolicyParams *params) {
+    GreenConfig config = { 1, 0, GREEN_STACK, count };
+    GreenRuntime rt;
+    pthread_t thread;
+
+    printf("\nThread lifecycle (%d empty threads)\n", count);
+    double start = nowMs();
+    if (greenInit(&rt, findPolicy("fcfs"), params, &config) == 0) {
+        for (int i = 0; i < count; i++) greenSpawn(&rt, emptyBody, NULL, 1, 0);
+        greenRun(&rt);
+        printf("  green spawn+run:  %10.0f threads/s\n", count / ((nowMs() - start) / 1000.0));
+        greenFree(&rt);
+    }
+
+    start = nowMs();
+    int created = 0;
+    for (; created < count && pthread_create(&thread, NULL, emptyThreadBody, NULL) == 0; created++) {
+        pthread_join(thread, NULL);
+    }
+    printf("  pthread create+join: %7.0f threads/s\n", created / ((nowMs() - start) / 1000.0));
+}
+
+/**
+ * @brief Checks that preempted green threads keep their errno, also when they
+ * resume on another kernel thread: each sets its own value, then spins across
+ * many slices checking it.
+ * @return 0 if no thread lost its errno, -1 otherwise.
+ */
+static int checkErrno(int workers, int tick, const PolicyParams *params, double per_us) {
+    GreenConfig config = { workers, tick, GREEN_STACK, ERRNO_THREADS };
+    GreenRuntime rt;
+    ErrnoProbe probes[ERRNO_THREADS];
+    int mismatches = 0, migrations = 0;
+
+    if (greenInit(&rt, findPolicy("rr"), params, &config) != 0) return -1;
+    for (int i = 0; i < ERRNO_THREADS; i++) {
+        probes[i] = (ErrnoProbe){ 1000 + i, (long long)(params->quantum * per_us / 20), 0, 0 };
+        greenSpawn(&rt, errnoBody, &probes[i], params->quantum * ERRNO_CHECKS / 20, 0);
+    }
+    greenRun(&rt);
+    for (int i = 0; i < ERRNO_THREADS; i++) {
+        mismatches += probes[i].mismatches;
+        migrations += probes[i].migrations;
+    }
+    printf("\nerrno across preemption (%d threads, %d workers): %lld preemptions, %d migrations, %d lost errno\n",
+           ERRNO_THREADS, workers, rt.preemptions, migrations, mismatches);
+    greenFree(&rt);
+    return mismatches == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Main function of the green-thread benchmark.
+ * - Usage: ./schedule_green_exec [-n tasks] [-u us_per_unit] [-w workers] [-q quantum_us] [-t tick_us]
+ *          [-p policy] [-s switch_rounds] [-b bursts] [-e]
+ * - Generates -n tasks (default 1000) with the benchmark's burst and priority
+ *   distributions, one burst unit lasting -u microseconds (default 50) of spinning,
+ *   and runs them all released at once: as green threads dispatched by FCFS,
+ *   SJF, priority and RR (or only -p) on -w worker kernel threads, then as one
+ *   pthread each under the kernel's scheduler.
+ * - Then measures the cost of a context switch and of a thread's lifecycle for
+ *   both.
+ * - With -e, only checks that green threads keep their errno when preempted
+ *   and moved between -w workers (at least 2); exits with 1 if one lost it.
+ */
+int main(int argc, char *argv[]) {
+    const char *names[GREEN_RUNTIMES] = { "fcfs", "sjf", "priority", "rr" };
+    const char *only = NULL;
+    int num_tasks = 1000, unit_us = 50, workers = 1, quantum = 1000, tick = 500, check_errno = 0, opt;
+    long long rounds = 1000000;
+    BurstDistribution bursts = BURST_EXPONENTIAL;
+
+    while ((opt = getopt(argc, argv, "n:u:w:q:t:p:s:b:e")) != -1) {
+        if (opt == 'n') {
+            num_tasks = atoi(optarg);
+        } else if (opt == 'u') {
+            unit_us = atoi(optarg);
+        } else if (opt == 'w') {
+            workers = atoi(optarg);
+        } else if (opt == 'q') {
+            quantum = atoi(optarg);
+        } else if (opt == 't') {
+            tick = atoi(optarg);
+        } else if (opt == 'p') {
+            only = optarg;
+        } else if (opt == 's') {
+            rounds = atoll(optarg);
+        } else if (opt == 'b' && strcmp(optarg, "pareto") == 0) {
+            bursts = BURST_PARETO;
+        } else if (opt == 'b' && strcmp(optarg, "exponential") == 0) {
+            bursts = BURST_EXPONENTIAL;
+        } else if (opt == 'e') {
+            check_errno = 1;
+        } else {
+            printf("Usage: %s [-n tasks] [-u us_per_unit] [-w workers] [-q quantum_us] [-t tick_us]\n"
+                   "       [-p policy] [-s switch_rounds] [-b exponential|pareto] [-e]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (num_tasks < 1 || unit_us < 1 || workers < 1 || workers > GREEN_MAX_WORKERS || quantum < 1 || tick < 0 ||
+        rounds < 1) {
+        printf("Invalid tasks, unit, workers, quantum, tick or switch rounds\n");
+        return 1;
+    }
+    if (only && !findPolicy(only)) {
+        printf("Unknown policy: %s\n", only);
+        return 1;
+    }
+
+    if (check_errno) {
+        PolicyParams params = defaultPolicyParams(quantum);
+        return checkErrno(workers < 2 ? 2 : workers, tick > 0 ? tick : 500, &params, calibrateSpin()) == 0 ? 0 : 1;
+    }
+
+    WorkloadSpec spec = defaultWorkloadSpec(num_tasks, bursts, GREEN_SEED);
+    Process *proc;
+    if (generateWorkload(&spec, &proc) != 0) return 1;
+    GreenTask *tasks = (GreenTask*)calloc(num_tasks, sizeof(GreenTask));
+    if (!tasks) {
+        printf("Memory allocation failed\n");
+        free(proc);
+        return 1;
+    }
+    double per_us = calibrateSpin();
+    long long total_us = 0;
+    for (int i = 0; i < num_tasks; i++) {
+        tasks[i].burst_us = proc[i].burst_time * unit_us;
+        tasks[i].iterations = (long long)(tasks[i].burst_us * per_us);
+        tasks[i].priority = proc[i].priority;
+        total_us += tasks[i].burst_us;
+    }
+    free(proc);
+
+    PolicyParams params = defaultPolicyParams(quantum);
+    GreenConfig config = { workers, tick, GREEN_STACK, num_tasks };
+    printf("%d tasks, %.1f ms of CPU work, %d worker(s), quantum %d us, tick %d us\n", num_tasks, total_us / 1000.0,
+           workers, quantum, tick);
+    printf("%-9s %-30s %9s %10s %10s %10s %10s %9s %9s\n", "Runtime", "Policy", "Wall ms", "Tasks/s", "Avg TAT",
+           "P99 TAT", "Avg Resp", "Switches", "Preempts");
+    int status = 0;
+    for (int i = 0; i < GREEN_RUNTIMES && !only; i++) {
+        if (runGreen(findPolicy(names[i]), tasks, num_tasks, &params, &config) != 0) status = 1;
+    }
+    if (only && runGreen(findPolicy(only), tasks, num_tasks, &params, &config) != 0) status = 1;
+    if (runPthreads(tasks, num_tasks) != 0) status = 1;
+    printf("(TAT and response in microseconds from the release of the tasks)\n");
+    free(tasks);
+
+    benchSwitch(rounds, &params);
+    benchSpawn(100000, &params);
+    return status;
+}
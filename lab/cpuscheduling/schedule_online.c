@@ -0,0 +1,168 @@
+#include <string.h>
+#include <unistd.h>
+#include "generator.h"
+#include "online.h"
+#include "workload.h"
+
+#define ONLINE_SEED 20240601ULL    /**< Default seed of the generated workload (same as the benchmark). */
+#define ONLINE_CHUNK 4096          /**< Processes read from a workload file at a time. */
+
+/**
+ * @struct OnlineFeed
+ * @brief Source of streamed processes: a workload file read in chunks, or a generator.
+ */
+typedef struct {
+  WorkloadReader reader;        /**< Workload file, if one was given. */
+  WorkloadGenerator gen;        /**< Generated workload otherwise. */
+  int from_file;                /**< 1 to read from reader. */
+  Process chunk[ONLINE_CHUNK];  /**< Processes read but not yet submitted. */
+  int count;                    /**< Entries in chunk. */
+  int next;                     /**< Next entry of chunk to submit. */
+} OnlineFeed;
+
+/**
+ * @brief Takes the next process from the feed.
+ * @return 1 if a process was read, 0 at the end, -1 on a malformed record.
+ */
+static int feedNext(OnlineFeed *feed, Process *p) {
+    if (!feed->from_file) return generatorNext(&feed->gen, p);
+    if (feed->next == feed->count) {
+        feed->count = workloadRead(&feed->reader, feed->chunk, ONLINE_CHUNK);
+        feed->next = 0;
+        if (feed->count <= 0) return feed->count;
+    }
+    *p = feed->chunk[feed->next++];
+    return 1;
+}
+
+/**
+ * @brief Prints one progress line: completions so far and the processes alive now.
+ */
+static void printProgress(OnlineScheduler *sched, int time) {
+    SimResult r;
+    onlineSummary(sched, &r);
+    printf("Time %d: %lld completed, %d live, avg response %.2f, p99 response %.0f\n", time, sched->completed,
+           sched->live, r.response.mean, r.response.p99);
+}
+
+/**
+ * @brief Main function of the online scheduler demo.
+ * - Usage: ./schedule_online_exec [-w workload_file | -n processes [-b exponential|pareto] [-s seed]]
+ *          [-p policy] [-q quantum] [-k switch_cost] [-d dispatch_cost] [-c capacity] [-r interval]
+ * - Streams the processes into an OnlineScheduler in arrival order, advancing
+ *   the run to each arrival before submitting it, so the whole workload is
+ *   never held in memory: only -c slots (default 65536) of live processes.
+ * - Workload files must be sorted by arrival time; their burst lists are
+ *   collapsed into single CPU bursts. Without -w, a generated workload of -n
+ *   processes (default 1000000) is streamed.
+ * - -r prints a progress line every `interval` time units of simulated time.
+ */
+int main(int argc, char *argv[]) {
+    const char *workload_path = NULL;
+    const Policy *policy = findPolicy("rr");
+    BurstDistribution bursts = BURST_EXPONENTIAL;
+    uint64_t seed = ONLINE_SEED;
+    int num_processes = 1000000, quantum = 4, switch_cost = 0, dispatch_cost = 0, capacity = 65536;
+    int interval = 0, opt;
+
+    while ((opt = getopt(argc, argv, "w:n:b:s:p:q:k:d:c:r:")) != -1) {
+        if (opt == 'w') {
+            workload_path = optarg;
+        } else if (opt == 'n') {
+            num_processes = atoi(optarg);
+        } else if (opt == 'b' && strcmp(optarg, "exponential") == 0) {
+            bursts = BURST_EXPONENTIAL;
+        } else if (opt == 'b' && strcmp(optarg, "pareto") == 0) {
+            bursts = BURST_PARETO;
+        } else if (opt == 's') {
+            seed = strtoull(optarg, NULL, 10);
+        } else if (opt == 'p') {
+            if (!(policy = findPolicy(optarg))) {
+                printf("Unknown policy: %s\n", optarg);
+                return 1;
+            }
+        } else if (opt == 'q') {
+            quantum = atoi(optarg);
+        } else if (opt == 'k') {
+            switch_cost = atoi(optarg);
+        } else if (opt == 'd') {
+            dispatch_cost = atoi(optarg);
+        } else if (opt == 'c') {
+            capacity = atoi(optarg);
+        } else if (opt == 'r') {
+            interval = atoi(optarg);
+        } else {
+            printf("Usage: %s [-w workload_file | -n processes [-b exponential|pareto] [-s seed]]\n"
+                   "       [-p policy] [-q quantum] [-k switch_cost] [-d dispatch_cost] [-c capacity] [-r interval]\n",
+                   argv[0]);
+            return 1;
+        }
+    }
+    if (quantum <= 0 || switch_cost < 0 || dispatch_cost < 0 || interval < 0) {
+        printf("Invalid quantum, switch cost, dispatch cost or interval\n");
+        return 1;
+    }
+
+    static OnlineFeed feed;
+    if (workload_path) {
+        if (workloadOpen(&feed.reader, workload_path) != 0) return 1;
+        feed.from_file = 1;
+    } else {
+        WorkloadSpec spec = defaultWorkloadSpec(num_processes, bursts, seed);
+        if (generatorInit(&feed.gen, &spec) != 0) return 1;
+    }
+
+    OnlineScheduler sched;
+    PolicyParams params = defaultPolicyParams(quantum);
+    params.switch_cost = switch_cost;
+    params.dispatch_cost = dispatch_cost;
+    if (onlineInit(&sched, policy, &params, capacity) != 0) {
+        if (feed.from_file) workloadClose(&feed.reader); else generatorFree(&feed.gen);
+        return 1;
+    }
+
+    // Each process is submitted once the run has reached its arrival; completions are drained as they come.
+    long long completions = 0;
+    int peak = 0, status = 0, next_report = interval, got, count;
+    Process p;
+    double start = wallClockMs();
+    while (status == 0 && (got = feedNext(&feed, &p)) == 1) {
+        while (interval && next_report <= p.arrival_time && status == 0) {
+            status = onlineAdvance(&sched, next_report);
+            printProgress(&sched, next_report);
+            next_report = next_report <= INT_MAX - interval ? next_report + interval : INT_MAX;
+        }
+        if (status == 0) status = onlineAdvance(&sched, p.arrival_time);
+        onlineCompletions(&sched, &count);
+        completions += count;
+        if (status == 0 && onlineSubmit(&sched, &p) != 0) {
+            if (sched.live == capacity) {
+                printf("More than %d processes alive at time %d; raise -c\n", capacity, p.arrival_time);
+            } else {
+                printf("Process %d arrives at %d, before the previous one: the workload must be sorted by arrival\n",
+                       p.process_id, p.arrival_time);
+            }
+            status = -1;
+        }
+        if (sched.live > peak) peak = sched.live;
+    }
+    if (got == -1) status = -1;
+    if (status == 0) status = onlineAdvance(&sched, INT_MAX);
+    onlineCompletions(&sched, &count);
+    completions += count;
+    double elapsed = wallClockMs() - start;
+
+    SimResult r;
+    onlineSummary(&sched, &r);
+    printf("\n%s over %lld streamed processes (%lld completed, peak %d of %d slots live) in %.2f ms\n",
+           policy->title, sched.submitted, completions, peak, capacity, elapsed);
+    printf("%10s %10s %10s %10s %10s %10s %9s %6s %10s\n", "Avg Wait", "P99 Wait", "Avg TAT", "Avg Resp",
+           "P99 Resp", "Max Wait", "Makespan", "CPU %", "Switches");
+    printf("%10.2f %10.0f %10.2f %10.2f %10.0f %10.0f %9d %6.1f %10lld\n", r.waiting.mean, r.waiting.p99,
+           r.turnaround.mean, r.response.mean, r.response.p99, r.waiting.max, r.makespan, 100.0 * r.utilization,
+           r.context_switches);
+
+    onlineFree(&sched);
+    if (feed.from_file) workloadClose(&feed.reader); else generatorFree(&feed.gen);
+    return status == 0 ? 0 : 1;
+}
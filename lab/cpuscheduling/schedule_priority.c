@@ -1,76 +1,53 @@
-#include "process.h"
-
-/**
- * @brief Finds the highest-priority available process.
- * - For both non-preemptive and preemptive priority scheduling, selects the process
- *   with the highest priority (lowest priority number) among those that have arrived.
- *
- * @param proc Array of processes.
- * @param num_processes Number of processes.
- * @param time Current system time.
- * @return Index of the selected process, or -1 if no process is available.
- */
-int findHighestPriorityProcess(Process proc[], int num_processes, int time) {
-    int min_index = -1;
-
-    for (int i = 0; i < num_processes; i++) {
-        if (proc[i].arrival_time <= time && proc[i].remaining_time > 0) {
-            // For both non-preemptive and preemptive, select the process with the lowest priority number.
-            if (min_index == -1 || proc[i].priority < proc[min_index].priority) {
-                min_index = i;
-            }
-        }
-    }
-    return min_index;
-}
+#include <unistd.h>
+#include "ready_queue.h"
+#include "gantt.h"
+#include "workload.h"
+#include "trace.h"
 
 /**
  * @brief Executes the selected process for Priority Scheduling.
  * - Updates execution log and Gantt Chart.
- * - For preemptive scheduling, the process runs for 1 time unit;
- *   for non-preemptive scheduling, the process runs to completion.
- * - In preemptive mode, the "Process starts" message is printed only when switching to a new process.
+ * - For preemptive scheduling, the process runs until it completes or the next
+ *   arrival, whichever comes first; for non-preemptive scheduling, it runs to completion.
+ * - In preemptive mode, the "Process starts" event is logged only when switching to a new process.
  *
  * @param proc Array of processes.
  * @param index Index of the selected process.
  * @param time Pointer to current time.
- * @param gantt_chart Array storing execution order.
- * @param gc_index Pointer to Gantt chart index.
+ * @param gantt Gantt chart receiving the executed slice.
  * @param preemptive Boolean flag (1 = preemptive, 0 = non-preemptive).
+ * @param until Time of the next arrival (used in preemptive mode).
  * @param last_index Pointer to variable tracking the index of the last executed process.
  */
-void executeProcessPriority(Process proc[], int index, int *time, int gantt_chart[], int *gc_index, int preemptive, int *last_index) {
+void executeProcessPriority(Process proc[], int index, int *time, GanttChart *gantt, int preemptive,
+                            int until, int *last_index) {
     if (preemptive) {
-        // In preemptive scheduling, print "Process starts" only if switching to a new process.
+        // In preemptive scheduling, log "Process starts" only if switching to a new process.
         if (*last_index != index) {
-            printf("Time %d: Process %d starts (Burst time: %d) (Priority: %d)\n",
-                   *time, proc[index].process_id, proc[index].remaining_time, proc[index].priority);
+            LOG_EVENT(TRACE_START_PRIORITY, *time, proc[index].process_id, proc[index].remaining_time,
+                      proc[index].priority);
             *last_index = index;  // Update the last executed process index.
-
-            // Log the process in the Gantt chart.
-            gantt_chart[(*gc_index)++] = proc[index].process_id;
         }
 
     } else {
-        // In non-preemptive scheduling, the process runs to completion so we always print the start message.
-        printf("Time %d: Process %d starts (Burst time: %d) (Priority: %d)\n",
-               *time, proc[index].process_id, proc[index].remaining_time, proc[index].priority);
-
-        // Log the process in the Gantt chart.
-        gantt_chart[(*gc_index)++] = proc[index].process_id;
+        // In non-preemptive scheduling, the process runs to completion so we always log the start.
+        LOG_EVENT(TRACE_START_PRIORITY, *time, proc[index].process_id, proc[index].remaining_time,
+                  proc[index].priority);
     }
 
 
 
-    // Determine execution time: 1 unit if preemptive, full burst time otherwise.
-    int execution_time = (preemptive) ? 1 : proc[index].burst_time;
+    // Determine execution time: up to the next arrival if preemptive, full burst time otherwise.
+    int execution_time = proc[index].remaining_time;
+    if (preemptive && until - *time < execution_time) execution_time = until - *time;
     proc[index].remaining_time -= execution_time;
     *time += execution_time;
+    ganttRecord(gantt, proc[index].process_id, *time - execution_time, *time);
 
-    // If process completes execution, print the completion message.
+    // If process completes execution, log its completion.
     if (proc[index].remaining_time == 0) {
         proc[index].completion_time = *time;
-        printf("Time %d: Process %d completes\n", *time, proc[index].process_id);
+        LOG_EVENT(TRACE_COMPLETE, *time, proc[index].process_id, 0, 0);
     }
 }
 
@@ -80,114 +57,197 @@ void executeProcessPriority(Process proc[], int index, int *time, int gantt_char
  *
  * @param proc Array of processes.
  * @param num_processes Number of processes.
+ * @param gantt Gantt chart to record into.
  */
-void priorityScheduling(Process proc[], int num_processes) {
+void priorityScheduling(Process proc[], int num_processes, GanttChart *gantt) {
     int time = 0, completed = 0;
-    int gantt_chart[100], gc_index = 0;
     int last_index = -1;  // Not used in non-preemptive mode, but passed for uniformity.
+    int *order = sortByArrival(proc, num_processes), next = 0;
+    ReadyQueue ready;
 
-    printf("\n=== Priority Scheduling (Non-Preemptive) ===\n");
+    if (!order || readyQueueInit(&ready, proc, num_processes, KEY_PRIORITY) != 0) {
+        printf("Memory allocation failed\n");
+        free(order);
+        return;
+    }
+
+    LOG_EVENT(TRACE_BEGIN, time, 0, TRACE_PRIORITY, 0);
 
     while (completed < num_processes) {
-        int index = findHighestPriorityProcess(proc, num_processes, time);
+        // Arrived processes wait in a min-heap keyed by priority number.
+        next = admitArrivals(&ready, order, num_processes, next, time);
+        int index = readyQueuePop(&ready);
         if (index != -1) {
-            executeProcessPriority(proc, index, &time, gantt_chart, &gc_index, 0, &last_index);
+            executeProcessPriority(proc, index, &time, gantt, 0, INT_MAX, &last_index);
             completed++; // Process runs to completion.
         } else {
-            time++; // Advance time if no process is available.
+            time = nextArrival(proc, order, num_processes, next); // CPU idle: jump to the next arrival.
         }
     }
 
+    readyQueueFree(&ready);
+    free(order);
+
     // Print Gantt Chart Execution Order.
-    printf("\nGantt Chart Execution Order (Priority Non-Preemptive):\n");
-    for (int i = 0; i < gc_index; i++) {
-        printf("P%d ", gantt_chart[i]);
-    }
-    printf("\n");
+    if (LOG_ENABLED(LOG_SUMMARY)) ganttPrint(gantt); else ganttFlush(gantt);
 }
 
 /**
  * @brief Implements Preemptive Priority Scheduling.
  * - If a new process arrives with a higher priority, it preempts the current process.
  * - Additionally, if switching from one process to another, and the previous process is not yet finished,
- *   prints a "completes quantum" message for the previous process.
+ *   logs a "completes quantum" event for the previous process.
  *
  * @param proc Array of processes.
  * @param num_processes Number of processes.
+ * @param gantt Gantt chart to record into.
  */
-void priorityPreemptiveScheduling(Process proc[], int num_processes) {
+void priorityPreemptiveScheduling(Process proc[], int num_processes, GanttChart *gantt) {
     int time = 0, completed = 0;
-    int gantt_chart[100], gc_index = 0;
     int last_index = -1;  // Track the index of the last process that was executed.
+    int *order = sortByArrival(proc, num_processes), next = 0;
+    int running = -1;     // Index of the process that ran last and is not finished.
+    ReadyQueue ready;
+
+    if (!order || readyQueueInit(&ready, proc, num_processes, KEY_PRIORITY) != 0) {
+        printf("Memory allocation failed\n");
+        free(order);
+        return;
+    }
 
-    printf("\n=== Priority Scheduling (Preemptive) ===\n");
+    LOG_EVENT(TRACE_BEGIN, time, 0, TRACE_PRIORITY_PREEMPTIVE, 0);
 
     while (completed < num_processes) {
-        int index = findHighestPriorityProcess(proc, num_processes, time);
+        // The running process competes with the new arrivals again at every arrival or completion.
+        next = admitArrivals(&ready, order, num_processes, next, time);
+        if (running != -1) readyQueuePush(&ready, running);
+        int index = readyQueuePop(&ready);
         if (index != -1) {
             // If switching from a previous process (that hasn't finished) to a new one,
-            // print "completes quantum" for the previous process.
+            // log "completes quantum" for the previous process.
             if (last_index != -1 && last_index != index && proc[last_index].remaining_time > 0) {
-                printf("Time %d: Process %d completes quantum\n", time, proc[last_index].process_id);
+                LOG_EVENT(TRACE_QUANTUM, time, proc[last_index].process_id, 0, 0);
             }
-            executeProcessPriority(proc, index, &time, gantt_chart, &gc_index, 1, &last_index);
+            executeProcessPriority(proc, index, &time, gantt, 1,
+                                   nextArrival(proc, order, num_processes, next), &last_index);
             if (proc[index].remaining_time == 0) {
                 completed++;
+                running = -1;
+            } else {
+                running = index;
             }
         } else {
-            time++; // Advance time if no process is available.
+            time = nextArrival(proc, order, num_processes, next); // CPU idle: jump to the next arrival.
         }
     }
 
+    readyQueueFree(&ready);
+    free(order);
+
     // Print Gantt Chart Execution Order.
-    printf("\nGantt Chart Execution Order (Priority Preemptive):\n");
-    for (int i = 0; i < gc_index; i++) {
-        printf("P%d ", gantt_chart[i]);
-    }
-    printf("\n");
+    if (LOG_ENABLED(LOG_SUMMARY)) ganttPrint(gantt); else ganttFlush(gantt);
 }
 
 /**
  * @brief Main function for Priority Scheduling.
+ * - Usage: ./schedule_priority_exec [-w workload_file] [-g gantt_file]
+ *          [-l quiet|summary|events] [-t trace_file]
+ * - -w loads the workload from a CSV or binary file (see workload.h); load time
+ *   and scheduling time are reported separately. Without -w, the built-in example runs.
+ * - -g streams the Gantt chart to a file instead of keeping it in memory.
+ * - -l selects the output: quiet (times only), summary (no per-event lines) or
+ *   events (default). Building with -DSCHED_LOG_LEVEL=LOG_QUIET removes the
+ *   logging code altogether (see trace.h).
+ * - -t writes every event to a binary trace file, whatever the output level;
+ *   trace_render_exec turns it back into the event log.
  */
-int main() {
-    int input[][4] = {
-        {1, 0, 8, 3},  /* {process_id, arrival_time, burst_time, priority} */
-        {2, 1, 4, 1},
-        {3, 2, 9, 4},
-        {4, 3, 5, 2}
-    };
-
-    int num_processes = sizeof(input) / sizeof(input[0]);
-    Process* proc = (Process*)malloc(num_processes * sizeof(Process));
-
-    // Non-preemptive Priority Scheduling: Initialize processes.
-    for (int i = 0; i < num_processes; i++) {
-        initializeProcess(&proc[i]);
-        proc[i].process_id = input[i][0];
-        proc[i].arrival_time = input[i][1];
-        proc[i].burst_time = input[i][2];
-        proc[i].priority = input[i][3];
-        proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set.
+int main(int argc, char *argv[]) {
+    const char *gantt_path = NULL, *workload_path = NULL, *trace_path = NULL;
+    static TraceWriter trace;
+    FILE *gantt_out = NULL;
+    GanttChart gantt;
+    Process *proc = NULL;
+    int num_processes = 0, opt;
+
+    while ((opt = getopt(argc, argv, "w:g:l:t:")) != -1) {
+        if (opt == 'w') {
+            workload_path = optarg;
+        } else if (opt == 'g') {
+            gantt_path = optarg;
+        } else if (opt == 'l' && parseLogLevel(optarg) != -1) {
+            log_level = parseLogLevel(optarg);
+        } else if (opt == 't') {
+            trace_path = optarg;
+        } else {
+            printf("Usage: %s [-w workload_file] [-g gantt_file]\n"
+                   "       [-l quiet|summary|events] [-t trace_file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (gantt_path && !(gantt_out = fopen(gantt_path, "w"))) {
+        perror("Unable to open Gantt chart file");
+        return 1;
+    }
+    if (trace_path) {
+        if (traceOpen(&trace, trace_path) != 0) return 1;
+        event_trace = &trace;
     }
 
-    priorityScheduling(proc, num_processes);
-    printProcesses(proc, num_processes);
+    if (workload_path) {
+        double load_start = wallClockMs();
+        if (workloadLoad(workload_path, &proc, &num_processes) != 0) return 1;
+        printf("Loaded %d processes from %s in %.2f ms\n", num_processes, workload_path, wallClockMs() - load_start);
+    } else {
+        int input[][4] = {
+            {1, 0, 8, 3},  /* {process_id, arrival_time, burst_time, priority} */
+            {2, 1, 4, 1},
+            {3, 2, 9, 4},
+            {4, 3, 5, 2}
+        };
+
+        num_processes = sizeof(input) / sizeof(input[0]);
+        proc = (Process*)malloc(num_processes * sizeof(Process));
+
+        // Initialize processes.
+        for (int i = 0; i < num_processes; i++) {
+            initializeProcess(&proc[i]);
+            proc[i].process_id = input[i][0];
+            proc[i].arrival_time = input[i][1];
+            proc[i].burst_time = input[i][2];
+            proc[i].priority = input[i][3];
+            proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set.
+        }
+    }
+
+    double start = wallClockMs();
+    ganttInit(&gantt, "Priority Non-Preemptive", gantt_out);
+    priorityScheduling(proc, num_processes, &gantt);
+    ganttFree(&gantt);
+    if (workload_path) printf("Scheduling time: %.2f ms\n", wallClockMs() - start);
+    if (LOG_ENABLED(LOG_SUMMARY)) printProcesses(proc, num_processes);
 
     // Reset processes for Preemptive Priority Scheduling.
-    for (int i = 0; i < num_processes; i++) {
-        initializeProcess(&proc[i]);
-        proc[i].process_id = input[i][0];
-        proc[i].arrival_time = input[i][1];
-        proc[i].burst_time = input[i][2];
-        proc[i].priority = input[i][3];
-        proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set.
+    workloadReset(proc, num_processes);
+
+    start = wallClockMs();
+    ganttInit(&gantt, "Priority Preemptive", gantt_out);
+    priorityPreemptiveScheduling(proc, num_processes, &gantt);
+    ganttFree(&gantt);
+    if (workload_path) printf("Scheduling time: %.2f ms\n", wallClockMs() - start);
+    if (LOG_ENABLED(LOG_SUMMARY)) printProcesses(proc, num_processes);
+
+    int status = 0;
+    if (event_trace) {
+        long long events = trace.total;
+        if (traceClose(&trace) != 0) {
+            printf("Unable to write trace file %s\n", trace_path);
+            status = 1;
+        } else {
+            printf("Traced %lld events to %s\n", events, trace_path);
+        }
     }
 
-    // Preemptive Priority Scheduling.
-    priorityPreemptiveScheduling(proc, num_processes);
-    printProcesses(proc, num_processes);
-
     free(proc);
-    return 0;
-}
\ No newline at end of file
+    if (gantt_out) fclose(gantt_out);
+    return status;
+}
@@ -1,39 +1,40 @@
-#include "process.h"
+#include <getopt.h>
+#include "ready_queue.h"
+#include "gantt.h"
+#include "workload.h"
+#include "trace.h"
 
 /**
  * @brief Executes one quantum slice of the selected process for Round Robin scheduling.
  * - Uses a **fixed time quantum** for execution.
  * - Updates the execution log and Gantt Chart.
- * - Prints the "Process starts" message only when switching to a new process.
- * - Does not print the "completes quantum" message.
+ * - Logs the "Process starts" event only when switching to a new process.
+ * - Does not log the "completes quantum" event.
  *
  * @param proc Array of processes.
  * @param index Index of the selected process.
  * @param time Pointer to the current time.
  * @param quantum Time quantum for Round Robin.
- * @param gantt_chart Array storing the execution order.
- * @param gc_index Pointer to the current Gantt Chart index.
+ * @param gantt Gantt chart receiving the executed slice.
  * @param last_index Pointer to the variable storing the index of the last process that executed.
  */
-void executeRoundRobin(Process proc[], int index, int *time, int quantum, int gantt_chart[], int *gc_index, int *last_index) {
-    // Print "Process starts" message only if switching to a new process.
+void executeRoundRobin(Process proc[], int index, int *time, int quantum, GanttChart *gantt, int *last_index) {
+    // Log "Process starts" only if switching to a new process.
     if (*last_index != index) {
-        printf("Time %d: Process %d starts, (Burst time: %d)\n", *time, proc[index].process_id, proc[index].remaining_time);
+        LOG_EVENT(TRACE_START, *time, proc[index].process_id, proc[index].remaining_time, 0);
         *last_index = index;  // Update last_index to the current process index.
-
-        // Log the execution in the Gantt chart.
-        gantt_chart[(*gc_index)++] = proc[index].process_id;
     }
 
     // Execute for the time quantum or until the process completes.
     int execution_time = (proc[index].remaining_time > quantum) ? quantum : proc[index].remaining_time;
     proc[index].remaining_time -= execution_time;
     *time += execution_time;
+    ganttRecord(gantt, proc[index].process_id, *time - execution_time, *time);
 
-    // If the process finishes execution, print the completion message.
+    // If the process finishes execution, log its completion.
     if (proc[index].remaining_time == 0) {
         proc[index].completion_time = *time;
-        printf("Time %d: Process %d completes\n", *time, proc[index].process_id);
+        LOG_EVENT(TRACE_COMPLETE, *time, proc[index].process_id, 0, 0);
     }
 }
 
@@ -42,18 +43,18 @@ void executeRoundRobin(Process proc[], int index, int *time, int quantum, int ga
  * - Each process is given a fixed time quantum.
  * - Processes are scanned in the array order on each cycle.
  * - Before switching to a different process, if the previous process has not finished,
- *   prints "completes quantum" for that process.
+ *   logs "completes quantum" for that process.
  *
  * @param proc Array of processes.
  * @param num_processes Number of processes.
  * @param quantum Time quantum for Round Robin.
+ * @param gantt Gantt chart to record into.
  */
-void roundRobinScheduling(Process proc[], int num_processes, int quantum) {
+void roundRobinScheduling(Process proc[], int num_processes, int quantum, GanttChart *gantt) {
     int time = 0, completed = 0;
-    int gantt_chart[100], gc_index = 0;
     int last_index = -1;  // Holds the index of the last process that was executed; initialized to -1 (invalid index).
 
-    printf("\n=== Round Robin Scheduling, Quantum: %d ===\n", quantum);
+    LOG_EVENT(TRACE_BEGIN, time, 0, TRACE_RR, quantum);
 
     // Continue scheduling until all processes have completed.
     while (completed < num_processes) {
@@ -64,55 +65,199 @@ void roundRobinScheduling(Process proc[], int num_processes, int quantum) {
             // Check if process has arrived and is not finished.
             if (proc[i].arrival_time <= time && proc[i].remaining_time > 0) {
                 // If switching from a previous process to a new one,
-                // and the previous process has not yet completed, print "completes quantum".
+                // and the previous process has not yet completed, log "completes quantum".
                 if (last_index != -1 && last_index != i && proc[last_index].remaining_time > 0) {
-                    printf("Time %d: Process %d completes quantum\n", time, proc[last_index].process_id);
+                    LOG_EVENT(TRACE_QUANTUM, time, proc[last_index].process_id, 0, 0);
                 }
                 // Execute one quantum slice for process at index i.
-                executeRoundRobin(proc, i, &time, quantum, gantt_chart, &gc_index, &last_index);
+                executeRoundRobin(proc, i, &time, quantum, gantt, &last_index);
                 executed = 1;  // Mark that at least one process was executed in this cycle.
 
                 // If the process completed during this quantum, count it.
                 if (proc[i].remaining_time == 0) { completed++; }
             }
         }
-        // If no process was executed in this full cycle, simply advance time.
-        if (!executed) { time++; }
+        // If no process was executed in this full cycle, jump to the next arrival.
+        if (!executed) {
+            int next_arrival = INT_MAX;
+            for (int i = 0; i < num_processes; i++) {
+                if (proc[i].remaining_time > 0 && proc[i].arrival_time < next_arrival) next_arrival = proc[i].arrival_time;
+            }
+            time = next_arrival;
+        }
     }
 
-    // Print the final Gantt Chart Execution Order.
-    printf("\nGantt Chart Execution Order (Round Robin):\n");
-    for (int i = 0; i < gc_index; i++) {
-        printf("P%d ", gantt_chart[i]);
+    // Print Gantt Chart Execution Order.
+    if (LOG_ENABLED(LOG_SUMMARY)) ganttPrint(gantt); else ganttFlush(gantt);
+}
+
+/**
+ * @brief Implements Round Robin (RR) Scheduling on a circular FIFO ready queue.
+ * - Processes join the tail of the queue when they arrive, in arrival order.
+ * - The process at the head runs for one quantum; if it is not finished it
+ *   rejoins the tail after the processes that arrived during its quantum.
+ * - Each quantum costs O(1); an idle CPU jumps to the next arrival.
+ * - Logged events and the Gantt chart use the same format as roundRobinScheduling.
+ *
+ * @param proc Array of processes.
+ * @param num_processes Number of processes.
+ * @param quantum Time quantum for Round Robin.
+ * @param gantt Gantt chart to record into.
+ */
+void roundRobinFifoScheduling(Process proc[], int num_processes, int quantum, GanttChart *gantt) {
+    int time = 0, completed = 0;
+    int last_index = -1;  // Holds the index of the last process that was executed.
+    int running = -1;     // Process whose quantum just expired, re-queued after new arrivals.
+    int *order = sortByArrival(proc, num_processes), next = 0;
+    FifoQueue ready;
+
+    if (!order || fifoQueueInit(&ready, num_processes) != 0) {
+        printf("Memory allocation failed\n");
+        free(order);
+        return;
     }
-    printf("\n");
+
+    LOG_EVENT(TRACE_BEGIN, time, 0, TRACE_RR, quantum);
+
+    while (completed < num_processes) {
+        // Processes that arrived during the last quantum queue ahead of the preempted one.
+        while (next < num_processes && proc[order[next]].arrival_time <= time) {
+            fifoQueuePush(&ready, order[next++]);
+        }
+        if (running != -1) {
+            fifoQueuePush(&ready, running);
+            running = -1;
+        }
+
+        int index = fifoQueuePop(&ready);
+        if (index == -1) {
+            time = nextArrival(proc, order, num_processes, next); // CPU idle: jump to the next arrival.
+            continue;
+        }
+
+        // Switching away from an unfinished process ends its quantum.
+        if (last_index != -1 && last_index != index && proc[last_index].remaining_time > 0) {
+            LOG_EVENT(TRACE_QUANTUM, time, proc[last_index].process_id, 0, 0);
+        }
+        executeRoundRobin(proc, index, &time, quantum, gantt, &last_index);
+        if (proc[index].remaining_time == 0) {
+            completed++;
+        } else {
+            running = index;
+        }
+    }
+
+    fifoQueueFree(&ready);
+    free(order);
+
+    // Print Gantt Chart Execution Order.
+    if (LOG_ENABLED(LOG_SUMMARY)) ganttPrint(gantt); else ganttFlush(gantt);
 }
 
 /**
  * @brief Main function for Round Robin Scheduling.
+ * - Usage: ./schedule_rr_exec [--sweep] [-w workload_file] [-g gantt_file]
+ *          [-l quiet|summary|events] [-t trace_file]
+ * - By default the FIFO ready queue is used; --sweep (-s) selects the original
+ *   array-order cycle (roundRobinScheduling).
+ * - -w loads the workload from a CSV or binary file (see workload.h); load time
+ *   and scheduling time are reported separately. Without -w, the built-in example runs.
+ * - -g streams the Gantt chart to a file instead of keeping it in memory.
+ * - -l selects the output: quiet (times only), summary (no per-event lines) or
+ *   events (default). Building with -DSCHED_LOG_LEVEL=LOG_QUIET removes the
+ *   logging code altogether (see trace.h).
+ * - -t writes every event to a binary trace file, whatever the output level;
+ *   trace_render_exec turns it back into the event log.
  */
-int main() {
-    int input[][3] = {
-        {1, 0, 24}, /* {process_id, arrival_time, burst_time} */
-        {2, 0, 3},
-        {3, 0, 3}
+int main(int argc, char *argv[]) {
+    static const struct option long_options[] = {
+        {"sweep", no_argument, NULL, 's'},
+        {"workload", required_argument, NULL, 'w'},
+        {"gantt", required_argument, NULL, 'g'},
+        {"level", required_argument, NULL, 'l'},
+        {"trace", required_argument, NULL, 't'},
+        {NULL, 0, NULL, 0}
     };
+    const char *gantt_path = NULL, *workload_path = NULL, *trace_path = NULL;
+    static TraceWriter trace;
+    FILE *gantt_out = NULL;
+    GanttChart gantt;
+    Process *proc = NULL;
+    int num_processes = 0, sweep = 0, opt;
 
-    int num_processes = sizeof(input) / sizeof(input[0]);
-    Process* proc = (Process*)malloc(num_processes * sizeof(Process));
+    while ((opt = getopt_long(argc, argv, "sw:g:l:t:", long_options, NULL)) != -1) {
+        if (opt == 's') {
+            sweep = 1;
+        } else if (opt == 'w') {
+            workload_path = optarg;
+        } else if (opt == 'g') {
+            gantt_path = optarg;
+        } else if (opt == 'l' && parseLogLevel(optarg) != -1) {
+            log_level = parseLogLevel(optarg);
+        } else if (opt == 't') {
+            trace_path = optarg;
+        } else {
+            printf("Usage: %s [--sweep] [-w workload_file] [-g gantt_file]\n"
+                   "       [-l quiet|summary|events] [-t trace_file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (gantt_path && !(gantt_out = fopen(gantt_path, "w"))) {
+        perror("Unable to open Gantt chart file");
+        return 1;
+    }
+    if (trace_path) {
+        if (traceOpen(&trace, trace_path) != 0) return 1;
+        event_trace = &trace;
+    }
 
-    // Initialize each process.
-    for (int i = 0; i < num_processes; i++) {
-        initializeProcess(&proc[i]);
-        proc[i].process_id = input[i][0];
-        proc[i].arrival_time = input[i][1];
-        proc[i].burst_time = input[i][2];
-        proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set.
+    if (workload_path) {
+        double load_start = wallClockMs();
+        if (workloadLoad(workload_path, &proc, &num_processes) != 0) return 1;
+        printf("Loaded %d processes from %s in %.2f ms\n", num_processes, workload_path, wallClockMs() - load_start);
+    } else {
+        int input[][3] = {
+            {1, 0, 24}, /* {process_id, arrival_time, burst_time} */
+            {2, 0, 3},
+            {3, 0, 3}
+        };
+
+        num_processes = sizeof(input) / sizeof(input[0]);
+        proc = (Process*)malloc(num_processes * sizeof(Process));
+
+        // Initialize processes.
+        for (int i = 0; i < num_processes; i++) {
+            initializeProcess(&proc[i]);
+            proc[i].process_id = input[i][0];
+            proc[i].arrival_time = input[i][1];
+            proc[i].burst_time = input[i][2];
+            proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set.
+        }
     }
 
-    roundRobinScheduling(proc, num_processes, 4);
-    printProcesses(proc, num_processes);
+    double start = wallClockMs();
+    ganttInit(&gantt, "Round Robin", gantt_out);
+    if (sweep) {
+        roundRobinScheduling(proc, num_processes, 4, &gantt);
+    } else {
+        roundRobinFifoScheduling(proc, num_processes, 4, &gantt);
+    }
+    ganttFree(&gantt);
+    if (workload_path) printf("Scheduling time: %.2f ms\n", wallClockMs() - start);
+    if (LOG_ENABLED(LOG_SUMMARY)) printProcesses(proc, num_processes);
+
+    int status = 0;
+    if (event_trace) {
+        long long events = trace.total;
+        if (traceClose(&trace) != 0) {
+            printf("Unable to write trace file %s\n", trace_path);
+            status = 1;
+        } else {
+            printf("Traced %lld events to %s\n", events, trace_path);
+        }
+    }
 
     free(proc);
-    return 0;
-}
\ No newline at end of file
+    if (gantt_out) fclose(gantt_out);
+    return status;
+}
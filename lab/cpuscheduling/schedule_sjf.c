@@ -1,64 +1,41 @@
-#include "process.h"
+#include <unistd.h>
+#include "ready_queue.h"
+#include "gantt.h"
+#include "workload.h"
+#include "trace.h"
 
 /**
- * @brief Finds the shortest available process at the current time.
- * - For Non-Preemptive SJF: Selects process with the **shortest burst time**.
- * - For Preemptive SJF (SRTF): Selects process with the **shortest remaining time**.
- *
- * @param proc Array of processes.
- * @param num_processes Number of processes.
- * @param time Current system time.
- * @param preemptive Boolean flag (1 = preemptive, 0 = non-preemptive).
- * @return Index of the selected process, or -1 if no process is available.
- */
-int findShortestAvailableProcess(Process proc[], int num_processes, int time, int preemptive) {
-    int min_index = -1;
-
-    for (int i = 0; i < num_processes; i++) {
-        if (proc[i].arrival_time <= time && proc[i].remaining_time > 0) {
-            if (min_index == -1 ||
-                (preemptive ? proc[i].remaining_time < proc[min_index].remaining_time
-                            : proc[i].burst_time < proc[min_index].burst_time)) {
-                min_index = i;
-            }
-        }
-    }
-    return min_index;
-}
-
-/**
- * @brief Executes the selected process.
+ * @brief Executes the selected process until it completes or the next event.
  * - Updates execution log and Gantt Chart.
- * - Handles both **preemptive (SRTF)** and **non-preemptive (SJF)** cases.
- * - Prints the "Process starts" message only if switching to a new process.
+ * - Handles both **preemptive (SRTF)** and **non-preemptive (SJF)** cases:
+ *   a preemptive run stops at the next arrival, where the choice is re-evaluated.
+ * - Logs the "Process starts" event only if switching to a new process.
  *
  * @param proc Array of processes.
  * @param index Index of the selected process.
  * @param time Pointer to current time.
- * @param gantt_chart Array storing execution order.
- * @param gc_index Pointer to Gantt chart index.
- * @param preemptive Boolean flag (1 = preemptive, 0 = non-preemptive).
+ * @param gantt Gantt chart receiving the executed slice.
+ * @param until Time of the next arrival (preemptive), or INT_MAX to run to completion.
  * @param last_process Pointer to the variable storing the last process ID that started.
  */
-void executeProcess(Process proc[], int index, int *time, int gantt_chart[], int *gc_index, int preemptive, int *last_process) {
-    // Only print the start message if switching to a new process.
+void executeProcess(Process proc[], int index, int *time, GanttChart *gantt, int until, int *last_process) {
+    // Only log the start if switching to a new process.
     if (*last_process != proc[index].process_id) {
-        printf("Time %d: Process %d starts, (Burst time: %d)\n", *time, proc[index].process_id, proc[index].remaining_time);
+        LOG_EVENT(TRACE_START, *time, proc[index].process_id, proc[index].remaining_time, 0);
         *last_process = proc[index].process_id;  // Update last_process to current process ID
-
-        // Log process execution in the Gantt chart.
-        gantt_chart[(*gc_index)++] = proc[index].process_id;
     }
 
-    // Calculate execution time: for preemptive scheduling, execute one time unit; otherwise, the entire burst time.
-    int execution_time = (preemptive) ? 1 : proc[index].burst_time;
+    // Run to completion, or only up to the next arrival when it may preempt.
+    int execution_time = proc[index].remaining_time;
+    if (until - *time < execution_time) execution_time = until - *time;
     proc[index].remaining_time -= execution_time;
     *time += execution_time;
+    ganttRecord(gantt, proc[index].process_id, *time - execution_time, *time);
 
-    // If process completes execution, print completion message.
+    // If process completes execution, log its completion.
     if (proc[index].remaining_time == 0) {
         proc[index].completion_time = *time;
-        printf("Time %d: Process %d completes\n", *time, proc[index].process_id);
+        LOG_EVENT(TRACE_COMPLETE, *time, proc[index].process_id, 0, 0);
     }
 }
 
@@ -66,105 +43,188 @@ void executeProcess(Process proc[], int index, int *time, int gantt_chart[], int
  * @brief Implements Shortest Job First (Non-Preemptive)
  * - The process with the **shortest burst time** executes first.
  */
-void sjfScheduling(Process proc[], int num_processes) {
+void sjfScheduling(Process proc[], int num_processes, GanttChart *gantt) {
     int time = 0, completed = 0;
-    int gantt_chart[100], gc_index = 0;
     int last_process = -1;  // Initialize to an invalid process ID
+    int *order = sortByArrival(proc, num_processes), next = 0;
+    ReadyQueue ready;
 
-    printf("\n=== Shortest Job First (Non-Preemptive) ===\n");
+    if (!order || readyQueueInit(&ready, proc, num_processes, KEY_BURST) != 0) {
+        printf("Memory allocation failed\n");
+        free(order);
+        return;
+    }
+
+    LOG_EVENT(TRACE_BEGIN, time, 0, TRACE_SJF, 0);
 
     while (completed < num_processes) {
-        int index = findShortestAvailableProcess(proc, num_processes, time, 0);
+        // Arrived processes wait in a min-heap keyed by burst time.
+        next = admitArrivals(&ready, order, num_processes, next, time);
+        int index = readyQueuePop(&ready);
 
         if (index != -1) {
             // Execute the process and update the last process if needed.
-            executeProcess(proc, index, &time, gantt_chart, &gc_index, 0, &last_process);
+            executeProcess(proc, index, &time, gantt, INT_MAX, &last_process);
             completed++; // In non-preemptive scheduling, process finishes in one go.
         } else {
-            time++; // No process is available; increment time.
+            time = nextArrival(proc, order, num_processes, next); // CPU idle: jump to the next arrival.
         }
     }
 
+    readyQueueFree(&ready);
+    free(order);
+
     // Print Gantt Chart Execution Order.
-    printf("\nGantt Chart Execution Order (SJF Non-Preemptive):\n");
-    for (int i = 0; i < gc_index; i++) {
-        printf("P%d ", gantt_chart[i]);
-    }
-    printf("\n");
+    if (LOG_ENABLED(LOG_SUMMARY)) ganttPrint(gantt); else ganttFlush(gantt);
 }
 
 /**
  * @brief Implements Shortest Remaining Time First (SJF Preemptive)
  * - If a new process arrives with a shorter remaining time, it preempts the current process.
  */
-void sjfPreemptiveScheduling(Process proc[], int num_processes) {
+void sjfPreemptiveScheduling(Process proc[], int num_processes, GanttChart *gantt) {
     int time = 0, completed = 0;
-    int gantt_chart[100], gc_index = 0;
     int last_process = -1;  // Initialize to an invalid process ID
+    int *order = sortByArrival(proc, num_processes), next = 0;
+    int running = -1;       // Index of the process that ran last and is not finished
+    ReadyQueue ready;
+
+    if (!order || readyQueueInit(&ready, proc, num_processes, KEY_REMAINING) != 0) {
+        printf("Memory allocation failed\n");
+        free(order);
+        return;
+    }
 
-    printf("\n=== Shortest Job First (Preemptive - Shortest Remaining Time First) ===\n");
+    LOG_EVENT(TRACE_BEGIN, time, 0, TRACE_SRTF, 0);
 
     while (completed < num_processes) {
-        int index = findShortestAvailableProcess(proc, num_processes, time, 1);
+        // The running process is outside the heap while its remaining time changes;
+        // it competes with the new arrivals again at every arrival or completion.
+        next = admitArrivals(&ready, order, num_processes, next, time);
+        if (running != -1) readyQueuePush(&ready, running);
+        int index = readyQueuePop(&ready);
 
         if (index != -1) {
-            // Execute the process; if it is the same as the last one, the start message won't print.
-            executeProcess(proc, index, &time, gantt_chart, &gc_index, 1, &last_process);
+            // Execute the process; if it is the same as the last one, the start is not logged again.
+            executeProcess(proc, index, &time, gantt,
+                           nextArrival(proc, order, num_processes, next), &last_process);
             if (proc[index].remaining_time == 0) {
                 completed++;
+                running = -1;
+            } else {
+                running = index;
             }
         } else {
-            time++; // No process available; move time forward.
+            time = nextArrival(proc, order, num_processes, next); // CPU idle: jump to the next arrival.
         }
     }
 
+    readyQueueFree(&ready);
+    free(order);
+
     // Print Gantt Chart Execution Order.
-    printf("\nGantt Chart Execution Order (SJF Preemptive):\n");
-    for (int i = 0; i < gc_index; i++) {
-        printf("P%d ", gantt_chart[i]);
-    }
-    printf("\n");
+    if (LOG_ENABLED(LOG_SUMMARY)) ganttPrint(gantt); else ganttFlush(gantt);
 }
 
 /**
  * @brief Main function for SJF Scheduling.
+ * - Usage: ./schedule_sjf_exec [-w workload_file] [-g gantt_file]
+ *          [-l quiet|summary|events] [-t trace_file]
+ * - -w loads the workload from a CSV or binary file (see workload.h); load time
+ *   and scheduling time are reported separately. Without -w, the built-in example runs.
+ * - -g streams the Gantt chart to a file instead of keeping it in memory.
+ * - -l selects the output: quiet (times only), summary (no per-event lines) or
+ *   events (default). Building with -DSCHED_LOG_LEVEL=LOG_QUIET removes the
+ *   logging code altogether (see trace.h).
+ * - -t writes every event to a binary trace file, whatever the output level;
+ *   trace_render_exec turns it back into the event log.
  */
-int main() {
-    int input[][3] = {
-        {1, 0, 8},  /* {process_id, arrival_time, burst_time} */
-        {2, 1, 4},
-        {3, 2, 9},
-        {4, 3, 5}
-    };
-
-    int num_processes = sizeof(input) / sizeof(input[0]);
-    Process* proc = (Process*)malloc(num_processes * sizeof(Process));
-
-    // Initialize processes for Non-preemptive SJF.
-    for (int i = 0; i < num_processes; i++) {
-        initializeProcess(&proc[i]);
-        proc[i].process_id = input[i][0];
-        proc[i].arrival_time = input[i][1];
-        proc[i].burst_time = input[i][2];
-        proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set
+int main(int argc, char *argv[]) {
+    const char *gantt_path = NULL, *workload_path = NULL, *trace_path = NULL;
+    static TraceWriter trace;
+    FILE *gantt_out = NULL;
+    GanttChart gantt;
+    Process *proc = NULL;
+    int num_processes = 0, opt;
+
+    while ((opt = getopt(argc, argv, "w:g:l:t:")) != -1) {
+        if (opt == 'w') {
+            workload_path = optarg;
+        } else if (opt == 'g') {
+            gantt_path = optarg;
+        } else if (opt == 'l' && parseLogLevel(optarg) != -1) {
+            log_level = parseLogLevel(optarg);
+        } else if (opt == 't') {
+            trace_path = optarg;
+        } else {
+            printf("Usage: %s [-w workload_file] [-g gantt_file]\n"
+                   "       [-l quiet|summary|events] [-t trace_file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (gantt_path && !(gantt_out = fopen(gantt_path, "w"))) {
+        perror("Unable to open Gantt chart file");
+        return 1;
+    }
+    if (trace_path) {
+        if (traceOpen(&trace, trace_path) != 0) return 1;
+        event_trace = &trace;
     }
 
-    sjfScheduling(proc, num_processes);
-    printProcesses(proc, num_processes);
+    if (workload_path) {
+        double load_start = wallClockMs();
+        if (workloadLoad(workload_path, &proc, &num_processes) != 0) return 1;
+        printf("Loaded %d processes from %s in %.2f ms\n", num_processes, workload_path, wallClockMs() - load_start);
+    } else {
+        int input[][3] = {
+            {1, 0, 8},  /* {process_id, arrival_time, burst_time} */
+            {2, 1, 4},
+            {3, 2, 9},
+            {4, 3, 5}
+        };
+
+        num_processes = sizeof(input) / sizeof(input[0]);
+        proc = (Process*)malloc(num_processes * sizeof(Process));
+
+        // Initialize processes.
+        for (int i = 0; i < num_processes; i++) {
+            initializeProcess(&proc[i]);
+            proc[i].process_id = input[i][0];
+            proc[i].arrival_time = input[i][1];
+            proc[i].burst_time = input[i][2];
+            proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set.
+        }
+    }
+
+    double start = wallClockMs();
+    ganttInit(&gantt, "SJF Non-Preemptive", gantt_out);
+    sjfScheduling(proc, num_processes, &gantt);
+    ganttFree(&gantt);
+    if (workload_path) printf("Scheduling time: %.2f ms\n", wallClockMs() - start);
+    if (LOG_ENABLED(LOG_SUMMARY)) printProcesses(proc, num_processes);
 
     // Reset processes for Preemptive SJF.
-    for (int i = 0; i < num_processes; i++) {
-        initializeProcess(&proc[i]);
-        proc[i].process_id = input[i][0];
-        proc[i].arrival_time = input[i][1];
-        proc[i].burst_time = input[i][2];
-        proc[i].remaining_time = proc[i].burst_time; // Ensure remaining_time is set
+    workloadReset(proc, num_processes);
+
+    start = wallClockMs();
+    ganttInit(&gantt, "SJF Preemptive", gantt_out);
+    sjfPreemptiveScheduling(proc, num_processes, &gantt);
+    ganttFree(&gantt);
+    if (workload_path) printf("Scheduling time: %.2f ms\n", wallClockMs() - start);
+    if (LOG_ENABLED(LOG_SUMMARY)) printProcesses(proc, num_processes);
+
+    int status = 0;
+    if (event_trace) {
+        long long events = trace.total;
+        if (traceClose(&trace) != 0) {
+            printf("Unable to write trace file %s\n", trace_path);
+            status = 1;
+        } else {
+            printf("Traced %lld events to %s\n", events, trace_path);
+        }
     }
 
-    // Execute Preemptive - Shortest Remaining Time First scheduling.
-    sjfPreemptiveScheduling(proc, num_processes);
-    printProcesses(proc, num_processes);
-
     free(proc);
-    return 0;
-}
\ No newline at end of file
+    if (gantt_out) fclose(gantt_out);
+    return status;
+}
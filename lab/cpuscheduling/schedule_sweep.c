@@ -0,0 +1,230 @@
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "generator.h"
+#include "simulate.h"
+#include "workload.h"
+
+#define SWEEP_SEED 20240601ULL  /**< Default seed of the generated workload (same as the benchmark). */
+#define MAX_COSTS 16            /**< Most context-switch costs in one sweep. */
+#define MAX_THREADS 256         /**< Most worker threads. */
+
+/**
+ * @struct SweepJob
+ * @brief One point of the sweep: the policy with one quantum and one context-switch cost.
+ */
+typedef struct {
+  int quantum;        /**< Time quantum. */
+  int switch_cost;    /**< Context-switch cost. */
+  int status;         /**< 0 on success, -1 on failure. */
+  SimResult result;   /**< Summary of the run. */
+} SweepJob;
+
+/**
+ * @struct Sweep
+ * @brief Work queue shared by the worker threads.
+ * Workers take the next job under the lock and simulate it on a private copy
+ * of the read-only workload, so faster jobs never leave a core idle.
+ */
+typedef struct {
+  const Policy *policy;    /**< Policy swept (RR unless -p says otherwise). */
+  const Process *input;    /**< Shared, read-only workload. */
+  int num_processes;       /**< Number of processes. */
+  SweepJob *jobs;          /**< All jobs, cost-major then quantum. */
+  int num_jobs;            /**< Number of jobs. */
+  int next_job;            /**< Next job to hand out. */
+  pthread_mutex_t lock;    /**< Protects next_job. */
+} Sweep;
+
+/**
+ * @brief Worker thread body: runs jobs from the queue until it is empty.
+ */
+static void *sweepWorker(void *arg) {
+    Sweep *sweep = (Sweep*)arg;
+    Process *proc = (Process*)malloc((sweep->num_processes > 0 ? sweep->num_processes : 1) * sizeof(Process));
+    if (!proc) {
+        printf("Memory allocation failed\n");
+        return NULL;
+    }
+
+    while (1) {
+        pthread_mutex_lock(&sweep->lock);
+        int j = sweep->next_job++;
+        pthread_mutex_unlock(&sweep->lock);
+        if (j >= sweep->num_jobs) break;
+
+        SweepJob *job = &sweep->jobs[j];
+        PolicyParams params = defaultPolicyParams(job->quantum);
+        params.switch_cost = job->switch_cost;
+        memcpy(proc, sweep->input, sweep->num_processes * sizeof(Process));
+        job->status = simulate(sweep->policy, proc, sweep->num_processes, &params, NULL, &job->result);
+    }
+    free(proc);
+    return NULL;
+}
+
+/**
+ * @brief Parses "first:last[:step]" into a quantum range.
+ * @return 0 on success, -1 if the range is malformed or empty.
+ */
+static int parseRange(const char *text, int *first, int *last, int *step) {
+    *step = 1;
+    int fields = sscanf(text, "%d:%d:%d", first, last, step);
+    if (fields == 1) *last = *first;
+    return (fields >= 1 && *first > 0 && *last >= *first && *step > 0) ? 0 : -1;
+}
+
+/**
+ * @brief Parses a comma-separated list of non-negative context-switch costs.
+ * @return Number of costs, or -1 if the list is malformed.
+ */
+static int parseCosts(char *list, int costs[], int max) {
+    int n = 0;
+    for (char *item = strtok(list, ","); item; item = strtok(NULL, ",")) {
+        if (n == max || (costs[n] = atoi(item)) < 0) {
+            printf("Invalid or too many switch costs: %s\n", item);
+            return -1;
+        }
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Returns the response time a job is ranked by (mean or p99).
+ */
+static double objectiveOf(const SweepJob *job, int p99) {
+    return p99 ? job->result.response.p99 : job->result.response.mean;
+}
+
+/**
+ * @brief Main function of the quantum sweep.
+ * - Usage: ./schedule_sweep_exec [-w workload_file | -n processes [-b exponential|pareto] [-s seed]]
+ *          [-p policy] [-q first:last[:step]] [-k cost,...] [-j threads] [-o mean|p99] [-c]
+ * - Simulates the policy (default rr) for every quantum in the range (default
+ *   1:32) and every context-switch cost in the list (default 0), then reports
+ *   the quantum with the lowest mean (or, with -o p99, 99th percentile)
+ *   response time for each cost.
+ * - Jobs are spread over -j worker threads (default: one per online CPU).
+ * - Without -w, a generated workload of -n processes (default 100000) is used.
+ * - -c prints CSV instead of a table.
+ */
+int main(int argc, char *argv[]) {
+    const char *workload_path = NULL;
+    const Policy *policy = findPolicy("rr");
+    BurstDistribution bursts = BURST_EXPONENTIAL;
+    uint64_t seed = SWEEP_SEED;
+    int first = 1, last = 32, step = 1, costs[MAX_COSTS] = { 0 }, num_costs = 1;
+    int num_processes = 100000, num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN), p99 = 0, csv = 0, opt;
+    Process *proc = NULL;
+
+    while ((opt = getopt(argc, argv, "w:n:b:s:p:q:k:j:o:c")) != -1) {
+        if (opt == 'w') {
+            workload_path = optarg;
+        } else if (opt == 'n') {
+            num_processes = atoi(optarg);
+        } else if (opt == 'b' && strcmp(optarg, "exponential") == 0) {
+            bursts = BURST_EXPONENTIAL;
+        } else if (opt == 'b' && strcmp(optarg, "pareto") == 0) {
+            bursts = BURST_PARETO;
+        } else if (opt == 's') {
+            seed = strtoull(optarg, NULL, 10);
+        } else if (opt == 'p') {
+            if (!(policy = findPolicy(optarg))) {
+                printf("Unknown policy: %s\n", optarg);
+                return 1;
+            }
+        } else if (opt == 'q') {
+            if (parseRange(optarg, &first, &last, &step) != 0) {
+                printf("Invalid quantum range: %s (first:last[:step])\n", optarg);
+                return 1;
+            }
+        } else if (opt == 'k') {
+            if ((num_costs = parseCosts(optarg, costs, MAX_COSTS)) <= 0) return 1;
+        } else if (opt == 'j') {
+            num_threads = atoi(optarg);
+        } else if (opt == 'o' && (strcmp(optarg, "mean") == 0 || strcmp(optarg, "p99") == 0)) {
+            p99 = strcmp(optarg, "p99") == 0;
+        } else if (opt == 'c') {
+            csv = 1;
+        } else {
+            printf("Usage: %s [-w workload_file | -n processes [-b exponential|pareto] [-s seed]]\n"
+                   "       [-p policy] [-q first:last[:step]] [-k cost,...] [-j threads] [-o mean|p99] [-c]\n",
+                   argv[0]);
+            return 1;
+        }
+    }
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > MAX_THREADS) num_threads = MAX_THREADS;
+
+    if (workload_path) {
+        if (workloadLoad(workload_path, &proc, &num_processes) != 0) return 1;
+    } else {
+        WorkloadSpec spec = defaultWorkloadSpec(num_processes, bursts, seed);
+        if (generateWorkload(&spec, &proc) != 0) return 1;
+    }
+
+    Sweep sweep = { .policy = policy, .input = proc, .num_processes = num_processes,
+                    .num_jobs = num_costs * ((last - first) / step + 1) };
+    sweep.jobs = (SweepJob*)calloc(sweep.num_jobs, sizeof(SweepJob));
+    if (!sweep.jobs) {
+        printf("Memory allocation failed\n");
+        free(proc);
+        return 1;
+    }
+    for (int c = 0, j = 0; c < num_costs; c++) {
+        for (int q = first; q <= last; q += step, j++) {
+            sweep.jobs[j] = (SweepJob){ .quantum = q, .switch_cost = costs[c], .status = -1 };
+        }
+    }
+    pthread_mutex_init(&sweep.lock, NULL);
+
+    pthread_t threads[MAX_THREADS];
+    int started = 0;
+    double start = wallClockMs();
+    while (started < num_threads && pthread_create(&threads[started], NULL, sweepWorker, &sweep) == 0) started++;
+    if (started == 0) sweepWorker(&sweep);
+    for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+    double elapsed = wallClockMs() - start;
+    pthread_mutex_destroy(&sweep.lock);
+
+    if (csv) {
+        printf("policy,switch_cost,quantum,avg_response,p99_response,avg_turnaround,p99_turnaround,"
+               "context_switches,utilization\n");
+    } else {
+        printf("%s over %d processes: %d jobs on %d threads in %.2f ms\n\n", policy->title, num_processes,
+               sweep.num_jobs, started > 0 ? started : 1, elapsed);
+        printf("%6s %8s %10s %10s %10s %10s %10s %6s\n", "Cost", "Quantum", "Avg Resp", "P99 Resp",
+               "Avg TAT", "P99 TAT", "Switches", "CPU %");
+    }
+
+    int per_cost = sweep.num_jobs / num_costs;
+    for (int c = 0; c < num_costs; c++) {
+        SweepJob *jobs = &sweep.jobs[c * per_cost], *best = NULL;
+        for (int q = 0; q < per_cost; q++) {
+            if (jobs[q].status == 0 && (!best || objectiveOf(&jobs[q], p99) < objectiveOf(best, p99))) best = &jobs[q];
+        }
+        for (int q = 0; q < per_cost; q++) {
+            const SimResult *r = &jobs[q].result;
+            if (jobs[q].status != 0) {
+                printf("%6d %8d failed\n", jobs[q].switch_cost, jobs[q].quantum);
+            } else if (csv) {
+                printf("%s,%d,%d,%.3f,%.1f,%.3f,%.1f,%lld,%.6f\n", policy->name, jobs[q].switch_cost,
+                       jobs[q].quantum, r->response.mean, r->response.p99, r->turnaround.mean, r->turnaround.p99,
+                       r->context_switches, r->utilization);
+            } else {
+                printf("%6d %8d %10.2f %10.0f %10.2f %10.0f %10lld %6.1f%s\n", jobs[q].switch_cost, jobs[q].quantum,
+                       r->response.mean, r->response.p99, r->turnaround.mean, r->turnaround.p99,
+                       r->context_switches, 100.0 * r->utilization, &jobs[q] == best ? " *" : "");
+            }
+        }
+        if (best && !csv) {
+            printf("Best quantum for switch cost %d: %d (%s response %.2f)\n\n", best->switch_cost, best->quantum,
+                   p99 ? "p99" : "mean", objectiveOf(best, p99));
+        }
+    }
+
+    free(sweep.jobs);
+    free(proc);
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <string.h>
+#include "simulate.h"
+#include "ready_queue.h"
+#include "device.h"
+#include "workload.h"
+
+void summarizeRun(Process proc[], int num_processes, const int first_run[], SimResult *result) {
+    RunSketches *sketch = (RunSketches*)malloc(sizeof(RunSketches));
+    if (!sketch) {
+        printf("Memory allocation failed\n");
+        return;
+    }
+    sketchInit(&sketch->waiting);
+    sketchInit(&sketch->turnaround);
+    sketchInit(&sketch->response);
+
+    for (int i = 0; i < num_processes; i++) {
+        sketchAdd(&sketch->waiting, calculateWaitingTime(&proc[i]));
+        sketchAdd(&sketch->turnaround, calculateTurnarroundTime(&proc[i]));
+        sketchAdd(&sketch->response, first_run[i] - proc[i].arrival_time);
+        if (proc[i].completion_time > result->makespan) result->makespan = proc[i].completion_time;
+    }
+    result->waiting = sketchSummary(&sketch->waiting);
+    result->turnaround = sketchSummary(&sketch->turnaround);
+    result->response = sketchSummary(&sketch->response);
+    if (result->makespan > 0) {
+        result->throughput = (double)num_processes / result->makespan;
+        result->utilization = (double)result->busy / ((double)result->makespan * result->cpus);
+    }
+    free(sketch);
+}
+
+int simulate(const Policy *policy, Process proc[], int num_processes, const PolicyParams *params,
+             GanttChart *gantt, SimResult *result) {
+    int time = 0, completed = 0, with_io = 0;
+    int running = -1, ran = 0, last_index = -1;
+    int *order = sortByArrival(proc, num_processes), next = 0;
+    int *first_run = (int*)malloc((num_processes > 0 ? num_processes : 1) * sizeof(int));
+    int *burst = NULL;
+    DeviceQueue io = { .queue = NULL };
+    void *state = NULL;
+
+    memset(result, 0, sizeof(*result));
+    result->policy = policy;
+    result->num_processes = num_processes;
+    result->cpus = 1;
+
+    // Position of each process in its burst list; only needed when some process does I/O.
+    for (int i = 0; i < num_processes; i++) with_io += proc[i].num_bursts > 1;
+    if (with_io) burst = (int*)calloc(num_processes, sizeof(int));
+
+    if (!order || !first_run || (with_io && !burst) || deviceQueueInit(&io, params->io_devices, with_io) != 0 ||
+        policy->init(&state, proc, num_processes, params) != 0) {
+        printf("Memory allocation failed\n");
+        deviceQueueFree(&io);
+        free(order);
+        free(first_run);
+        free(burst);
+        return -1;
+    }
+    for (int i = 0; i < num_processes; i++) first_run[i] = -1;
+
+    double start = wallClockMs();
+    while (completed < num_processes) {
+        // Arrivals and finished I/O are delivered before the process that just ran is handed back.
+        while (next < num_processes && proc[order[next]].arrival_time <= time) {
+            policy->onArrival(state, order[next++], time);
+        }
+        for (int index; (index = deviceComplete(&io, time)) != -1; ) {
+            proc[index].remaining_time = proc[index].bursts[++burst[index]];
+            policy->onArrival(state, index, time);
+        }
+        if (running != -1) {
+            policy->onTick(state, running, ran, time);
+            running = -1;
+        }
+
+        // The next event that can hand the policy a process.
+        int until = nextArrival(proc, order, num_processes, next);
+        int io_done = deviceNextCompletion(&io);
+        if (io_done < until) until = io_done;
+
+        int index = policy->selectNext(state, time);
+        if (index == -1) {
+            time = until; // CPU idle: jump to the next arrival or I/O completion.
+            continue;
+        }
+        result->decisions++;
+        int overhead = params->dispatch_cost;
+        if (index != last_index) {
+            result->context_switches++;
+            overhead += params->switch_cost;
+        }
+        result->overhead += overhead;
+        time += overhead;
+        last_index = index;
+
+        // Run until the burst ends, the slice ends, or the next event if it may preempt.
+        int slice = policy->sliceLength(state, index, time);
+        ran = proc[index].remaining_time;
+        if (slice < ran) ran = slice;
+        if (policy->preemptive) {
+            if (until - time < ran) ran = until - time;
+            if (ran < 0) ran = 0; // Arrived during the dispatch overhead.
+        }
+        if (ran > 0 && first_run[index] == -1) first_run[index] = time;
+        proc[index].remaining_time -= ran;
+        time += ran;
+        result->busy += ran;
+        if (gantt && ran > 0) ganttRecord(gantt, proc[index].process_id, time - ran, time);
+
+        if (proc[index].remaining_time == 0) {
+            if (burst && burst[index] + 1 < proc[index].num_bursts) {
+                // An I/O burst follows: the process leaves the CPU for the device queue.
+                deviceSubmit(&io, index, proc[index].bursts[++burst[index]], time);
+            } else {
+                proc[index].completion_time = time;
+                proc[index].is_completed = 1;
+                completed++;
+            }
+        }
+        running = index;
+    }
+    if (running != -1) policy->onTick(state, running, ran, time);
+    result->elapsed_ms = wallClockMs() - start;
+    result->io_requests = io.requests;
+    result->io_busy = io.busy;
+    result->io_wait = io.waited;
+
+    summarizeRun(proc, num_processes, first_run, result);
+    policy->destroy(state);
+    deviceQueueFree(&io);
+    free(order);
+    free(first_run);
+    free(burst);
+    return 0;
+}
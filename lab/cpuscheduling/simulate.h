@@ -0,0 +1,89 @@
+//simulate.h
+
+#ifndef SIMULATE_H
+#define SIMULATE_H
+
+#include "policy.h"
+#include "gantt.h"
+#include "stats.h"
+
+
+/**
+ * @struct SimResult
+ * @brief Summary of one simulated run, as shown in the comparison table.
+ */
+typedef struct {
+  const Policy *policy;        /**< Policy that was simulated. */
+  int num_processes;           /**< Processes scheduled. */
+  int cpus;                    /**< CPUs simulated. */
+  MetricSummary waiting;       /**< Waiting time: turnaround minus burst. */
+  MetricSummary turnaround;    /**< Turnaround time: completion minus arrival. */
+  MetricSummary response;      /**< Response time: first run minus arrival. */
+  int makespan;                /**< Completion time of the last process. */
+  double throughput;           /**< Processes completed per time unit of makespan. */
+  double utilization;          /**< Busy time over makespan times cpus (0 .. 1). */
+  long long busy;              /**< Time units the CPUs were running a process. */
+  long long overhead;          /**< Time units the CPUs spent on dispatches and context switches. */
+  long long io_requests;       /**< I/O bursts issued. */
+  long long io_busy;           /**< Device time spent serving I/O (summed over devices). */
+  long long io_wait;           /**< Time I/O requests waited in the device queue. */
+  long long context_switches;  /**< Dispatches of a process other than the one that ran last. */
+  long long decisions;         /**< Calls to the policy's selectNext that returned a process. */
+  double elapsed_ms;           /**< Wall-clock time of the simulation. */
+} SimResult;
+
+
+/**
+ * @struct RunSketches
+ * @brief Sketches of the per-process metrics of a run (about 13 KiB each, so kept off the stack).
+ */
+typedef struct {
+  QuantileSketch waiting;     /**< Waiting times. */
+  QuantileSketch turnaround;  /**< Turnaround times. */
+  QuantileSketch response;    /**< Response times. */
+} RunSketches;
+
+
+/**
+ * @brief Runs a policy over a workload with event-driven time.
+ * - The CPU jumps straight to the next arrival when idle; a running process
+ *   runs until it completes, its slice ends, or (for preemptive policies) the
+ *   next arrival.
+ * - Every dispatch costs params->dispatch_cost, plus params->switch_cost if
+ *   the process differs from the one that ran last. Arrivals during that
+ *   overhead are held back; a preemptive policy then re-evaluates before the
+ *   process runs. Response time is measured to the moment a process first
+ *   runs, after any overhead.
+ * - A process with a burst list (see Process) issues an I/O request to the
+ *   device queue after each CPU burst but the last, and returns to the policy
+ *   through onArrival() when the device finishes. Finished I/O is delivered
+ *   after arrivals due at the same time and, like an arrival, preempts a
+ *   preemptive policy.
+ * - Sets remaining_time, completion_time and is_completed of every process;
+ *   reset them with workloadReset() before simulating the array again.
+ * @param policy Policy to run.
+ * @param proc Array of processes (modified).
+ * @param num_processes Number of processes.
+ * @param params Tunables passed to the policy.
+ * @param gantt Chart receiving every slice, or NULL.
+ * @param result Output: summary of the run.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int simulate(const Policy *policy, Process proc[], int num_processes, const PolicyParams *params,
+             GanttChart *gantt, SimResult *result);
+
+
+/**
+ * @brief Fills in the waiting, turnaround and response statistics of a finished run.
+ * - One pass over the processes feeds a QuantileSketch per metric, so the
+ *   memory used does not grow with the number of processes.
+ * - Sets waiting, turnaround, response, makespan, throughput and utilization;
+ *   cpus and busy must already be set.
+ * @param proc Array of completed processes.
+ * @param num_processes Number of processes.
+ * @param first_run Time each process first ran.
+ * @param result Result to update.
+ */
+void summarizeRun(Process proc[], int num_processes, const int first_run[], SimResult *result);
+
+#endif // SIMULATE_H
@@ -0,0 +1,412 @@
+#include <pthread.h>
+#include <string.h>
+#include "smp.h"
+#include "ready_queue.h"
+#include "workload.h"
+
+struct Smp;
+
+/**
+ * @struct Cpu
+ * @brief One simulated CPU: its runqueue, the process on it and its local clock.
+ */
+typedef struct {
+  void *state;              /**< Runqueue: this CPU's instance of the policy. */
+  int queued;               /**< Processes in the runqueue. */
+  int running;              /**< Process on the CPU, or -1. */
+  int slice_left;           /**< Time left in the running slice; 0 once the slice has ended. */
+  int ran;                  /**< Time run so far in the current slice. */
+  int stall_left;           /**< Migration cost and dispatch overhead still to pay before the running process runs. */
+  int last_index;           /**< Process that ran last (for context switches). */
+  int arrived;              /**< The runqueue grew since the last preemption check. */
+  int *arrivals;            /**< Processes placed here for the current epoch, in arrival order. */
+  int num_arrivals;         /**< Entries in arrivals. */
+  int arrivals_capacity;    /**< Allocated entries in arrivals. */
+  int next_arrival;         /**< Next entry of arrivals to admit. */
+  int time;                 /**< Local clock. */
+  int completed;            /**< Processes completed on this CPU. */
+  long long decisions;      /**< Processes selected from the runqueue. */
+  long long switches;       /**< Dispatches of a different process than the last one. */
+  SmpCpuStats stats;        /**< Counters reported in the result. */
+  pthread_t thread;         /**< Thread advancing this CPU (threaded mode). */
+  struct Smp *smp;          /**< Simulation the CPU belongs to. */
+} Cpu;
+
+/**
+ * @struct Smp
+ * @brief State shared by all CPUs of one simulation.
+ */
+typedef struct Smp {
+  const Policy *policy;       /**< Policy every runqueue runs. */
+  Process *proc;              /**< Process array. */
+  int *first_run;             /**< Time each process first ran, or -1. */
+  int *penalty;               /**< Migration cost owed by each process before it next runs. */
+  int migration_cost;         /**< Cost added to a process each time it migrates. */
+  int switch_cost;            /**< Stall charged when a CPU dispatches a different process. */
+  int dispatch_cost;          /**< Stall charged on every dispatch. */
+  Cpu *cpus;                  /**< The CPUs. */
+  int num_cpus;               /**< Number of CPUs. */
+  int epoch_end;              /**< End of the epoch being simulated. */
+  int threads;                /**< CPUs 0 .. threads - 1 are advanced by their own threads. */
+  int stop;                   /**< Tells the CPU threads to exit. */
+  int generation;             /**< Epoch counter the CPU threads wait on. */
+  int pending;                /**< CPU threads still running the current epoch. */
+  pthread_mutex_t lock;       /**< Protects stop, generation and pending. */
+  pthread_cond_t wake;        /**< Signalled when a new epoch (or stop) is posted. */
+  pthread_cond_t finished;    /**< Signalled when the last CPU thread finishes its epoch. */
+} Smp;
+
+/**
+ * @brief Adds a process to a CPU's runqueue.
+ */
+static void enqueue(Smp *smp, Cpu *cpu, int index, int time) {
+    smp->policy->onArrival(cpu->state, index, time);
+    cpu->queued++;
+    cpu->arrived = 1;
+}
+
+/**
+ * @brief Processes on a CPU, including those placed for this epoch but not yet arrived.
+ */
+static int cpuLoad(const Cpu *cpu) {
+    return cpu->queued + (cpu->running != -1) + (cpu->num_arrivals - cpu->next_arrival);
+}
+
+/**
+ * @brief Moves the process a CPU would run next onto another CPU's runqueue.
+ * @return 0 if a process moved, -1 if the source runqueue was empty.
+ */
+static int migrate(Smp *smp, Cpu *from, Cpu *to, int time) {
+    int index = smp->policy->selectNext(from->state, time);
+    if (index == -1) return -1;
+    from->queued--;
+    from->stats.migrations_out++;
+    smp->penalty[index] += smp->migration_cost;
+    enqueue(smp, to, index, time);
+    to->stats.migrations_in++;
+    return 0;
+}
+
+/**
+ * @brief Runs one CPU from its local clock to the end of the epoch.
+ * - Follows the same event order as simulate(): arrivals, then the end of the
+ *   last slice, then the next selection.
+ */
+static void advanceCpu(Smp *smp, Cpu *cpu) {
+    const Policy *policy = smp->policy;
+    Process *proc = smp->proc;
+    int end = smp->epoch_end;
+
+    while (cpu->time < end) {
+        int time = cpu->time;
+        while (cpu->next_arrival < cpu->num_arrivals && proc[cpu->arrivals[cpu->next_arrival]].arrival_time <= time) {
+            enqueue(smp, cpu, cpu->arrivals[cpu->next_arrival++], time);
+        }
+
+        // A preemptive policy re-evaluates whenever its runqueue grows (after any migration stall).
+        if (cpu->arrived && cpu->stall_left == 0) {
+            if (cpu->running != -1 && policy->preemptive) cpu->slice_left = 0;
+            cpu->arrived = 0;
+        }
+        if (cpu->running != -1 && cpu->slice_left == 0) {
+            policy->onTick(cpu->state, cpu->running, cpu->ran, time);
+            if (proc[cpu->running].remaining_time > 0) cpu->queued++;
+            cpu->running = -1;
+        }
+
+        if (cpu->running == -1) {
+            int index = policy->selectNext(cpu->state, time);
+            int next = (cpu->next_arrival < cpu->num_arrivals) ? proc[cpu->arrivals[cpu->next_arrival]].arrival_time : end;
+            if (index == -1) {
+                cpu->time = (next < end) ? next : end; // Idle until the next local arrival.
+                continue;
+            }
+            cpu->queued--;
+            cpu->decisions++;
+            cpu->stats.dispatches++;
+
+            int slice = policy->sliceLength(cpu->state, index, time);
+            cpu->running = index;
+            cpu->ran = 0;
+            cpu->slice_left = (slice < proc[index].remaining_time) ? slice : proc[index].remaining_time;
+            cpu->stall_left = smp->penalty[index];
+            cpu->stats.stall += smp->penalty[index];
+            smp->penalty[index] = 0;
+            int overhead = smp->dispatch_cost;
+            if (index != cpu->last_index) {
+                cpu->switches++;
+                overhead += smp->switch_cost;
+            }
+            cpu->stall_left += overhead;
+            cpu->stats.overhead += overhead;
+            cpu->last_index = index;
+        }
+
+        // A migrated or newly dispatched process first waits out its costs.
+        if (cpu->stall_left > 0) {
+            int step = (cpu->stall_left < end - time) ? cpu->stall_left : end - time;
+            cpu->stall_left -= step;
+            cpu->time += step;
+            continue;
+        }
+
+        // Run to the end of the slice, the next local arrival if it may preempt, or the epoch end.
+        int until = end;
+        if (policy->preemptive && cpu->next_arrival < cpu->num_arrivals &&
+            proc[cpu->arrivals[cpu->next_arrival]].arrival_time < until) {
+            until = proc[cpu->arrivals[cpu->next_arrival]].arrival_time;
+        }
+
+        int step = (cpu->slice_left < until - time) ? cpu->slice_left : until - time;
+        Process *p = &proc[cpu->running];
+        if (smp->first_run[cpu->running] == -1) smp->first_run[cpu->running] = time;
+        p->remaining_time -= step;
+        cpu->slice_left -= step;
+        cpu->ran += step;
+        cpu->stats.busy += step;
+        cpu->time += step;
+        if (p->remaining_time == 0) {
+            p->completion_time = cpu->time;
+            p->is_completed = 1;
+            cpu->completed++;
+            cpu->slice_left = 0;
+        }
+    }
+
+    // Arrivals a busy CPU did not stop for join its runqueue before the epoch closes.
+    while (cpu->next_arrival < cpu->num_arrivals) {
+        int index = cpu->arrivals[cpu->next_arrival++];
+        enqueue(smp, cpu, index, proc[index].arrival_time);
+    }
+}
+
+/**
+ * @brief Thread body: advances one CPU each epoch until told to stop.
+ */
+static void *cpuThread(void *arg) {
+    Cpu *cpu = (Cpu*)arg;
+    Smp *smp = cpu->smp;
+    int seen = 0;
+
+    while (1) {
+        pthread_mutex_lock(&smp->lock);
+        while (smp->generation == seen && !smp->stop) pthread_cond_wait(&smp->wake, &smp->lock);
+        seen = smp->generation;
+        int stop = smp->stop;
+        pthread_mutex_unlock(&smp->lock);
+        if (stop) break;
+
+        advanceCpu(smp, cpu);
+
+        pthread_mutex_lock(&smp->lock);
+        if (--smp->pending == 0) pthread_cond_signal(&smp->finished);
+        pthread_mutex_unlock(&smp->lock);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Simulates one epoch on every CPU: threaded CPUs in parallel, the rest on this thread.
+ */
+static void runEpoch(Smp *smp) {
+    if (smp->threads > 0) {
+        pthread_mutex_lock(&smp->lock);
+        smp->pending = smp->threads;
+        smp->generation++;
+        pthread_cond_broadcast(&smp->wake);
+        pthread_mutex_unlock(&smp->lock);
+    }
+    for (int c = smp->threads; c < smp->num_cpus; c++) advanceCpu(smp, &smp->cpus[c]);
+    if (smp->threads > 0) {
+        pthread_mutex_lock(&smp->lock);
+        while (smp->pending > 0) pthread_cond_wait(&smp->finished, &smp->lock);
+        pthread_mutex_unlock(&smp->lock);
+    }
+}
+
+/**
+ * @brief Places a process on a CPU for the coming epoch.
+ */
+static int placeArrival(Cpu *cpu, int index) {
+    if (cpu->num_arrivals == cpu->arrivals_capacity) {
+        int capacity = cpu->arrivals_capacity ? cpu->arrivals_capacity * 2 : 64;
+        int *grown = (int*)realloc(cpu->arrivals, capacity * sizeof(int));
+        if (!grown) return -1;
+        cpu->arrivals = grown;
+        cpu->arrivals_capacity = capacity;
+    }
+    cpu->arrivals[cpu->num_arrivals++] = index;
+    return 0;
+}
+
+/**
+ * @brief Idle CPUs pull one process each from the runqueue with the most waiting processes.
+ */
+static void stealWork(Smp *smp, SmpResult *result, int time) {
+    for (int c = 0; c < smp->num_cpus; c++) {
+        Cpu *thief = &smp->cpus[c];
+        if (cpuLoad(thief) > 0) continue;
+
+        Cpu *victim = NULL;
+        for (int v = 0; v < smp->num_cpus; v++) {
+            if (smp->cpus[v].queued > 0 && (!victim || smp->cpus[v].queued > victim->queued)) victim = &smp->cpus[v];
+        }
+        if (!victim) return;
+        if (migrate(smp, victim, thief, time) == 0) result->steals++;
+    }
+}
+
+/**
+ * @brief Moves processes from the most to the least loaded CPU until loads differ by at most one.
+ */
+static void balanceLoad(Smp *smp, SmpResult *result, int time) {
+    while (1) {
+        Cpu *busiest = NULL, *idlest = &smp->cpus[0];
+        for (int c = 0; c < smp->num_cpus; c++) {
+            Cpu *cpu = &smp->cpus[c];
+            if (cpu->queued > 0 && (!busiest || cpuLoad(cpu) > cpuLoad(busiest))) busiest = cpu;
+            if (cpuLoad(cpu) < cpuLoad(idlest)) idlest = cpu;
+        }
+        if (!busiest || cpuLoad(busiest) - cpuLoad(idlest) <= 1) return;
+        if (migrate(smp, busiest, idlest, time) != 0) return;
+        result->balanced++;
+    }
+}
+
+/**
+ * @brief Frees everything simulateSmp allocated, stopping the CPU threads first.
+ */
+static void smpCleanup(Smp *smp, int *order) {
+    if (smp->threads > 0) {
+        pthread_mutex_lock(&smp->lock);
+        smp->stop = 1;
+        pthread_cond_broadcast(&smp->wake);
+        pthread_mutex_unlock(&smp->lock);
+        for (int c = 0; c < smp->threads; c++) pthread_join(smp->cpus[c].thread, NULL);
+    }
+    pthread_mutex_destroy(&smp->lock);
+    pthread_cond_destroy(&smp->wake);
+    pthread_cond_destroy(&smp->finished);
+    for (int c = 0; smp->cpus && c < smp->num_cpus; c++) {
+        if (smp->cpus[c].state) smp->policy->destroy(smp->cpus[c].state);
+        free(smp->cpus[c].arrivals);
+    }
+    free(smp->cpus);
+    free(smp->first_run);
+    free(smp->penalty);
+    free(order);
+}
+
+int simulateSmp(const Policy *policy, Process proc[], int num_processes, const PolicyParams *params,
+                const SmpConfig *config, SmpResult *result) {
+    Smp smp = { .policy = policy, .proc = proc, .num_cpus = config->cpus, .migration_cost = config->migration_cost,
+                .switch_cost = params->switch_cost, .dispatch_cost = params->dispatch_cost };
+    int *order = NULL, next = 0, completed = 0;
+
+    memset(result, 0, sizeof(*result));
+    pthread_mutex_init(&smp.lock, NULL);
+    pthread_cond_init(&smp.wake, NULL);
+    pthread_cond_init(&smp.finished, NULL);
+    if (config->cpus < 1 || config->epoch < 1 || config->migration_cost < 0 || config->balance_interval < 0) {
+        printf("Invalid SMP parameters\n");
+        smpCleanup(&smp, NULL);
+        return -1;
+    }
+    for (int i = 0; i < num_processes; i++) {
+        if (proc[i].num_bursts > 1) {
+            printf("I/O bursts are only simulated on one CPU\n");
+            smpCleanup(&smp, NULL);
+            return -1;
+        }
+    }
+    result->summary.policy = policy;
+    result->summary.num_processes = num_processes;
+    result->summary.cpus = config->cpus;
+    result->cpus = config->cpus;
+    result->cpu = (SmpCpuStats*)calloc(config->cpus, sizeof(SmpCpuStats));
+
+    order = sortByArrival(proc, num_processes);
+    smp.first_run = (int*)malloc((num_processes > 0 ? num_processes : 1) * sizeof(int));
+    smp.penalty = (int*)calloc(num_processes > 0 ? num_processes : 1, sizeof(int));
+    smp.cpus = (Cpu*)calloc(config->cpus, sizeof(Cpu));
+    int ok = result->cpu && order && smp.first_run && smp.penalty && smp.cpus;
+    for (int c = 0; ok && c < config->cpus; c++) {
+        smp.cpus[c].running = smp.cpus[c].last_index = -1;
+        smp.cpus[c].smp = &smp;
+        ok = policy->init(&smp.cpus[c].state, proc, num_processes, params) == 0;
+    }
+    if (!ok) {
+        printf("Memory allocation failed\n");
+        smpCleanup(&smp, order);
+        smpResultFree(result);
+        return -1;
+    }
+    for (int i = 0; i < num_processes; i++) smp.first_run[i] = -1;
+
+    // CPUs without a thread of their own (all of them unless threaded) are advanced by this thread.
+    while (config->threads && smp.threads < config->cpus &&
+           pthread_create(&smp.cpus[smp.threads].thread, NULL, cpuThread, &smp.cpus[smp.threads]) == 0) {
+        smp.threads++;
+    }
+
+    double start = wallClockMs();
+    int time = 0, next_balance = config->balance_interval;
+    while (completed < num_processes) {
+        // Nothing queued or running anywhere: jump to the next arrival.
+        int idle = 1;
+        for (int c = 0; c < smp.num_cpus; c++) {
+            if (smp.cpus[c].queued > 0 || smp.cpus[c].running != -1) idle = 0;
+        }
+        if (idle && next < num_processes && proc[order[next]].arrival_time > time) time = proc[order[next]].arrival_time;
+        smp.epoch_end = (time > INT_MAX - config->epoch) ? INT_MAX : time + config->epoch;
+
+        // Place the epoch's arrivals, in arrival order, on the least loaded CPUs.
+        for (int c = 0; c < smp.num_cpus; c++) {
+            smp.cpus[c].num_arrivals = smp.cpus[c].next_arrival = 0;
+            smp.cpus[c].time = time;
+        }
+        while (next < num_processes && proc[order[next]].arrival_time < smp.epoch_end) {
+            Cpu *target = &smp.cpus[0];
+            for (int c = 1; c < smp.num_cpus; c++) {
+                if (cpuLoad(&smp.cpus[c]) < cpuLoad(target)) target = &smp.cpus[c];
+            }
+            if (placeArrival(target, order[next++]) != 0) {
+                printf("Memory allocation failed\n");
+                smpCleanup(&smp, order);
+                smpResultFree(result);
+                return -1;
+            }
+        }
+
+        stealWork(&smp, result, time);
+        if (config->balance_interval > 0 && time >= next_balance) {
+            balanceLoad(&smp, result, time);
+            next_balance = time + config->balance_interval;
+        }
+
+        runEpoch(&smp);
+
+        completed = 0;
+        for (int c = 0; c < smp.num_cpus; c++) completed += smp.cpus[c].completed;
+        time = smp.epoch_end;
+    }
+    result->summary.elapsed_ms = wallClockMs() - start;
+
+    for (int c = 0; c < smp.num_cpus; c++) {
+        Cpu *cpu = &smp.cpus[c];
+        if (cpu->running != -1) policy->onTick(cpu->state, cpu->running, cpu->ran, cpu->time);
+        result->cpu[c] = cpu->stats;
+        result->summary.busy += cpu->stats.busy;
+        result->summary.overhead += cpu->stats.overhead;
+        result->summary.decisions += cpu->decisions;
+        result->summary.context_switches += cpu->switches;
+    }
+    summarizeRun(proc, num_processes, smp.first_run, &result->summary);
+    smpCleanup(&smp, order);
+    return 0;
+}
+
+void smpResultFree(SmpResult *result) {
+    free(result->cpu);
+    result->cpu = NULL;
+}
@@ -0,0 +1,79 @@
+//smp.h
+
+#ifndef SMP_H
+#define SMP_H
+
+#include "simulate.h"
+
+
+/**
+ * @struct SmpConfig
+ * @brief Machine and balancing parameters of a multi-CPU simulation.
+ */
+typedef struct {
+  int cpus;              /**< Number of CPUs, each with its own runqueue (policy instance). */
+  int migration_cost;    /**< Time a CPU stalls before running a process that migrated to it. */
+  int epoch;             /**< Time between balancing points; idle CPUs steal work at every one. */
+  int balance_interval;  /**< Time between periodic runqueue balancing passes (0 disables them). */
+  int threads;           /**< 1 to advance the CPUs on their own threads within each epoch. */
+} SmpConfig;
+
+
+/**
+ * @struct SmpCpuStats
+ * @brief Per-CPU counters of a multi-CPU simulation.
+ */
+typedef struct {
+  long long busy;            /**< Time spent running processes. */
+  long long stall;           /**< Time spent paying migration costs. */
+  long long overhead;        /**< Time spent on dispatches and context switches. */
+  long long dispatches;      /**< Processes dispatched. */
+  long long migrations_in;   /**< Processes moved onto this CPU's runqueue. */
+  long long migrations_out;  /**< Processes moved off this CPU's runqueue. */
+} SmpCpuStats;
+
+
+/**
+ * @struct SmpResult
+ * @brief Summary of a multi-CPU run.
+ */
+typedef struct {
+  SimResult summary;      /**< Whole-machine statistics (busy is summed over CPUs). */
+  int cpus;               /**< Number of CPUs. */
+  SmpCpuStats *cpu;       /**< Per-CPU counters (free with smpResultFree). */
+  long long steals;       /**< Processes pulled by idle CPUs. */
+  long long balanced;     /**< Processes moved by periodic balancing. */
+} SmpResult;
+
+
+/**
+ * @brief Runs a policy on several CPUs with per-CPU runqueues.
+ * - Time advances in epochs of config->epoch. At the start of each epoch the
+ *   new arrivals of the epoch are placed on the least-loaded CPUs, idle CPUs
+ *   steal one process from the most loaded runqueue, and (every
+ *   balance_interval) runqueues are evened out. Within an epoch each CPU runs
+ *   its own runqueue exactly as simulate() does; a preemptive policy is
+ *   preempted only by arrivals on its own CPU.
+ * - Placement and balancing depend only on the state at epoch boundaries, so
+ *   the threaded and single-threaded runs give identical results.
+ * - With one CPU the schedule is the same as simulate().
+ * - I/O bursts are not modelled on several CPUs: workloads with burst lists are rejected.
+ * @param policy Policy to run (one instance per CPU).
+ * @param proc Array of processes (modified).
+ * @param num_processes Number of processes.
+ * @param params Tunables passed to every policy instance.
+ * @param config Machine parameters.
+ * @param result Output: summary of the run.
+ * @return 0 on success, -1 on invalid parameters, I/O bursts or allocation failure.
+ */
+int simulateSmp(const Policy *policy, Process proc[], int num_processes, const PolicyParams *params,
+                const SmpConfig *config, SmpResult *result);
+
+
+/**
+ * @brief Releases the per-CPU counters of a result.
+ * @param result Result to free.
+ */
+void smpResultFree(SmpResult *result);
+
+#endif // SMP_H
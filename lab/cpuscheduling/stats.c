@@ -0,0 +1,77 @@
+#include <string.h>
+#include <limits.h>
+#include "stats.h"
+
+/**
+ * @brief Returns the bucket of a value.
+ * - Above SKETCH_EXACT the bucket is the position of the leading bit plus the
+ *   SKETCH_SUB_BITS bits that follow it.
+ */
+static int bucketOf(int value) {
+    if (value < SKETCH_EXACT) return value;
+    int exponent = 31 - __builtin_clz((unsigned)value);
+    int shift = exponent - SKETCH_SUB_BITS;
+    int mantissa = (value >> shift) - (1 << SKETCH_SUB_BITS);
+    return SKETCH_EXACT + (shift - 1) * (1 << SKETCH_SUB_BITS) + mantissa;
+}
+
+/**
+ * @brief Returns the middle of the range of values a bucket holds.
+ */
+static double bucketMiddle(int bucket) {
+    if (bucket < SKETCH_EXACT) return bucket;
+    int shift = (bucket - SKETCH_EXACT) / (1 << SKETCH_SUB_BITS) + 1;
+    int mantissa = (bucket - SKETCH_EXACT) % (1 << SKETCH_SUB_BITS) + (1 << SKETCH_SUB_BITS);
+    double low = (double)mantissa * (1 << shift);
+    return low + ((1 << shift) - 1) / 2.0;
+}
+
+void sketchInit(QuantileSketch *sketch) {
+    memset(sketch, 0, sizeof(*sketch));
+    sketch->min = INT_MAX;
+}
+
+void sketchAdd(QuantileSketch *sketch, int value) {
+    if (value < 0) value = 0;
+    sketch->bucket[bucketOf(value)]++;
+    sketch->count++;
+    sketch->sum += value;
+    if (value < sketch->min) sketch->min = value;
+    if (value > sketch->max) sketch->max = value;
+}
+
+void sketchMerge(QuantileSketch *into, const QuantileSketch *from) {
+    for (int i = 0; i < SKETCH_BUCKETS; i++) into->bucket[i] += from->bucket[i];
+    into->count += from->count;
+    into->sum += from->sum;
+    if (from->min < into->min) into->min = from->min;
+    if (from->max > into->max) into->max = from->max;
+}
+
+double sketchQuantile(const QuantileSketch *sketch, double q) {
+    if (sketch->count == 0) return 0;
+
+    long long rank = (long long)(q * sketch->count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank >= sketch->count) return sketch->max;
+
+    long long seen = 0;
+    int bucket = 0;
+    while (bucket < SKETCH_BUCKETS - 1 && (seen += sketch->bucket[bucket]) < rank) bucket++;
+
+    double value = bucketMiddle(bucket);
+    if (value < sketch->min) value = sketch->min;
+    if (value > sketch->max) value = sketch->max;
+    return value;
+}
+
+MetricSummary sketchSummary(const QuantileSketch *sketch) {
+    MetricSummary summary = { 0, 0, 0, 0, 0 };
+    if (sketch->count == 0) return summary;
+    summary.mean = (double)sketch->sum / sketch->count;
+    summary.p50 = sketchQuantile(sketch, 0.50);
+    summary.p95 = sketchQuantile(sketch, 0.95);
+    summary.p99 = sketchQuantile(sketch, 0.99);
+    summary.max = sketch->max;
+    return summary;
+}
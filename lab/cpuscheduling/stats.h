@@ -0,0 +1,82 @@
+//stats.h
+
+#ifndef STATS_H
+#define STATS_H
+
+#define SKETCH_SUB_BITS 6                                          /**< Buckets per power of two: 2^SKETCH_SUB_BITS. */
+#define SKETCH_EXACT (2 << SKETCH_SUB_BITS)                        /**< Values below this get a bucket each. */
+#define SKETCH_BUCKETS (SKETCH_EXACT + (31 - SKETCH_SUB_BITS - 1) * (1 << SKETCH_SUB_BITS))  /**< Buckets covering 0 .. INT_MAX. */
+
+
+/**
+ * @struct QuantileSketch
+ * @brief Constant-memory histogram of non-negative ints for approximate quantiles.
+ * Values below SKETCH_EXACT are counted exactly; larger values share
+ * log-linear buckets 1/64 of their power of two wide, so any quantile is off
+ * by less than 1.6% of its value. The mean, minimum and maximum are exact.
+ * Sketches of the same metric can be merged, e.g. across CPUs or runs.
+ */
+typedef struct {
+  long long count;                   /**< Values added. */
+  long long sum;                     /**< Sum of the values (for the exact mean). */
+  int min;                           /**< Smallest value added. */
+  int max;                           /**< Largest value added. */
+  long long bucket[SKETCH_BUCKETS];  /**< Values per bucket. */
+} QuantileSketch;
+
+
+/**
+ * @struct MetricSummary
+ * @brief Distribution of one per-process metric.
+ */
+typedef struct {
+  double mean;  /**< Exact mean. */
+  double p50;   /**< Median (approximate). */
+  double p95;   /**< 95th percentile (approximate). */
+  double p99;   /**< 99th percentile (approximate). */
+  double max;   /**< Exact maximum. */
+} MetricSummary;
+
+
+/**
+ * @brief Creates an empty sketch.
+ * @param sketch Sketch to initialize.
+ */
+void sketchInit(QuantileSketch *sketch);
+
+
+/**
+ * @brief Adds a value in O(1); negative values count as 0.
+ * @param sketch Quantile sketch.
+ * @param value Value to add.
+ */
+void sketchAdd(QuantileSketch *sketch, int value);
+
+
+/**
+ * @brief Adds every value of one sketch to another.
+ * @param into Sketch receiving the values.
+ * @param from Sketch to add.
+ */
+void sketchMerge(QuantileSketch *into, const QuantileSketch *from);
+
+
+/**
+ * @brief Returns the q-quantile (nearest rank) of the values added.
+ * - The result is the middle of the bucket holding that rank, clamped to the
+ *   exact minimum and maximum; the last rank returns the maximum itself.
+ * @param sketch Quantile sketch.
+ * @param q Quantile in [0, 1].
+ * @return The approximate quantile, or 0 if the sketch is empty.
+ */
+double sketchQuantile(const QuantileSketch *sketch, double q);
+
+
+/**
+ * @brief Summarizes a sketch as mean, p50, p95, p99 and max.
+ * @param sketch Quantile sketch.
+ * @return The summary (all zero if the sketch is empty).
+ */
+MetricSummary sketchSummary(const QuantileSketch *sketch);
+
+#endif // STATS_H
@@ -0,0 +1,113 @@
+#include <string.h>
+#include "trace.h"
+
+int log_level = LOG_EVENTS;
+TraceWriter *event_trace = NULL;
+
+/** Titles printed by TRACE_BEGIN, indexed by TraceSchedule. */
+static const char *const schedule_titles[TRACE_SCHEDULE_COUNT] = {
+    "Round Robin Scheduling",
+    "First-Come, First-Served (FCFS) Scheduling",
+    "Shortest Job First (Non-Preemptive)",
+    "Shortest Job First (Preemptive - Shortest Remaining Time First)",
+    "Priority Scheduling (Non-Preemptive)",
+    "Priority Scheduling (Preemptive)"
+};
+
+int parseLogLevel(const char *name) {
+    if (strcmp(name, "quiet") == 0) return LOG_QUIET;
+    if (strcmp(name, "summary") == 0) return LOG_SUMMARY;
+    if (strcmp(name, "events") == 0) return LOG_EVENTS;
+    return -1;
+}
+
+void traceRender(FILE *out, const TraceRecord *rec) {
+    switch (rec->type) {
+    case TRACE_BEGIN:
+        if (rec->arg0 < 0 || rec->arg0 >= TRACE_SCHEDULE_COUNT) {
+            fprintf(out, "\n=== Unknown scheduling run %d ===\n", rec->arg0);
+        } else if (rec->arg0 == TRACE_RR) {
+            fprintf(out, "\n=== %s, Quantum: %d ===\n", schedule_titles[rec->arg0], rec->arg1);
+        } else {
+            fprintf(out, "\n=== %s ===\n", schedule_titles[rec->arg0]);
+        }
+        break;
+    case TRACE_START:
+        fprintf(out, "Time %d: Process %d starts, (Burst time: %d)\n", rec->time, rec->process_id, rec->arg0);
+        break;
+    case TRACE_START_PRIORITY:
+        fprintf(out, "Time %d: Process %d starts (Burst time: %d) (Priority: %d)\n",
+                rec->time, rec->process_id, rec->arg0, rec->arg1);
+        break;
+    case TRACE_QUANTUM:
+        fprintf(out, "Time %d: Process %d completes quantum\n", rec->time, rec->process_id);
+        break;
+    case TRACE_COMPLETE:
+        fprintf(out, "Time %d: Process %d completes\n", rec->time, rec->process_id);
+        break;
+    default:
+        fprintf(out, "Time %d: Process %d: unknown event %d\n", rec->time, rec->process_id, rec->type);
+        break;
+    }
+}
+
+/**
+ * @brief Writes the buffered records to the file.
+ */
+static void traceFlush(TraceWriter *writer) {
+    if (writer->count > 0 && fwrite(writer->buffer, sizeof(TraceRecord), writer->count, writer->file)
+                                 != (size_t)writer->count) {
+        writer->failed = 1;
+    }
+    writer->count = 0;
+}
+
+int traceOpen(TraceWriter *writer, const char *path) {
+    TraceHeader header = { .record_size = sizeof(TraceRecord) };
+
+    writer->count = 0;
+    writer->total = 0;
+    writer->failed = 0;
+    if (!(writer->file = fopen(path, "wb"))) {
+        perror("Unable to create trace file");
+        return -1;
+    }
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    if (fwrite(&header, sizeof(header), 1, writer->file) != 1) {
+        printf("Unable to write trace file %s\n", path);
+        fclose(writer->file);
+        writer->file = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void traceWrite(TraceWriter *writer, const TraceRecord *rec) {
+    if (writer->count == TRACE_BUFFER_RECORDS) traceFlush(writer);
+    writer->buffer[writer->count++] = *rec;
+    writer->total++;
+}
+
+int traceClose(TraceWriter *writer) {
+    traceFlush(writer);
+    if (fclose(writer->file) != 0) writer->failed = 1;
+    writer->file = NULL;
+    return writer->failed ? -1 : 0;
+}
+
+FILE *traceOpenRead(const char *path) {
+    TraceHeader header;
+    FILE *in = fopen(path, "rb");
+
+    if (!in) {
+        perror("Unable to open trace file");
+        return NULL;
+    }
+    if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(TraceRecord)) {
+        printf("%s is not an event trace (or was written with another record size)\n", path);
+        fclose(in);
+        return NULL;
+    }
+    return in;
+}
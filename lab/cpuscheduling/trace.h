@@ -0,0 +1,166 @@
+//trace.h
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define TRACE_MAGIC "SCHEDTR1"         /**< First 8 bytes of a binary event trace. */
+#define TRACE_BUFFER_RECORDS 4096      /**< Records buffered before each write. */
+
+#define LOG_QUIET 0                    /**< Only load and scheduling times (and errors). */
+#define LOG_SUMMARY 1                  /**< Also run headers, Gantt charts and process tables. */
+#define LOG_EVENTS 2                   /**< Also one line per start, preemption and completion. */
+
+// Highest output level compiled in; build with -DSCHED_LOG_LEVEL=LOG_QUIET to drop all log code.
+#ifndef SCHED_LOG_LEVEL
+#define SCHED_LOG_LEVEL LOG_EVENTS
+#endif
+
+/**
+ * @brief True when output of the given level is compiled in and selected at run time.
+ * Levels above SCHED_LOG_LEVEL fold to 0, so the code they guard is removed.
+ */
+#define LOG_ENABLED(level) (SCHED_LOG_LEVEL >= (level) && log_level >= (level))
+
+/**
+ * @brief Output level at which an event kind is printed: run headers with the
+ * summary, everything else with the events.
+ */
+#define TRACE_EVENT_LEVEL(type) ((type) == TRACE_BEGIN ? LOG_SUMMARY : LOG_EVENTS)
+
+/**
+ * @brief Logs one scheduler event: prints it if its level is enabled and
+ * appends it to event_trace if one is open.
+ */
+#define LOG_EVENT(type, time, process_id, arg0, arg1)                                  \
+    do {                                                                               \
+        if (LOG_ENABLED(TRACE_EVENT_LEVEL(type)) || event_trace) {                     \
+            TraceRecord log_rec_ = { (type), (time), (process_id), (arg0), (arg1) };   \
+            if (LOG_ENABLED(TRACE_EVENT_LEVEL(type))) traceRender(stdout, &log_rec_);  \
+            if (event_trace) traceWrite(event_trace, &log_rec_);                       \
+        }                                                                              \
+    } while (0)
+
+
+/**
+ * @enum TraceEvent
+ * @brief Kinds of trace records, with the meaning of their arguments.
+ */
+typedef enum {
+  TRACE_BEGIN,           /**< A scheduling run starts: arg0 is its TraceSchedule, arg1 its quantum. */
+  TRACE_START,           /**< A process starts: arg0 is its remaining burst time. */
+  TRACE_START_PRIORITY,  /**< As TRACE_START, with arg1 the priority (printed by the priority schedulers). */
+  TRACE_QUANTUM,         /**< An unfinished process is switched out. */
+  TRACE_COMPLETE,        /**< A process completes. */
+  TRACE_EVENT_COUNT      /**< Number of event kinds. */
+} TraceEvent;
+
+
+/**
+ * @enum TraceSchedule
+ * @brief Scheduling runs named in TRACE_BEGIN records.
+ */
+typedef enum {
+  TRACE_RR,                   /**< Round Robin. */
+  TRACE_FCFS,                 /**< First-Come, First-Served. */
+  TRACE_SJF,                  /**< Shortest Job First (non-preemptive). */
+  TRACE_SRTF,                 /**< Shortest Remaining Time First. */
+  TRACE_PRIORITY,             /**< Priority (non-preemptive). */
+  TRACE_PRIORITY_PREEMPTIVE,  /**< Priority (preemptive). */
+  TRACE_SCHEDULE_COUNT        /**< Number of schedules. */
+} TraceSchedule;
+
+
+/**
+ * @struct TraceHeader
+ * @brief Header of a binary event trace, followed by TraceRecord entries up to
+ * the end of the file (host byte order, as written).
+ */
+typedef struct {
+  char magic[8];         /**< TRACE_MAGIC. */
+  uint32_t record_size;  /**< sizeof(TraceRecord). */
+  uint32_t reserved;     /**< Zero. */
+} TraceHeader;
+
+
+/**
+ * @struct TraceRecord
+ * @brief One fixed-size event of a binary trace.
+ */
+typedef struct {
+  int32_t type;          /**< TraceEvent. */
+  int32_t time;          /**< Simulated time of the event. */
+  int32_t process_id;    /**< Process concerned (unused by TRACE_BEGIN). */
+  int32_t arg0;          /**< First argument (see TraceEvent). */
+  int32_t arg1;          /**< Second argument (see TraceEvent). */
+} TraceRecord;
+
+
+/**
+ * @struct TraceWriter
+ * @brief Buffered writer of a binary event trace.
+ */
+typedef struct {
+  FILE *file;                                 /**< Trace file. */
+  TraceRecord buffer[TRACE_BUFFER_RECORDS];   /**< Records not yet written. */
+  int count;                                  /**< Entries in buffer. */
+  long long total;                            /**< Records traced so far. */
+  int failed;                                 /**< 1 once a write has failed. */
+} TraceWriter;
+
+
+extern int log_level;               /**< Output level selected at run time (default LOG_EVENTS). */
+extern TraceWriter *event_trace;    /**< Trace receiving LOG_EVENT records, or NULL. */
+
+
+/**
+ * @brief Parses an output level name: "quiet", "summary" or "events".
+ * @param name Level name.
+ * @return The level, or -1 if the name is unknown.
+ */
+int parseLogLevel(const char *name);
+
+
+/**
+ * @brief Prints one record in the schedulers' human-readable log format.
+ * @param out Destination stream.
+ * @param rec Record to print.
+ */
+void traceRender(FILE *out, const TraceRecord *rec);
+
+
+/**
+ * @brief Creates a trace file and writes its header.
+ * @param writer Writer to initialize (about 80 KiB, so not meant for the stack).
+ * @param path File to create.
+ * @return 0 on success, -1 on failure (a message is printed).
+ */
+int traceOpen(TraceWriter *writer, const char *path);
+
+
+/**
+ * @brief Appends one record; the buffer is written out when full.
+ * @param writer Open writer.
+ * @param rec Record to append.
+ */
+void traceWrite(TraceWriter *writer, const TraceRecord *rec);
+
+
+/**
+ * @brief Writes the buffered records and closes the file.
+ * @param writer Open writer.
+ * @return 0 if every record was written, -1 otherwise.
+ */
+int traceClose(TraceWriter *writer);
+
+
+/**
+ * @brief Opens a trace file for reading and checks its header.
+ * @param path File to open.
+ * @return The stream positioned at the first record, or NULL (a message is printed).
+ */
+FILE *traceOpenRead(const char *path);
+
+#endif // TRACE_H
@@ -0,0 +1,60 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include "trace.h"
+
+/**
+ * @brief Main function of the offline trace renderer.
+ * - Usage: ./trace_render_exec [-o output_file] trace_file
+ * - Reads a binary event trace written by a scheduler's -t option and prints
+ *   it in the schedulers' human-readable log format (to stdout by default).
+ * - Records are read in chunks of TRACE_BUFFER_RECORDS, so any trace size
+ *   renders in constant memory.
+ */
+int main(int argc, char *argv[]) {
+    const char *out_path = NULL;
+    FILE *in, *out = stdout;
+    long long records = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        if (opt == 'o') {
+            out_path = optarg;
+        } else {
+            optind = argc + 1;
+            break;
+        }
+    }
+    if (optind != argc - 1) {
+        printf("Usage: %s [-o output_file] trace_file\n", argv[0]);
+        return 1;
+    }
+    if (!(in = traceOpenRead(argv[optind]))) return 1;
+    if (out_path && !(out = fopen(out_path, "w"))) {
+        perror("Unable to open output file");
+        fclose(in);
+        return 1;
+    }
+
+    TraceRecord *chunk = (TraceRecord*)malloc(TRACE_BUFFER_RECORDS * sizeof(TraceRecord));
+    if (!chunk) {
+        printf("Memory allocation failed\n");
+        fclose(in);
+        if (out_path) fclose(out);
+        return 1;
+    }
+    size_t n;
+    while ((n = fread(chunk, sizeof(TraceRecord), TRACE_BUFFER_RECORDS, in)) > 0) {
+        for (size_t i = 0; i < n; i++) traceRender(out, &chunk[i]);
+        records += n;
+    }
+    int status = ferror(in) ? 1 : 0;
+    if (status) printf("Error reading %s after %lld records\n", argv[optind], records);
+
+    free(chunk);
+    fclose(in);
+    if (out_path) {
+        if (fclose(out) != 0) status = 1;
+        printf("Rendered %lld records to %s\n", records, out_path);
+    }
+    return status;
+}
@@ -0,0 +1,305 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "workload.h"
+
+#define CSV_BUFFER_SIZE (1 << 20)   /**< stdio buffer for CSV input. */
+#define CSV_LINE_MAX 4096           /**< Longest accepted CSV line. */
+
+/**
+ * @brief Fills a process from the fields of one record.
+ */
+static void setProcess(Process *p, int process_id, int arrival_time, int burst_time, int priority) {
+    initializeProcess(p);
+    p->process_id = process_id;
+    p->arrival_time = arrival_time;
+    p->burst_time = burst_time;
+    p->remaining_time = burst_time;
+    p->priority = priority;
+}
+
+/**
+ * @brief Parses a burst list ("cpu io cpu ...") into the arena, or only sums it without one.
+ * @return 0 on success, -1 if the list is malformed.
+ */
+static int parseBursts(WorkloadReader *reader, const char *s, Process *p) {
+    int lengths[WORKLOAD_MAX_BURSTS], n = 0;
+    long long cpu = 0, io = 0;
+
+    while (*s && *s != '\n' && *s != '\r') {
+        char *end;
+        long value = strtol(s, &end, 10);
+        if (end == s || value <= 0 || value > INT_MAX || n == WORKLOAD_MAX_BURSTS) return -1;
+        if (n % 2 == 0) cpu += value;
+        else io += value;
+        lengths[n++] = (int)value;
+        s = end;
+        while (*s == ' ' || *s == '\t') s++;
+    }
+    if (n % 2 == 0 || cpu > INT_MAX || io > INT_MAX) return -1;
+
+    p->burst_time = (int)cpu;
+    p->remaining_time = (int)cpu;
+    if (!reader->arena || n == 1) return 0;
+
+    int *bursts = (int*)arenaAlloc(reader->arena, n * sizeof(int), sizeof(int));
+    if (!bursts) return -1;
+    memcpy(bursts, lengths, n * sizeof(int));
+    p->bursts = bursts;
+    p->num_bursts = n;
+    p->io_time = (int)io;
+    p->remaining_time = bursts[0];
+    return 0;
+}
+
+/**
+ * @brief Parses one integer field; advances *s past it and the blanks after it.
+ * @return 0 on success, -1 if no number is present.
+ */
+static int parseField(char **s, long *value) {
+    char *end;
+    errno = 0;
+    *value = strtol(*s, &end, 10);
+    if (end == *s || errno == ERANGE || *value < INT_MIN || *value > INT_MAX) return -1;
+    while (*end == ' ' || *end == '\t') end++;
+    *s = end;
+    return 0;
+}
+
+/**
+ * @brief Tells whether only the end of the line is left: nothing, or a newline (after an optional CR).
+ */
+static int atLineEnd(const char *s) {
+    if (*s == '\r') s++;
+    return *s == '\n' || *s == '\0';
+}
+
+/**
+ * @brief Reads the next chunk of a CSV file.
+ */
+static int readCsv(WorkloadReader *reader, Process out[], int max) {
+    char line[CSV_LINE_MAX];
+    int n = 0;
+
+    while (n < max && fgets(line, sizeof(line), reader->csv)) {
+        reader->line++;
+        size_t length = strlen(line);
+        if (length > 0 && line[length - 1] != '\n') {
+            // Only the last line of the file may end without a newline; otherwise fgets() split a long line.
+            int next = getc(reader->csv);
+            if (next != EOF) {
+                printf("%s:%ld: line longer than %d characters\n", reader->path, reader->line, CSV_LINE_MAX - 2);
+                return -1;
+            }
+        }
+        char *s = line;
+        while (*s == ' ' || *s == '\t') s++;
+        if (*s == '#' || *s == '\n' || *s == '\r' || *s == '\0') continue;
+
+        long field[4] = { 0, 0, 0, 0 };
+        int fields = 0, comma = 0;
+        while (fields < 4 && parseField(&s, &field[fields]) == 0) {
+            fields++;
+            comma = *s == ',';
+            if (!comma) break;
+            s++;
+        }
+
+        // The first line may be a header such as "pid,arrival,burst,priority".
+        if (fields == 0 && reader->line == 1) continue;
+        // After the last field only the end of the line may follow, or the bursts after ",".
+        while (*s == ' ' || *s == '\t') s++;
+        int has_bursts = fields == 4 && comma && !atLineEnd(s);
+        if (fields < 3 || (!has_bursts && (comma || !atLineEnd(s))) || field[1] < 0 ||
+            (field[2] <= 0 && !has_bursts)) {
+            printf("%s:%ld: expected process_id,arrival_time,burst_time[,priority[,bursts]] "
+                   "with arrival >= 0 and burst > 0\n", reader->path, reader->line);
+            return -1;
+        }
+        setProcess(&out[n], (int)field[0], (int)field[1], (int)field[2], (int)field[3]);
+        if (has_bursts && parseBursts(reader, s, &out[n]) != 0) {
+            printf("%s:%ld: bursts must be an odd number (at most %d) of positive lengths, CPU first\n",
+                   reader->path, reader->line, WORKLOAD_MAX_BURSTS);
+            return -1;
+        }
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Maps the next window of a binary file and converts its records.
+ */
+static int readBinary(WorkloadReader *reader, Process out[], int max) {
+    uint64_t left = reader->count - reader->next;
+    int n = (left < (uint64_t)max) ? (int)left : max;
+    if (n > WORKLOAD_CHUNK_RECORDS) n = WORKLOAD_CHUNK_RECORDS;
+    if (n == 0) return 0;
+
+    // mmap offsets must be page aligned: map from the page holding the first record.
+    long page = sysconf(_SC_PAGESIZE);
+    off_t first = (off_t)(sizeof(WorkloadHeader) + reader->next * sizeof(WorkloadRecord));
+    off_t base = first - first % page;
+    size_t length = (size_t)(first - base) + (size_t)n * sizeof(WorkloadRecord);
+
+    unsigned char *map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, reader->fd, base);
+    if (map == MAP_FAILED) {
+        perror("mmap failed");
+        return -1;
+    }
+    madvise(map, length, MADV_SEQUENTIAL);
+
+    const WorkloadRecord *rec = (const WorkloadRecord *)(map + (first - base));
+    for (int i = 0; i < n; i++) {
+        if (rec[i].arrival_time < 0 || rec[i].burst_time <= 0) {
+            printf("%s: record %llu has arrival %d and burst %d\n", reader->path,
+                   (unsigned long long)(reader->next + i), rec[i].arrival_time, rec[i].burst_time);
+            munmap(map, length);
+            return -1;
+        }
+        setProcess(&out[i], rec[i].process_id, rec[i].arrival_time, rec[i].burst_time, rec[i].priority);
+    }
+    munmap(map, length);
+    reader->next += (uint64_t)n;
+    return n;
+}
+
+int workloadOpen(WorkloadReader *reader, const char *path) {
+    WorkloadHeader header;
+    struct stat st;
+
+    memset(reader, 0, sizeof(*reader));
+    reader->path = path;
+    reader->fd = open(path, O_RDONLY);
+    if (reader->fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    if (fstat(reader->fd, &st) == 0 && (size_t)st.st_size >= sizeof(header) &&
+        pread(reader->fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+        memcmp(header.magic, WORKLOAD_MAGIC, sizeof(header.magic)) == 0) {
+        if (header.record_size != sizeof(WorkloadRecord) ||
+            (uint64_t)st.st_size < sizeof(header) + header.count * sizeof(WorkloadRecord)) {
+            printf("%s: truncated or incompatible binary workload\n", path);
+            close(reader->fd);
+            return -1;
+        }
+        reader->binary = 1;
+        reader->count = header.count;
+        return 0;
+    }
+
+    // Not binary: read it as CSV.
+    close(reader->fd);
+    reader->fd = -1;
+    reader->csv = fopen(path, "r");
+    if (!reader->csv) {
+        perror(path);
+        return -1;
+    }
+    reader->csv_buffer = (char*)malloc(CSV_BUFFER_SIZE);
+    if (reader->csv_buffer) setvbuf(reader->csv, reader->csv_buffer, _IOFBF, CSV_BUFFER_SIZE);
+    return 0;
+}
+
+int workloadRead(WorkloadReader *reader, Process out[], int max) {
+    return reader->binary ? readBinary(reader, out, max) : readCsv(reader, out, max);
+}
+
+void workloadClose(WorkloadReader *reader) {
+    if (reader->csv) fclose(reader->csv);
+    if (reader->fd >= 0) close(reader->fd);
+    free(reader->csv_buffer);
+    reader->csv = NULL;
+    reader->csv_buffer = NULL;
+    reader->fd = -1;
+}
+
+int workloadLoad(const char *path, Process **proc, int *num_processes) {
+    return workloadLoadBursts(path, proc, num_processes, NULL);
+}
+
+int workloadLoadBursts(const char *path, Process **proc, int *num_processes, Arena *arena) {
+    WorkloadReader reader;
+    if (workloadOpen(&reader, path) != 0) return -1;
+    reader.arena = arena;
+
+    // Binary files know their size up front; CSV arrays grow as chunks arrive.
+    if (reader.binary && reader.count > (uint64_t)INT_MAX) {
+        printf("%s: %llu processes is more than this simulator supports\n", path,
+               (unsigned long long)reader.count);
+        workloadClose(&reader);
+        return -1;
+    }
+    int capacity = reader.binary ? (int)reader.count : WORKLOAD_CHUNK_RECORDS;
+    int n = 0, got = 0;
+    Process *array = (Process*)malloc((capacity > 0 ? capacity : 1) * sizeof(Process));
+
+    while (array) {
+        if (n + WORKLOAD_CHUNK_RECORDS > capacity && !reader.binary) {
+            capacity = (capacity > INT_MAX / 2) ? INT_MAX : capacity * 2;
+            Process *grown = (Process*)realloc(array, capacity * sizeof(Process));
+            if (!grown) {
+                free(array);
+                array = NULL;
+                break;
+            }
+            array = grown;
+        }
+        int room = capacity - n;
+        got = workloadRead(&reader, array + n, room < WORKLOAD_CHUNK_RECORDS ? room : WORKLOAD_CHUNK_RECORDS);
+        if (got <= 0) break;
+        n += got;
+    }
+    workloadClose(&reader);
+
+    if (!array) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    if (got < 0 || n == 0) {
+        if (n == 0 && got == 0) printf("%s: no processes\n", path);
+        free(array);
+        return -1;
+    }
+    *proc = array;
+    *num_processes = n;
+    return 0;
+}
+
+int workloadWriteBinary(const char *path, Process proc[], int num_processes) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    WorkloadHeader header = { .record_size = sizeof(WorkloadRecord), .count = (uint64_t)num_processes };
+    memcpy(header.magic, WORKLOAD_MAGIC, sizeof(header.magic));
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    for (int i = 0; ok && i < num_processes; i++) {
+        WorkloadRecord rec = { proc[i].process_id, proc[i].arrival_time, proc[i].burst_time, proc[i].priority };
+        ok = fwrite(&rec, sizeof(rec), 1, f) == 1;
+    }
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+void workloadReset(Process proc[], int num_processes) {
+    for (int i = 0; i < num_processes; i++) {
+        proc[i].remaining_time = proc[i].bursts ? proc[i].bursts[0] : proc[i].burst_time;
+        proc[i].completion_time = 0;
+        proc[i].is_completed = 0;
+    }
+}
+
+double wallClockMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
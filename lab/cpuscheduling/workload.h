@@ -0,0 +1,143 @@
+//workload.h
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "process.h"
+#include "arena.h"
+
+#define WORKLOAD_MAGIC "SCHEDWL1"        /**< First 8 bytes of a binary workload file. */
+#define WORKLOAD_CHUNK_RECORDS 65536     /**< Records converted per read (and per mapped window). */
+#define WORKLOAD_MAX_BURSTS 255          /**< Longest CPU/I-O burst list of one process. */
+
+
+/**
+ * @struct WorkloadHeader
+ * @brief Header of a binary workload file.
+ * The header is followed by `count` WorkloadRecord entries (little-endian, as written).
+ */
+typedef struct {
+  char magic[8];         /**< WORKLOAD_MAGIC. */
+  uint32_t record_size;  /**< sizeof(WorkloadRecord). */
+  uint32_t reserved;     /**< Zero. */
+  uint64_t count;        /**< Number of records. */
+} WorkloadHeader;
+
+
+/**
+ * @struct WorkloadRecord
+ * @brief One process in a binary workload file.
+ */
+typedef struct {
+  int32_t process_id;    /**< Unique identifier for the process. */
+  int32_t arrival_time;  /**< Time at which the process arrives. */
+  int32_t burst_time;    /**< Total CPU time required. */
+  int32_t priority;      /**< Priority (lower number means higher priority). */
+} WorkloadRecord;
+
+
+/**
+ * @struct WorkloadReader
+ * @brief Chunked reader over a CSV or binary workload file.
+ * CSV is read line by line through a large stdio buffer. Binary files are
+ * mapped one window at a time, so only the chunk being converted is mapped.
+ */
+typedef struct {
+  const char *path;      /**< File being read (for messages). */
+  int binary;            /**< 1 for the binary format, 0 for CSV. */
+  FILE *csv;             /**< CSV stream. */
+  char *csv_buffer;      /**< stdio buffer of the CSV stream. */
+  long line;             /**< Current CSV line number. */
+  int fd;                /**< Binary file descriptor. */
+  uint64_t count;        /**< Records in the binary file. */
+  uint64_t next;         /**< Next binary record to read. */
+  Arena *arena;          /**< Receives CSV burst lists, or NULL to collapse them into one CPU burst. */
+} WorkloadReader;
+
+
+/**
+ * @brief Opens a workload file; the format is detected from its first bytes.
+ * - CSV lines are "process_id,arrival_time,burst_time[,priority[,bursts]]";
+ *   blank lines, lines starting with '#' and a non-numeric header line are skipped.
+ *   Anything but blanks after the last field, and lines longer than 4094
+ *   characters, are rejected with their line number.
+ * - bursts is a space-separated list of alternating CPU and I/O burst lengths,
+ *   CPU first and last (e.g. "4 10 3"); burst_time is then ignored and set
+ *   to the sum of the CPU bursts. Set reader->arena after opening to keep the lists; without an
+ *   arena each process gets a single CPU burst of that sum.
+ * - Binary files hold single CPU bursts.
+ * @param reader Reader to initialize.
+ * @param path File to open.
+ * @return 0 on success, -1 on failure (a message is printed).
+ */
+int workloadOpen(WorkloadReader *reader, const char *path);
+
+
+/**
+ * @brief Reads the next chunk of processes.
+ * - Each process is initialized and its remaining_time set to its burst time.
+ * @param reader Open reader.
+ * @param out Destination array.
+ * @param max Capacity of out.
+ * @return Number of processes read, 0 at end of file, or -1 on a malformed record.
+ */
+int workloadRead(WorkloadReader *reader, Process out[], int max);
+
+
+/**
+ * @brief Closes a reader.
+ * @param reader Reader to close.
+ */
+void workloadClose(WorkloadReader *reader);
+
+
+/**
+ * @brief Loads a whole workload file into a newly allocated process array.
+ * - Burst lists are collapsed into single CPU bursts (see workloadLoadBursts()).
+ * @param path File to load.
+ * @param proc Output: array of processes (free with free()).
+ * @param num_processes Output: number of processes.
+ * @return 0 on success, -1 on failure (a message is printed).
+ */
+int workloadLoad(const char *path, Process **proc, int *num_processes);
+
+
+/**
+ * @brief Loads a whole workload file, keeping CPU/I-O burst lists.
+ * @param path File to load.
+ * @param proc Output: array of processes (free with free()).
+ * @param num_processes Output: number of processes.
+ * @param arena Initialized arena that receives the burst lists (free with
+ *        arenaFree() once the processes are no longer used).
+ * @return 0 on success, -1 on failure (a message is printed).
+ */
+int workloadLoadBursts(const char *path, Process **proc, int *num_processes, Arena *arena);
+
+
+/**
+ * @brief Writes processes to a binary workload file.
+ * @param path File to create.
+ * @param proc Array of processes.
+ * @param num_processes Number of processes.
+ * @return 0 on success, -1 on failure.
+ */
+int workloadWriteBinary(const char *path, Process proc[], int num_processes);
+
+
+/**
+ * @brief Restores every process to its not-yet-scheduled state (at its first CPU burst).
+ * @param proc Array of processes.
+ * @param num_processes Number of processes.
+ */
+void workloadReset(Process proc[], int num_processes);
+
+
+/**
+ * @brief Reads a monotonic clock.
+ * @return Milliseconds since an arbitrary fixed point.
+ */
+double wallClockMs(void);
+
+#endif // WORKLOAD_H
@@ -0,0 +1,291 @@
+#define _POSIX_C_SOURCE 200809L
+#include "Daniel_libFS.h"
+#include <time.h>   // For clock_gettime()
+
+
+#define LOOKUPS 100000   // Random open/close pairs timed at each size
+#define SMALL_SIZE 100    // Contents of every file (stored inline in its inode)
+#define LARGE_FILES 1000  // Files rewritten with LARGE_SIZE bytes (stored in extents)
+#define LARGE_SIZE 20000
+#define HOT_FILES 400     // Large files re-read to check that cached data never touches the disk
+#define DATA_BLOCKS 8192  // Data blocks of the benchmark image beyond what LARGE_FILES need
+#define STREAM_BUFFER 4096   // Buffer size of the streaming test
+#define STREAM_BUFFERS 4096  // Buffers streamed through one file (16 MiB)
+
+
+// Current time in milliseconds
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Small deterministic random generator (xorshift), so runs are comparable
+static unsigned long long rng_state = 88172645463325252ULL;
+static unsigned int nextRandom(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned int)(rng_state >> 32);
+}
+
+// Name of the i-th benchmark file
+static void benchName(char *name, int i) {
+    snprintf(name, MAX_FILENAME, "f%07d", i);
+}
+
+
+
+// Fill a buffer with contents that identify file i
+static void fillData(char *data, int length, int i) {
+    char c = (char)('a' + i % 26);
+    for (int k = 0; k < length; k++) {
+        data[k] = c;
+        c = c == 'z' ? 'a' : c + 1;
+    }
+    data[length] = '\0';
+}
+
+// Open, read and check the contents of file i
+static int checkFile(int i, int length, char *expected, char *buffer) {
+    char name[MAX_FILENAME];
+    benchName(name, i);
+    fillData(expected, length, i);
+    int f = fileOpen(name);
+    int n = f == -1 ? -1 : fileRead(f, buffer, length + 1);
+    if (f != -1) {
+        fileClose(f);
+    }
+    if (n != length || memcmp(buffer, expected, length) != 0) {
+        printf("Error: file %s has the wrong contents\n", name);
+        return -1;
+    }
+    return 0;
+}
+
+
+
+/**
+ * Benchmark of the file table index and the image backend.
+ *
+ * Usage: ./Daniel_benchFS [files]   (default 1000000)
+ * - Formats an image with room for the files in a scratch directory under /tmp.
+ * - Creates the files, timing LOOKUPS random fileOpen/fileClose pairs each
+ *   time the count reaches a power of ten, so the cost per lookup can be
+ *   compared across table sizes.
+ * - Writes SMALL_SIZE bytes to every file, then LARGE_SIZE bytes to the first
+ *   LARGE_FILES, syncs, remounts the image and checks the contents.
+ * - Re-reads HOT_FILES large files (fewer if they would take more than half
+ *   the block cache) twice, and checks that the second pass reads nothing from the image.
+ * - Then deletes every other file, checks that the remaining files kept their
+ *   indices, recreates the deleted ones into the freed entries, and deletes everything.
+ * - Finally streams STREAM_BUFFERS buffers into one file in append mode, reads
+ *   them back sequentially after a seek, then at random positions with fileReadAt(),
+ *   and overwrites some in place with fileWriteAt().
+ */
+int main(int argc, char *argv[]) {
+    int files = argc > 1 ? atoi(argv[1]) : 1000000;
+    char dir[] = "/tmp/libfs_benchXXXXXX";
+    char name[MAX_FILENAME];
+    int status = 0;
+
+    if (files < 2) {
+        printf("Usage: %s [files (at least 2)]\n", argv[0]);
+        return 1;
+    }
+    if (!mkdtemp(dir) || chdir(dir) != 0) {
+        perror("Unable to create the scratch directory");
+        return 1;
+    }
+    fs_verbose = 0;
+    int large_blocks = LARGE_FILES * ((LARGE_SIZE + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE);
+    int blocks = 1 + 1 + files / (FS_BLOCK_SIZE / FS_INODE_SIZE) + 1 + large_blocks + DATA_BLOCKS;
+    if (fileSystemFormat("bench.img", blocks, files) != 0 || fileSystemMount("bench.img") != 0) {
+        return 1;
+    }
+
+    printf("%10s %14s %16s\n", "Files", "Create us/op", "Open+close us/op");
+    double create_start = nowMs();
+    int created = 0, checkpoint = 1000;
+    while (created < files && status == 0) {
+        benchName(name, created);
+        if (fileCreate(name) != 0) {
+            status = 1;
+            break;
+        }
+        created++;
+        if (created == checkpoint || created == files) {
+            double create_us = (nowMs() - create_start) * 1000.0 / created;
+            double start = nowMs();
+            for (int k = 0; k < LOOKUPS && status == 0; k++) {
+                benchName(name, nextRandom() % created);
+                int i = fileOpen(name);
+                if (i == -1 || fileClose(i) != 0) status = 1;
+            }
+            printf("%10d %14.2f %16.3f\n", created, create_us, (nowMs() - start) * 1000.0 / LOOKUPS);
+            checkpoint *= 10;
+        }
+    }
+
+    // Small files live in their inodes, large ones in extents
+    char *data = (char *)malloc(LARGE_SIZE + 1), *buffer = (char *)malloc(LARGE_SIZE + 1);
+    if (!data || !buffer) {
+        printf("Memory allocation failed\n");
+        status = 1;
+    }
+    double start = nowMs();
+    for (int i = 0; i < created && status == 0; i++) {
+        benchName(name, i);
+        fillData(data, SMALL_SIZE, i);
+        int f = fileOpen(name);
+        if (f == -1 || fileWrite(f, data) != 0 || fileClose(f) != 0) status = 1;
+    }
+    double small_us = (nowMs() - start) * 1000.0 / created;
+    int large = created < LARGE_FILES ? created : LARGE_FILES;
+    start = nowMs();
+    for (int i = 0; i < large && status == 0; i++) {
+        benchName(name, i);
+        fillData(data, LARGE_SIZE, i);
+        int f = fileOpen(name);
+        if (f == -1 || fileWrite(f, data) != 0 || fileClose(f) != 0) status = 1;
+    }
+    double large_us = (nowMs() - start) * 1000.0 / large;
+    start = nowMs();
+    if (status == 0 && (fileSystemSync() != 0 || fileSystemUnmount() != 0 || fileSystemMount("bench.img") != 0)) {
+        status = 1;
+    }
+    double remount_ms = nowMs() - start;
+    for (int i = 0; i < created && status == 0; i++) {
+        if (checkFile(i, i < large ? LARGE_SIZE : SMALL_SIZE, data, buffer) != 0) status = 1;
+    }
+    printf("Wrote %d-byte files at %.2f us/op and %d-byte files at %.2f us/op; sync+remount %.1f ms; %d files %s\n",
+           SMALL_SIZE, small_us, LARGE_SIZE, large_us, remount_ms, file_count, status == 0 ? "verified" : "WRONG");
+
+    // A second pass over files that fit in the cache must not read the image
+    int hot = large < HOT_FILES ? large : HOT_FILES;
+    int cached_files = fs_cache_blocks / ((LARGE_SIZE + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE);
+    if (hot > cached_files / 2) {
+        hot = cached_files / 2;
+    }
+    CacheStats before, after;
+    for (int i = 0; i < hot && status == 0; i++) {
+        if (checkFile(i, LARGE_SIZE, data, buffer) != 0) status = 1;
+    }
+    fileSystemCacheStats(&before);
+    start = nowMs();
+    for (int i = 0; i < hot && status == 0; i++) {
+        if (checkFile(i, LARGE_SIZE, data, buffer) != 0) status = 1;
+    }
+    double hot_us = (nowMs() - start) * 1000.0 / (hot > 0 ? hot : 1);
+    fileSystemCacheStats(&after);
+    if (after.reads != before.reads) {
+        printf("Error: re-reading %d cached files read %llu runs from the image\n", hot, after.reads - before.reads);
+        status = 1;
+    }
+    printf("Re-read %d hot %d-byte files at %.2f us/op with %llu image reads\n", hot, LARGE_SIZE, hot_us,
+           after.reads - before.reads);
+    free(data);
+    free(buffer);
+
+    // Delete the odd files; the even ones must keep their indices
+    int *index = (int *)malloc(created * sizeof(int));
+    if (!index) {
+        printf("Memory allocation failed\n");
+        status = 1;
+    }
+    for (int i = 0; i < created && index; i++) {
+        benchName(name, i);
+        index[i] = fileOpen(name);
+        fileClose(index[i]);
+    }
+    start = nowMs();
+    for (int i = 1; i < created && index; i += 2) {
+        benchName(name, i);
+        if (fileDelete(name) != 0) status = 1;
+    }
+    double delete_us = (nowMs() - start) * 1000.0 / (created / 2);
+    for (int i = 0; i < created && index; i += 2) {
+        benchName(name, i);
+        int j = fileOpen(name);
+        if (j != index[i]) {
+            printf("Error: file %s moved from index %d to %d\n", name, index[i], j);
+            status = 1;
+            break;
+        }
+        fileClose(j);
+    }
+    int table_size = file_table_size;
+    for (int i = 1; i < created && index; i += 2) {
+        benchName(name, i);
+        if (fileCreate(name) != 0) status = 1;
+    }
+    printf("Deleted %d files at %.2f us/op; recreating them %s the file table (%d -> %d entries)\n", created / 2,
+           delete_us, file_table_size == table_size ? "reused" : "grew", table_size, file_table_size);
+
+    for (int i = 0; i < created; i++) {
+        benchName(name, i);
+        if (fileDelete(name) != 0) status = 1;
+    }
+    free(index);
+
+    // Stream one file through a single open handle
+    char *chunk = (char *)malloc(STREAM_BUFFER + 1), *expected = (char *)malloc(STREAM_BUFFER + 1);
+    int f = chunk && expected && fileCreate("stream") == 0 ? fileOpenMode("stream", FILE_APPEND) : -1;
+    if (f == -1) {
+        status = 1;
+    }
+    start = nowMs();
+    for (int k = 0; k < STREAM_BUFFERS && f != -1; k++) {
+        fillData(chunk, STREAM_BUFFER, k);
+        if (fileWrite(f, chunk) != 0) status = 1;
+    }
+    double append_us = (nowMs() - start) * 1000.0 / STREAM_BUFFERS;
+    start = nowMs();
+    if (f != -1 && fileSeek(f, 0, SEEK_SET) != 0) status = 1;
+    for (int k = 0; k < STREAM_BUFFERS && f != -1; k++) {
+        fillData(expected, STREAM_BUFFER, k);
+        if (fileRead(f, chunk, STREAM_BUFFER) != STREAM_BUFFER || memcmp(chunk, expected, STREAM_BUFFER) != 0) {
+            status = 1;
+        }
+    }
+    double read_us = (nowMs() - start) * 1000.0 / STREAM_BUFFERS;
+    if (f != -1 && fileRead(f, chunk, STREAM_BUFFER) != 0) status = 1;
+    start = nowMs();
+    for (int n = 0; n < STREAM_BUFFERS && f != -1; n++) {
+        int k = nextRandom() % STREAM_BUFFERS;
+        fillData(expected, STREAM_BUFFER, k);
+        if (fileReadAt(f, k * STREAM_BUFFER, chunk, STREAM_BUFFER) != STREAM_BUFFER ||
+            memcmp(chunk, expected, STREAM_BUFFER) != 0) {
+            status = 1;
+        }
+    }
+    double random_us = (nowMs() - start) * 1000.0 / STREAM_BUFFERS;
+    // Overwrite every other buffer shifted by half a buffer, then check the first one
+    for (int k = 0; k + 1 < STREAM_BUFFERS && f != -1; k += 2) {
+        fillData(chunk, STREAM_BUFFER, k + 7);
+        if (fileWriteAt(f, k * STREAM_BUFFER + STREAM_BUFFER / 2, chunk, STREAM_BUFFER) != STREAM_BUFFER) status = 1;
+    }
+    fillData(expected, STREAM_BUFFER, 7);
+    if (f != -1 && (fileReadAt(f, STREAM_BUFFER / 2, chunk, STREAM_BUFFER) != STREAM_BUFFER ||
+                    memcmp(chunk, expected, STREAM_BUFFER) != 0 || file_table[f].size != STREAM_BUFFERS * STREAM_BUFFER)) {
+        printf("Error: positional writes to the stream file are wrong\n");
+        status = 1;
+    }
+    printf("Streamed %d %d-byte buffers: append %.2f us, sequential read %.2f us, random read %.2f us per buffer\n",
+           STREAM_BUFFERS, STREAM_BUFFER, append_us, read_us, random_us);
+    if (f != -1 && (fileClose(f) != 0 || fileDelete("stream") != 0)) status = 1;
+    free(chunk);
+    free(expected);
+
+    CacheStats stats;
+    if (fileSystemCacheStats(&stats) == 0) {
+        unsigned long long accesses = stats.hits + stats.misses;
+        printf("Cache: %.1f%% hits; %llu blocks read in %llu preads; %llu blocks written back in %llu pwrites "
+               "(%llu flusher passes); %llu evictions\n", accesses ? 100.0 * stats.hits / accesses : 0.0,
+               stats.blocks_read, stats.reads, stats.blocks_written, stats.writebacks, stats.flushes, stats.evictions);
+    }
+    printf("%d files left; %s\n", file_count, status == 0 ? "all checks passed" : "CHECKS FAILED");
+    if (fileSystemUnmount() != 0) status = 1;
+    if (unlink("bench.img") != 0 || chdir("/") != 0 || rmdir(dir) != 0) perror("Unable to remove the scratch directory");
+    return status;
+}
@@ -0,0 +1,392 @@
+#define _POSIX_C_SOURCE 200809L
+#include "Daniel_blockCache.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+
+
+// Read or write exactly `length` bytes at an image offset, retrying short transfers
+static int ioFull(int fd, char *buffer, size_t length, off_t offset, int is_write) {
+    while (length > 0) {
+        ssize_t n = is_write ? pwrite(fd, buffer, length, offset) : pread(fd, buffer, length, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        buffer += n;
+        length -= n;
+        offset += n;
+    }
+    return 0;
+}
+
+
+
+// ----- Hash index of the slots -----
+
+static uint32_t hashKey(uint32_t inode, uint32_t block) {
+    uint32_t h = inode * 2654435761u + block;
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+static char *slotData(BlockCache *cache, int s) {
+    return cache->data + (size_t)s * CACHE_BLOCK_SIZE;
+}
+
+// Slot holding a block of a file, or -1
+static int findSlot(BlockCache *cache, uint32_t inode, uint32_t block) {
+    for (int s = cache->buckets[hashKey(inode, block) & cache->bucket_mask]; s != -1; s = cache->slots[s].next) {
+        if (cache->slots[s].inode == inode && cache->slots[s].block == block) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+static void insertSlot(BlockCache *cache, int s, uint32_t inode, uint32_t block, uint32_t disk) {
+    CacheSlot *slot = &cache->slots[s];
+    int *bucket = &cache->buckets[hashKey(inode, block) & cache->bucket_mask];
+    slot->inode = inode;
+    slot->block = block;
+    slot->disk = disk;
+    slot->valid = 1;
+    slot->dirty = 0;
+    slot->referenced = 1;
+    slot->next = *bucket;
+    *bucket = s;
+}
+
+// Take a slot out of the index; it no longer holds a block
+static void removeSlot(BlockCache *cache, int s) {
+    CacheSlot *slot = &cache->slots[s];
+    int *link = &cache->buckets[hashKey(slot->inode, slot->block) & cache->bucket_mask];
+    while (*link != s) {
+        link = &cache->slots[*link].next;
+    }
+    *link = slot->next;
+    if (slot->dirty) {
+        cache->num_dirty--;
+    }
+    slot->valid = 0;
+    slot->dirty = 0;
+}
+
+
+
+// ----- Write-back -----
+
+// Write the dirty slots run[0..count-1], which hold consecutive image blocks, with one pwrite
+static int writeRun(BlockCache *cache, const int *run, int count) {
+    for (int k = 0; k < count; k++) {
+        memcpy(cache->write_run + (size_t)k * CACHE_BLOCK_SIZE, slotData(cache, run[k]), CACHE_BLOCK_SIZE);
+    }
+    if (ioFull(cache->fd, cache->write_run, (size_t)count * CACHE_BLOCK_SIZE,
+               (off_t)cache->slots[run[0]].disk * CACHE_BLOCK_SIZE, 1) != 0) {
+        return -1;
+    }
+    for (int k = 0; k < count; k++) {
+        cache->slots[run[k]].dirty = 0;
+    }
+    cache->num_dirty -= count;
+    cache->stats.writebacks++;
+    cache->stats.blocks_written += count;
+    return 0;
+}
+
+// Write back a dirty slot being evicted, with the dirty blocks of the same
+// file around it that are also its neighbours in the image
+static int writeAround(BlockCache *cache, int s) {
+    const CacheSlot *slot = &cache->slots[s];
+    int run[CACHE_MAX_RUN];
+    int first = 0, count = 1;
+
+    // Walk back to the start of the run, then collect it forwards
+    while (count < CACHE_MAX_RUN && slot->block > (uint32_t)first && slot->disk > (uint32_t)first) {
+        int p = findSlot(cache, slot->inode, slot->block - first - 1);
+        if (p == -1 || !cache->slots[p].dirty || cache->slots[p].disk != slot->disk - first - 1) {
+            break;
+        }
+        first++;
+        count++;
+    }
+    for (int k = 0; k < first; k++) {
+        run[k] = findSlot(cache, slot->inode, slot->block - first + k);
+    }
+    run[first] = s;
+    while (count < CACHE_MAX_RUN) {
+        uint32_t after = (uint32_t)(count - first);
+        int n = findSlot(cache, slot->inode, slot->block + after);
+        if (n == -1 || !cache->slots[n].dirty || cache->slots[n].disk != slot->disk + after) {
+            break;
+        }
+        run[count++] = n;
+    }
+    return writeRun(cache, run, count);
+}
+
+static int compareKeys(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Write back every dirty slot in image order, one pwrite per run of consecutive blocks
+static int flushLocked(BlockCache *cache) {
+    int count = 0;
+    for (int s = 0; s < cache->capacity; s++) {
+        if (cache->slots[s].valid && cache->slots[s].dirty) {
+            cache->order[count++] = (uint64_t)cache->slots[s].disk << 32 | (uint32_t)s;
+        }
+    }
+    qsort(cache->order, count, sizeof(uint64_t), compareKeys);
+
+    int run[CACHE_MAX_RUN];
+    for (int i = 0; i < count; ) {
+        int length = 0;
+        uint32_t disk = (uint32_t)(cache->order[i] >> 32);
+        while (i < count && length < CACHE_MAX_RUN && (uint32_t)(cache->order[i] >> 32) == disk + (uint32_t)length) {
+            run[length++] = (int)(uint32_t)cache->order[i++];
+        }
+        if (writeRun(cache, run, length) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Background flusher: writes the dirty blocks back every flush_ms, or sooner when woken
+static void *flusherMain(void *arg) {
+    BlockCache *cache = (BlockCache *)arg;
+    pthread_mutex_lock(&cache->lock);
+    while (!cache->stopping) {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += (long)cache->flush_ms * 1000000L;
+        until.tv_sec += until.tv_nsec / 1000000000L;
+        until.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&cache->wake, &cache->lock, &until);
+        // A failed pass leaves its blocks dirty for the next one (or for cacheFlush() to report)
+        if (!cache->stopping && cache->num_dirty > 0 && flushLocked(cache) == 0) {
+            cache->stats.flushes++;
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return NULL;
+}
+
+
+
+// ----- Slot replacement -----
+
+// Take a slot for a new block with the clock hand, writing back the victim if it is dirty
+static int takeSlot(BlockCache *cache) {
+    for (;;) {
+        int s = cache->hand;
+        CacheSlot *slot = &cache->slots[s];
+        cache->hand = (cache->hand + 1) % cache->capacity;
+        if (!slot->valid) {
+            return s;
+        }
+        if (slot->referenced) {
+            slot->referenced = 0;
+            continue;
+        }
+        if (slot->dirty && writeAround(cache, s) != 0) {
+            return -1;
+        }
+        removeSlot(cache, s);
+        cache->stats.evictions++;
+        return s;
+    }
+}
+
+// Load up to `count` consecutive blocks of a file that are not cached, with one pread
+static int loadRun(BlockCache *cache, uint32_t inode, uint32_t block, uint32_t disk, int count) {
+    if (ioFull(cache->fd, cache->read_run, (size_t)count * CACHE_BLOCK_SIZE, (off_t)disk * CACHE_BLOCK_SIZE, 0) != 0) {
+        return -1;
+    }
+    cache->stats.reads++;
+    cache->stats.blocks_read += count;
+    for (int k = 0; k < count; k++) {
+        int s = takeSlot(cache);
+        if (s == -1) {
+            return -1;
+        }
+        memcpy(slotData(cache, s), cache->read_run + (size_t)k * CACHE_BLOCK_SIZE, CACHE_BLOCK_SIZE);
+        insertSlot(cache, s, inode, block + k, disk + k);
+    }
+    return 0;
+}
+
+
+
+// ----- Public functions -----
+
+int cacheInit(BlockCache *cache, int fd, int blocks, int flush_ms) {
+    memset(cache, 0, sizeof(*cache));
+    int capacity = blocks < CACHE_MIN_BLOCKS ? CACHE_MIN_BLOCKS : blocks;
+    uint32_t buckets = 1;
+    while (buckets < (uint32_t)capacity * 2) {
+        buckets *= 2;
+    }
+    cache->fd = fd;
+    cache->data = (char *)malloc((size_t)capacity * CACHE_BLOCK_SIZE);
+    cache->slots = (CacheSlot *)calloc(capacity, sizeof(CacheSlot));
+    cache->buckets = (int *)malloc(buckets * sizeof(int));
+    cache->order = (uint64_t *)malloc(capacity * sizeof(uint64_t));
+    cache->read_run = (char *)malloc((size_t)CACHE_MAX_RUN * CACHE_BLOCK_SIZE);
+    cache->write_run = (char *)malloc((size_t)CACHE_MAX_RUN * CACHE_BLOCK_SIZE);
+    if (!cache->data || !cache->slots || !cache->buckets || !cache->order || !cache->read_run || !cache->write_run) {
+        cacheDestroy(cache);
+        return -1;
+    }
+    for (uint32_t b = 0; b < buckets; b++) {
+        cache->buckets[b] = -1;
+    }
+    cache->bucket_mask = buckets - 1;
+    cache->capacity = capacity;
+    cache->flush_ms = flush_ms;
+    pthread_mutex_init(&cache->lock, NULL);
+    pthread_cond_init(&cache->wake, NULL);
+    if (flush_ms > 0) {
+        cache->has_flusher = pthread_create(&cache->flusher, NULL, flusherMain, cache) == 0;
+    }
+    return 0;
+}
+
+
+
+void cacheDestroy(BlockCache *cache) {
+    if (cache->capacity > 0) {
+        if (cache->has_flusher) {
+            pthread_mutex_lock(&cache->lock);
+            cache->stopping = 1;
+            pthread_cond_signal(&cache->wake);
+            pthread_mutex_unlock(&cache->lock);
+            pthread_join(cache->flusher, NULL);
+        }
+        pthread_cond_destroy(&cache->wake);
+        pthread_mutex_destroy(&cache->lock);
+    }
+    free(cache->data);
+    free(cache->slots);
+    free(cache->buckets);
+    free(cache->order);
+    free(cache->read_run);
+    free(cache->write_run);
+    memset(cache, 0, sizeof(*cache));
+}
+
+
+
+int cacheTransfer(BlockCache *cache, uint32_t inode, uint32_t block, uint32_t disk, uint32_t offset, char *buffer,
+                  uint32_t length, int is_write, uint32_t fresh) {
+    int status = 0;
+    int preloaded = 0;  // Blocks ahead that the last run loaded (already counted as misses)
+    pthread_mutex_lock(&cache->lock);
+
+    while (length > 0) {
+        uint32_t n = CACHE_BLOCK_SIZE - offset < length ? CACHE_BLOCK_SIZE - offset : length;
+        int s = findSlot(cache, inode, block);
+        if (s != -1) {
+            if (preloaded > 0) {
+                preloaded--;
+            } else {
+                cache->stats.hits++;
+            }
+        } else if (block < fresh && (!is_write || n < CACHE_BLOCK_SIZE)) {
+            // The block has data that is not all overwritten: load it, with the
+            // blocks after it that the transfer reads and are not cached either
+            int count = 1;
+            uint32_t span = (uint32_t)(((uint64_t)offset + length + CACHE_BLOCK_SIZE - 1) / CACHE_BLOCK_SIZE);
+            while (!is_write && count < CACHE_MAX_RUN && (uint32_t)count < span && block + count < fresh &&
+                   findSlot(cache, inode, block + count) == -1) {
+                count++;
+            }
+            if (loadRun(cache, inode, block, disk, count) != 0 || (s = findSlot(cache, inode, block)) == -1) {
+                status = -1;
+                break;
+            }
+            cache->stats.misses += count;
+            preloaded = count - 1;
+        } else {
+            // Nothing to load: the block is overwritten whole or has no data yet
+            if ((s = takeSlot(cache)) == -1) {
+                status = -1;
+                break;
+            }
+            if (n < CACHE_BLOCK_SIZE) {
+                memset(slotData(cache, s), 0, CACHE_BLOCK_SIZE);
+            }
+            insertSlot(cache, s, inode, block, disk);
+            cache->stats.misses++;
+        }
+
+        CacheSlot *slot = &cache->slots[s];
+        slot->referenced = 1;
+        if (!is_write) {
+            memcpy(buffer, slotData(cache, s) + offset, n);
+        } else {
+            if (buffer) {
+                memcpy(slotData(cache, s) + offset, buffer, n);
+            } else {
+                memset(slotData(cache, s) + offset, 0, n);
+            }
+            if (!slot->dirty) {
+                slot->dirty = 1;
+                cache->num_dirty++;
+            }
+        }
+        if (buffer) {
+            buffer += n;
+        }
+        length -= n;
+        offset = 0;
+        block++;
+        disk++;
+    }
+
+    if (cache->has_flusher && cache->num_dirty * CACHE_DIRTY_RATIO >= cache->capacity) {
+        pthread_cond_signal(&cache->wake);
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return status;
+}
+
+
+
+void cacheDrop(BlockCache *cache, uint32_t inode, uint32_t block) {
+    pthread_mutex_lock(&cache->lock);
+    int s = findSlot(cache, inode, block);
+    if (s != -1) {
+        removeSlot(cache, s);
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+
+
+int cacheFlush(BlockCache *cache) {
+    if (cache->capacity == 0) {
+        return 0;
+    }
+    pthread_mutex_lock(&cache->lock);
+    int status = flushLocked(cache);
+    pthread_mutex_unlock(&cache->lock);
+    return status;
+}
+
+
+
+void cacheGetStats(BlockCache *cache, CacheStats *stats) {
+    pthread_mutex_lock(&cache->lock);
+    *stats = cache->stats;
+    pthread_mutex_unlock(&cache->lock);
+}
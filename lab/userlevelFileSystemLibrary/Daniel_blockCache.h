@@ -0,0 +1,155 @@
+#ifndef DANIEL_BLOCKCACHE_H
+#define DANIEL_BLOCKCACHE_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+
+// ----- Constants -----
+#define CACHE_BLOCK_SIZE 4096         // Bytes per cached block (the image block size)
+#define CACHE_MAX_RUN 64              // Most blocks moved by one pread/pwrite
+#define CACHE_MIN_BLOCKS 128          // Smallest cache (two runs)
+#define CACHE_FLUSH_MS 50             // Period of the background flusher
+#define CACHE_DIRTY_RATIO 2           // Wake the flusher early once 1/CACHE_DIRTY_RATIO of the blocks are dirty
+
+
+/**
+ * Counters of a cache since it was created.
+ */
+typedef struct {
+    unsigned long long hits;            /**< Block accesses served from memory */
+    unsigned long long misses;          /**< Block accesses that had to load the block (or found it new) */
+    unsigned long long reads;           /**< pread calls made to load blocks */
+    unsigned long long blocks_read;     /**< Blocks loaded from the image */
+    unsigned long long writebacks;      /**< pwrite calls made to write dirty blocks back */
+    unsigned long long blocks_written;  /**< Dirty blocks written back */
+    unsigned long long evictions;       /**< Blocks dropped to make room for others */
+    unsigned long long flushes;         /**< Passes of the background flusher that wrote blocks */
+} CacheStats;
+
+
+
+/**
+ * A slot of the cache and the file block it holds.
+ */
+typedef struct {
+    uint32_t inode;              /**< File (inode number) */
+    uint32_t block;              /**< Block number within the file */
+    uint32_t disk;               /**< Block of the image holding it */
+    int next;                    /**< Next slot in the same hash bucket, or -1 */
+    unsigned char valid;         /**< The slot holds a block */
+    unsigned char dirty;         /**< Changed since it was loaded or last written back */
+    unsigned char referenced;    /**< Used since the clock hand last passed */
+} CacheSlot;
+
+
+
+/**
+ * A fixed-size write-back cache of file blocks, keyed by (inode, block of the file).
+ * Slots are reused with the CLOCK algorithm: the hand skips (and clears) the
+ * slots used since it last passed and takes the first one that was not.
+ * Dirty blocks reach the image when evicted, on cacheFlush(), or from a
+ * background flusher thread, in runs of consecutive image blocks, one pwrite
+ * per run. A mutex serializes the flusher with the caller, which must be a
+ * single thread.
+ */
+typedef struct {
+    int fd;                      /**< Image file */
+    int capacity;                /**< Number of slots (0: cache not set up) */
+    char *data;                  /**< capacity blocks of cached data */
+    CacheSlot *slots;            /**< One per block of data */
+    int *buckets;                /**< Hash buckets: first slot of each chain, or -1 */
+    uint32_t bucket_mask;        /**< Number of buckets minus one (a power of two) */
+    int hand;                    /**< Next slot the clock hand looks at */
+    int num_dirty;               /**< Dirty slots */
+    uint64_t *order;             /**< Scratch for sorting dirty slots by image block */
+    char *read_run;              /**< Staging buffer for one run being loaded */
+    char *write_run;             /**< Staging buffer for one run being written back */
+    CacheStats stats;            /**< Counters */
+    pthread_mutex_t lock;        /**< Held by every operation and the flusher */
+    pthread_cond_t wake;         /**< Wakes the flusher before its period is up */
+    pthread_t flusher;           /**< Background flusher thread */
+    int has_flusher;             /**< The flusher thread is running */
+    int stopping;                /**< Set to make the flusher exit */
+    int flush_ms;                /**< Flusher period */
+} BlockCache;
+
+
+
+// ----- Function prototypes -----
+
+
+/**
+ * Sets up an empty cache and starts its flusher.
+ *
+ * @param cache Cache to set up.
+ * @param fd Image file the blocks are read from and written to.
+ * @param blocks Number of blocks to cache (at least CACHE_MIN_BLOCKS are).
+ * @param flush_ms Period of the background flusher, or 0 for none (write-back on eviction and cacheFlush() only).
+ * @return 0 if successful, or -1 if an error occurs.
+ */
+int cacheInit(BlockCache *cache, int fd, int blocks, int flush_ms);
+
+
+
+/**
+ * Stops the flusher and releases the cache. Dirty blocks are lost: call cacheFlush() first.
+ *
+ * @param cache Cache.
+ */
+void cacheDestroy(BlockCache *cache);
+
+
+
+/**
+ * Reads or writes part of a file through the cache.
+ * The range starts `offset` bytes into block `block` of the file and its blocks
+ * are consecutive in the image from block `disk`. Blocks that are not cached are
+ * loaded together, one pread per run; written blocks become dirty.
+ *
+ * @param cache Cache.
+ * @param inode File.
+ * @param block First block of the file touched.
+ * @param disk Image block holding it.
+ * @param offset Byte offset in that block.
+ * @param buffer Data to write, or where to store the data read (NULL writes zeros).
+ * @param length Number of bytes.
+ * @param is_write 1 to write, 0 to read.
+ * @param fresh First block of the file with no data yet: such blocks are never loaded, they start as zeros.
+ * @return 0 if successful, or -1 if an I/O error occurs.
+ */
+int cacheTransfer(BlockCache *cache, uint32_t inode, uint32_t block, uint32_t disk, uint32_t offset, char *buffer,
+                  uint32_t length, int is_write, uint32_t fresh);
+
+
+
+/**
+ * Forgets a block of a file, dirty or not (its image block is being freed).
+ *
+ * @param cache Cache.
+ * @param inode File.
+ * @param block Block of the file.
+ */
+void cacheDrop(BlockCache *cache, uint32_t inode, uint32_t block);
+
+
+
+/**
+ * Writes every dirty block back, sorted by image block and coalesced into runs.
+ *
+ * @param cache Cache (nothing is done if it was never set up).
+ * @return 0 if successful, or -1 if an I/O error occurs (the blocks not written stay dirty).
+ */
+int cacheFlush(BlockCache *cache);
+
+
+
+/**
+ * Copies the counters of a cache.
+ *
+ * @param cache Cache.
+ * @param stats Where to store them.
+ */
+void cacheGetStats(BlockCache *cache, CacheStats *stats);
+
+#endif // DANIEL_BLOCKCACHE_H
@@ -0,0 +1,538 @@
+#define _POSIX_C_SOURCE 200809L
+#include "Daniel_fsImage.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+_Static_assert(sizeof(Inode) == FS_INODE_SIZE, "an inode must fill FS_INODE_SIZE bytes");
+_Static_assert(sizeof(Superblock) <= FS_BLOCK_SIZE, "the superblock must fit in a block");
+_Static_assert(CACHE_BLOCK_SIZE == FS_BLOCK_SIZE, "the cache must hold image blocks");
+
+
+
+// Read or write exactly `length` bytes at an image offset, retrying short transfers
+static int transferFull(int fd, char *buffer, size_t length, off_t offset, int is_write) {
+    while (length > 0) {
+        ssize_t n = is_write ? pwrite(fd, buffer, length, offset) : pread(fd, buffer, length, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        buffer += n;
+        length -= n;
+        offset += n;
+    }
+    return 0;
+}
+
+
+
+// Bitmap helpers
+static int blockUsed(const FsImage *img, uint32_t block) {
+    return (img->bitmap[block >> 3] >> (block & 7)) & 1;
+}
+
+static void setBlockUsed(FsImage *img, uint32_t block, int used) {
+    if (used) {
+        img->bitmap[block >> 3] |= (unsigned char)(1 << (block & 7));
+        img->super.free_blocks--;
+    } else {
+        img->bitmap[block >> 3] &= (unsigned char)~(1 << (block & 7));
+        img->super.free_blocks++;
+    }
+    img->dirty[0] = 1;  // free_blocks changed
+    img->dirty[img->super.bitmap_start + (block >> 3) / FS_BLOCK_SIZE] = 1;
+}
+
+static void markInodeDirty(FsImage *img, int inode) {
+    img->dirty[img->super.inode_start + inode / (FS_BLOCK_SIZE / FS_INODE_SIZE)] = 1;
+}
+
+
+
+// Write a run of metadata blocks, coalescing consecutive dirty ones into one pwrite
+static int syncRegion(FsImage *img, uint32_t first, uint32_t count, const char *memory) {
+    uint32_t b = 0;
+    while (b < count) {
+        if (!img->dirty[first + b]) {
+            b++;
+            continue;
+        }
+        uint32_t run = b;
+        while (run < count && img->dirty[first + run]) {
+            img->dirty[first + run] = 0;
+            run++;
+        }
+        if (transferFull(img->fd, (char *)memory + (size_t)b * FS_BLOCK_SIZE, (size_t)(run - b) * FS_BLOCK_SIZE,
+                         (off_t)(first + b) * FS_BLOCK_SIZE, 1) != 0) {
+            return -1;
+        }
+        b = run;
+    }
+    return 0;
+}
+
+int imageSync(FsImage *img) {
+    // Data first, so the metadata on disk never points at blocks not written yet
+    if (cacheFlush(&img->cache) != 0) {
+        return -1;
+    }
+    if (img->dirty[0]) {
+        char block[FS_BLOCK_SIZE] = { 0 };
+        memcpy(block, &img->super, sizeof(img->super));
+        if (transferFull(img->fd, block, FS_BLOCK_SIZE, 0, 1) != 0) {
+            return -1;
+        }
+        img->dirty[0] = 0;
+    }
+    if (syncRegion(img, img->super.bitmap_start, img->super.bitmap_blocks, (const char *)img->bitmap) != 0 ||
+        syncRegion(img, img->super.inode_start, img->super.inode_blocks, (const char *)img->inodes) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+
+
+// Allocate the in-memory metadata of an image described by img->super
+static int allocateMetadata(FsImage *img) {
+    img->bitmap = (unsigned char *)calloc(img->super.bitmap_blocks, FS_BLOCK_SIZE);
+    img->inodes = (Inode *)calloc(img->super.inode_blocks, FS_BLOCK_SIZE);
+    img->dirty = (unsigned char *)calloc(img->super.data_start, 1);
+    img->free_inodes = (int *)malloc(img->super.inode_count * sizeof(int));
+    if (!img->bitmap || !img->inodes || !img->dirty || !img->free_inodes) {
+        return -1;
+    }
+    return 0;
+}
+
+static void freeMetadata(FsImage *img) {
+    free(img->bitmap);
+    free(img->inodes);
+    free(img->dirty);
+    free(img->free_inodes);
+    img->bitmap = NULL;
+    img->inodes = NULL;
+    img->dirty = NULL;
+    img->free_inodes = NULL;
+}
+
+
+
+int imageFormat(const char *path, uint32_t blocks, uint32_t inodes) {
+    FsImage img;
+    memset(&img, 0, sizeof(img));
+
+    uint32_t per_block = FS_BLOCK_SIZE / FS_INODE_SIZE;
+    Superblock *s = &img.super;
+    memcpy(s->magic, FS_MAGIC, sizeof(s->magic));
+    s->version = FS_VERSION;
+    s->block_size = FS_BLOCK_SIZE;
+    s->total_blocks = blocks;
+    s->bitmap_start = 1;
+    s->bitmap_blocks = (blocks + FS_BLOCK_SIZE * 8 - 1) / (FS_BLOCK_SIZE * 8);
+    s->inode_start = s->bitmap_start + s->bitmap_blocks;
+    s->inode_blocks = (inodes + per_block - 1) / per_block;
+    s->inode_count = s->inode_blocks * per_block;
+    s->data_start = s->inode_start + s->inode_blocks;
+    s->free_blocks = blocks;
+    if (inodes < 1 || blocks <= s->data_start || blocks > (uint32_t)INT32_MAX / 8) {
+        printf("Error: An image of %u blocks cannot hold %u inodes and data.\n", blocks, inodes);
+        return -1;
+    }
+
+    img.fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (img.fd < 0) {
+        printf("Error: Unable to create image '%s'.\n", path);
+        return -1;
+    }
+    // Reserve every block now, so writes never fail for lack of host space;
+    // file systems without fallocate get a sparse file of the same size
+    off_t bytes = (off_t)blocks * FS_BLOCK_SIZE;
+    if (posix_fallocate(img.fd, 0, bytes) != 0 && ftruncate(img.fd, bytes) != 0) {
+        printf("Error: Unable to size image '%s'.\n", path);
+        close(img.fd);
+        return -1;
+    }
+    if (allocateMetadata(&img) != 0) {
+        printf("Error: Out of memory formatting image '%s'.\n", path);
+        freeMetadata(&img);
+        close(img.fd);
+        return -1;
+    }
+
+    // The metadata blocks are in use; the inode table is already zero on disk
+    for (uint32_t b = 0; b < s->data_start; b++) {
+        setBlockUsed(&img, b, 1);
+    }
+    int status = imageSync(&img);
+    if (close(img.fd) != 0) {
+        status = -1;
+    }
+    freeMetadata(&img);
+    if (status != 0) {
+        printf("Error: Unable to write image '%s'.\n", path);
+    }
+    return status;
+}
+
+
+
+// Check that a superblock describes the layout imageFormat() writes: bitmap,
+// inode table and data area back to back, a bitmap covering every block
+static int validLayout(const Superblock *s) {
+    uint64_t per_block = FS_BLOCK_SIZE / FS_INODE_SIZE;
+    return memcmp(s->magic, FS_MAGIC, sizeof(s->magic)) == 0 && s->version == FS_VERSION &&
+           s->block_size == FS_BLOCK_SIZE && s->total_blocks <= (uint32_t)INT32_MAX / 8 && s->bitmap_start == 1 &&
+           s->bitmap_blocks > 0 && (uint64_t)s->bitmap_blocks * FS_BLOCK_SIZE * 8 >= s->total_blocks &&
+           (uint64_t)s->inode_start == (uint64_t)s->bitmap_start + s->bitmap_blocks && s->inode_blocks > 0 &&
+           (uint64_t)s->data_start == (uint64_t)s->inode_start + s->inode_blocks && s->data_start < s->total_blocks &&
+           (uint64_t)s->inode_count == (uint64_t)s->inode_blocks * per_block && s->free_blocks <= s->total_blocks;
+}
+
+// Check that a used inode has a terminated name, at most FS_MAX_EXTENTS extents inside
+// the data area, and exactly the blocks its size needs (none for an inline file)
+static int validInode(const Superblock *s, const Inode *node) {
+    if (!memchr(node->filename, '\0', FS_NAME_SIZE) || node->num_extents > FS_MAX_EXTENTS) {
+        return 0;
+    }
+    uint64_t blocks = 0;
+    for (int e = 0; e < node->num_extents; e++) {
+        const Extent *extent = &node->extents[e];
+        if (extent->length == 0 || extent->start < s->data_start ||
+            (uint64_t)extent->start + extent->length > s->total_blocks) {
+            return 0;
+        }
+        blocks += extent->length;
+    }
+    uint64_t need = node->size <= FS_INLINE_SIZE ? 0 : ((uint64_t)node->size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+    return blocks == need;
+}
+
+int imageOpen(FsImage *img, const char *path, int cache_blocks) {
+    memset(img, 0, sizeof(*img));
+    img->fd = open(path, O_RDWR);
+    if (img->fd < 0) {
+        return -1;
+    }
+
+    Superblock *s = &img->super;
+    if (transferFull(img->fd, (char *)s, sizeof(*s), 0, 0) != 0 || !validLayout(s)) {
+        printf("Error: '%s' is not a file system image.\n", path);
+        close(img->fd);
+        return -1;
+    }
+    if (allocateMetadata(img) != 0 ||
+        transferFull(img->fd, (char *)img->bitmap, (size_t)s->bitmap_blocks * FS_BLOCK_SIZE,
+                     (off_t)s->bitmap_start * FS_BLOCK_SIZE, 0) != 0 ||
+        transferFull(img->fd, (char *)img->inodes, (size_t)s->inode_blocks * FS_BLOCK_SIZE,
+                     (off_t)s->inode_start * FS_BLOCK_SIZE, 0) != 0 ||
+        cacheInit(&img->cache, img->fd, cache_blocks, CACHE_FLUSH_MS) != 0) {
+        printf("Error: Unable to load image '%s'.\n", path);
+        freeMetadata(img);
+        close(img->fd);
+        return -1;
+    }
+
+    // Free inodes are handed out lowest first
+    for (int i = (int)s->inode_count - 1; i >= 0; i--) {
+        if (!(img->inodes[i].flags & FS_INODE_USED)) {
+            img->free_inodes[img->num_free_inodes++] = i;
+        } else if (!validInode(s, &img->inodes[i])) {
+            printf("Error: Inode %d of '%s' is damaged.\n", i, path);
+            cacheDestroy(&img->cache);
+            freeMetadata(img);
+            close(img->fd);
+            return -1;
+        }
+    }
+    img->hint = s->data_start;
+    return 0;
+}
+
+
+
+int imageClose(FsImage *img) {
+    int status = imageSync(img);
+    cacheDestroy(&img->cache);
+    if (close(img->fd) != 0) {
+        status = -1;
+    }
+    freeMetadata(img);
+    return status;
+}
+
+
+
+// Find free blocks for `want` more: the first free run of at least that many
+// from the hint on, else the longest run in the data area. Returns its first
+// block and stores its usable length, or returns 0 with length 0 if the image is full.
+static uint32_t findRun(FsImage *img, uint32_t want, uint32_t *length) {
+    uint32_t start = img->super.data_start, total = img->super.total_blocks;
+    uint32_t best = 0, best_length = 0, scanned = 0, span = total - start;
+    uint32_t b = (img->hint >= start && img->hint < total) ? img->hint : start;
+
+    while (scanned < span) {
+        // Skip whole bytes of used blocks
+        if ((b & 7) == 0 && b + 8 <= total && img->bitmap[b >> 3] == 0xFF) {
+            uint32_t step = span - scanned < 8 ? span - scanned : 8;
+            b += step;
+            scanned += step;
+        } else if (blockUsed(img, b)) {
+            b++;
+            scanned++;
+        } else {
+            uint32_t run = b, run_length = 0;
+            while (scanned < span && b < total && run_length < want && !blockUsed(img, b)) {
+                b++;
+                scanned++;
+                run_length++;
+            }
+            if (run_length >= want) {
+                img->hint = run + want;
+                *length = want;
+                return run;
+            }
+            if (run_length > best_length) {
+                best = run;
+                best_length = run_length;
+            }
+        }
+        if (b >= total) {
+            b = start;
+        }
+    }
+    *length = best_length;
+    return best;
+}
+
+
+
+// Number of blocks a file of `size` bytes takes (0 if it fits inline)
+static uint32_t blocksFor(uint32_t size) {
+    return size <= FS_INLINE_SIZE ? 0 : (uint32_t)(((uint64_t)size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE);
+}
+
+static uint32_t blockCount(const Inode *node) {
+    uint32_t count = 0;
+    for (int e = 0; e < node->num_extents; e++) {
+        count += node->extents[e].length;
+    }
+    return count;
+}
+
+
+
+// Give a block file exactly `need` blocks, freeing from the end or allocating
+// (growing the last extent in place when the blocks after it are free).
+// On failure the file keeps the blocks it had.
+static int setBlockCount(FsImage *img, Inode *node, uint32_t need) {
+    uint32_t have = blockCount(node), original = have;
+    uint32_t inode = (uint32_t)(node - img->inodes);
+
+    while (have > need) {
+        Extent *last = &node->extents[node->num_extents - 1];
+        setBlockUsed(img, last->start + last->length - 1, 0);
+        have--;
+        cacheDrop(&img->cache, inode, have);
+        if (--last->length == 0) {
+            node->num_extents--;
+        }
+    }
+    while (have < need) {
+        if (node->num_extents > 0) {
+            Extent *last = &node->extents[node->num_extents - 1];
+            uint32_t next = last->start + last->length;
+            if (next < img->super.total_blocks && !blockUsed(img, next)) {
+                setBlockUsed(img, next, 1);
+                last->length++;
+                have++;
+                continue;
+            }
+        }
+        uint32_t length = 0, start = 0;
+        if (node->num_extents < FS_MAX_EXTENTS) {
+            start = findRun(img, need - have, &length);
+        }
+        if (node->num_extents == FS_MAX_EXTENTS || length == 0) {
+            setBlockCount(img, node, original);
+            return -1;
+        }
+        for (uint32_t b = 0; b < length; b++) {
+            setBlockUsed(img, start + b, 1);
+        }
+        node->extents[node->num_extents].start = start;
+        node->extents[node->num_extents].length = length;
+        node->num_extents++;
+        have += length;
+    }
+    return 0;
+}
+
+
+
+// Blocks holding the first `size` bytes of a block file
+static uint32_t blocksWithData(uint32_t size) {
+    return (uint32_t)(((uint64_t)size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE);
+}
+
+
+
+// Read or write bytes of a block file that lie within its blocks, through the
+// cache, one cache transfer per extent touched. A NULL write source writes zeros.
+// Blocks from `fresh` on hold no data yet, so writing them never reads the image.
+static int transferFile(FsImage *img, int inode, uint64_t offset, char *buffer, uint32_t length, int is_write,
+                        uint32_t fresh) {
+    const Inode *node = &img->inodes[inode];
+    uint32_t block = 0;
+    for (int e = 0; e < node->num_extents && length > 0; e++) {
+        uint64_t extent_bytes = (uint64_t)node->extents[e].length * FS_BLOCK_SIZE;
+        if (offset >= extent_bytes) {
+            offset -= extent_bytes;
+            block += node->extents[e].length;
+            continue;
+        }
+        uint32_t n = extent_bytes - offset < length ? (uint32_t)(extent_bytes - offset) : length;
+        uint32_t skip = (uint32_t)(offset / FS_BLOCK_SIZE);
+        if (cacheTransfer(&img->cache, (uint32_t)inode, block + skip, node->extents[e].start + skip,
+                          (uint32_t)(offset % FS_BLOCK_SIZE), buffer, n, is_write, fresh) != 0) {
+            return -1;
+        }
+        if (buffer) {
+            buffer += n;
+        }
+        block += node->extents[e].length;
+        length -= n;
+        offset = 0;
+    }
+    return 0;
+}
+
+
+
+// Resize a file; bytes from the old size up to zero_end (and the new size) are zeroed,
+// the rest of the new space is left for the caller to overwrite
+static int resize(FsImage *img, int inode, uint32_t size, uint32_t zero_end) {
+    Inode *node = &img->inodes[inode];
+    uint32_t old = node->size;
+    char inline_data[FS_INLINE_SIZE];
+
+    markInodeDirty(img, inode);
+    if (blocksFor(size) == 0) {
+        if (node->num_extents > 0) {
+            // Back to an inline file: keep what fits
+            uint32_t keep = old < size ? old : size;
+            if (transferFile(img, inode, 0, inline_data, keep, 0, UINT32_MAX) != 0) {
+                return -1;
+            }
+            setBlockCount(img, node, 0);
+            memcpy(node->data, inline_data, keep);
+        }
+        if (size > old) {
+            memset(node->data + old, 0, size - old);
+        }
+        node->size = size;
+        return 0;
+    }
+
+    if (node->num_extents == 0) {
+        // An inline file moves to blocks
+        memcpy(inline_data, node->data, old);
+        memset(node->data, 0, sizeof(node->data));
+        if (setBlockCount(img, node, blocksFor(size)) != 0) {
+            memcpy(node->data, inline_data, old);
+            return -1;
+        }
+        if (old > 0 && transferFile(img, inode, 0, inline_data, old, 1, 0) != 0) {
+            return -1;
+        }
+    } else if (setBlockCount(img, node, blocksFor(size)) != 0) {
+        return -1;
+    }
+    if (zero_end > size) {
+        zero_end = size;
+    }
+    if (zero_end > old && transferFile(img, inode, old, NULL, zero_end - old, 1, blocksWithData(old)) != 0) {
+        return -1;
+    }
+    node->size = size;
+    return 0;
+}
+
+
+
+int imageAllocInode(FsImage *img, const char *filename) {
+    if (img->num_free_inodes == 0) {
+        return -1;
+    }
+    int inode = img->free_inodes[--img->num_free_inodes];
+    Inode *node = &img->inodes[inode];
+    memset(node, 0, sizeof(*node));
+    strncpy(node->filename, filename, FS_NAME_SIZE - 1);
+    node->flags = FS_INODE_USED;
+    markInodeDirty(img, inode);
+    return inode;
+}
+
+
+
+void imageFreeInode(FsImage *img, int inode) {
+    Inode *node = &img->inodes[inode];
+    setBlockCount(img, node, 0);
+    memset(node, 0, sizeof(*node));
+    markInodeDirty(img, inode);
+    img->free_inodes[img->num_free_inodes++] = inode;
+}
+
+
+
+int imageTruncate(FsImage *img, int inode, uint32_t size) {
+    return resize(img, inode, size, size);
+}
+
+
+
+int imageRead(FsImage *img, int inode, uint32_t offset, char *buffer, uint32_t length) {
+    const Inode *node = &img->inodes[inode];
+    if (offset >= node->size) {
+        return 0;
+    }
+    if (length > node->size - offset) {
+        length = node->size - offset;
+    }
+    if (node->num_extents == 0) {
+        memcpy(buffer, node->data + offset, length);
+    } else if (transferFile(img, inode, offset, buffer, length, 0, UINT32_MAX) != 0) {
+        return -1;
+    }
+    return (int)length;
+}
+
+
+
+int imageWrite(FsImage *img, int inode, uint32_t offset, const char *data, uint32_t length) {
+    Inode *node = &img->inodes[inode];
+    if (length > UINT32_MAX - offset) {
+        return -1;
+    }
+    uint32_t end = offset + length;
+    uint32_t old = node->size;
+    if (end > old && resize(img, inode, end, offset) != 0) {
+        return -1;
+    }
+    // Up to the offset the file has data: its old contents, or the zeros resize() wrote
+    uint32_t fresh = blocksWithData(offset > old ? offset : old);
+    if (node->num_extents == 0) {
+        memcpy(node->data + offset, data, length);
+        markInodeDirty(img, inode);
+    } else if (transferFile(img, inode, offset, (char *)data, length, 1, fresh) != 0) {
+        return -1;
+    }
+    return (int)length;
+}
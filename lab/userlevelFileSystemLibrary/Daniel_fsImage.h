@@ -0,0 +1,203 @@
+#ifndef DANIEL_FSIMAGE_H
+#define DANIEL_FSIMAGE_H
+
+#include <stdint.h>
+#include "Daniel_blockCache.h"
+
+
+// ----- Constants -----
+#define FS_MAGIC "LIBFSIMG"           // Identifies an image file
+#define FS_VERSION 1
+#define FS_BLOCK_SIZE 4096            // Bytes per block
+#define FS_INODE_SIZE 256             // Bytes per inode (16 per block)
+#define FS_NAME_SIZE 52               // Filename bytes in an inode (holds MAX_FILENAME)
+#define FS_MAX_EXTENTS 24             // Extents per inode
+#define FS_INLINE_SIZE 192            // Files up to this size live in their inode
+#define FS_INODE_USED 1               // Inode flag: the inode holds a file
+
+
+// ----- Image layout -----
+//
+// block 0                   superblock
+// bitmap_start ..           free-block bitmap, one bit per block of the image
+// inode_start ..            inode table
+// data_start .. total - 1   file data, allocated in extents
+
+
+/**
+ * First block of the image.
+ */
+typedef struct {
+    char magic[8];            /**< FS_MAGIC */
+    uint32_t version;         /**< FS_VERSION */
+    uint32_t block_size;      /**< FS_BLOCK_SIZE */
+    uint32_t total_blocks;    /**< Blocks in the image, metadata included */
+    uint32_t inode_count;     /**< Inodes in the inode table */
+    uint32_t bitmap_start;    /**< First block of the bitmap */
+    uint32_t bitmap_blocks;   /**< Blocks of the bitmap */
+    uint32_t inode_start;     /**< First block of the inode table */
+    uint32_t inode_blocks;    /**< Blocks of the inode table */
+    uint32_t data_start;      /**< First data block */
+    uint32_t free_blocks;     /**< Data blocks not allocated */
+} Superblock;
+
+
+
+/**
+ * A run of consecutive data blocks.
+ */
+typedef struct {
+    uint32_t start;           /**< First block */
+    uint32_t length;          /**< Number of blocks */
+} Extent;
+
+
+
+/**
+ * A file: its name, size and where its data is.
+ * A file of up to FS_INLINE_SIZE bytes with no extents keeps its data in the
+ * inode itself, so small files share inode table blocks instead of taking a
+ * data block each.
+ */
+typedef struct {
+    char filename[FS_NAME_SIZE];           /**< Name of the file */
+    uint32_t size;                         /**< Size of the file in bytes */
+    uint16_t flags;                        /**< FS_INODE_USED if the inode holds a file */
+    uint16_t num_extents;                  /**< Extents in use (0 for an inline file) */
+    uint32_t reserved;                     /**< Unused (zero) */
+    union {
+        Extent extents[FS_MAX_EXTENTS];    /**< Data of a block file, in file order */
+        char data[FS_INLINE_SIZE];         /**< Data of an inline file */
+    };
+} Inode;
+
+
+
+/**
+ * A mounted image.
+ * The superblock, bitmap and inode table are held in memory and written back
+ * by imageSync(), only the blocks that changed. File data goes through a
+ * write-back block cache; imageSync() writes its dirty blocks first.
+ */
+typedef struct {
+    int fd;                    /**< Image file */
+    Superblock super;          /**< Superblock */
+    unsigned char *bitmap;     /**< Free-block bitmap (bit set: block in use) */
+    Inode *inodes;             /**< Inode table */
+    unsigned char *dirty;      /**< One flag per metadata block: changed since the last sync */
+    int *free_inodes;          /**< Stack of free inode numbers, lowest on top */
+    int num_free_inodes;       /**< Entries in free_inodes */
+    uint32_t hint;             /**< Where the next block allocation starts looking */
+    BlockCache cache;          /**< Cached blocks of file data */
+} FsImage;
+
+
+
+// ----- Function prototypes -----
+
+
+/**
+ * Creates an empty image file, preallocating all its blocks.
+ *
+ * @param path Image file to create (overwritten if it exists).
+ * @param blocks Blocks in the image, metadata included.
+ * @param inodes Most files the image can hold (rounded up to fill the inode table blocks).
+ * @return 0 if successful, or -1 if an error occurs.
+ */
+int imageFormat(const char *path, uint32_t blocks, uint32_t inodes);
+
+
+
+/**
+ * Opens an image, loads its metadata and sets up its block cache.
+ *
+ * @param img Image to fill in.
+ * @param path Image file.
+ * @param cache_blocks Blocks of file data to cache.
+ * @return 0 if successful, or -1 if an error occurs (not an image, I/O or allocation failure).
+ */
+int imageOpen(FsImage *img, const char *path, int cache_blocks);
+
+
+
+/**
+ * Writes the dirty cached file blocks, then the changed metadata blocks, back to the image file.
+ *
+ * @param img Image.
+ * @return 0 if successful, or -1 if an error occurs.
+ */
+int imageSync(FsImage *img);
+
+
+
+/**
+ * Syncs the image and releases it.
+ *
+ * @param img Image.
+ * @return 0 if successful, or -1 if the sync failed.
+ */
+int imageClose(FsImage *img);
+
+
+
+/**
+ * Takes a free inode for a new, empty file.
+ *
+ * @param img Image.
+ * @param filename Name of the file (shorter than FS_NAME_SIZE).
+ * @return The inode number, or -1 if every inode is in use.
+ */
+int imageAllocInode(FsImage *img, const char *filename);
+
+
+
+/**
+ * Frees an inode and the blocks of its file.
+ *
+ * @param img Image.
+ * @param inode Inode number.
+ */
+void imageFreeInode(FsImage *img, int inode);
+
+
+
+/**
+ * Sets the size of a file, allocating or freeing blocks; new bytes read as zeros.
+ *
+ * @param img Image.
+ * @param inode Inode number.
+ * @param size New size in bytes.
+ * @return 0 if successful, or -1 if the image is full or the file needs more than FS_MAX_EXTENTS extents.
+ */
+int imageTruncate(FsImage *img, int inode, uint32_t size);
+
+
+
+/**
+ * Reads from a file.
+ *
+ * @param img Image.
+ * @param inode Inode number.
+ * @param offset Byte offset in the file.
+ * @param buffer Where to store the data.
+ * @param length Most bytes to read.
+ * @return The number of bytes read (0 at or past the end), or -1 if an error occurs.
+ */
+int imageRead(FsImage *img, int inode, uint32_t offset, char *buffer, uint32_t length);
+
+
+
+/**
+ * Writes to a file, extending it if the write ends past its size.
+ *
+ * @param img Image.
+ * @param inode Inode number.
+ * @param offset Byte offset in the file (a gap past the end reads as zeros).
+ * @param data Data to write.
+ * @param length Number of bytes.
+ * @return The number of bytes written, or -1 if the image is full, the file needs more than
+ *         FS_MAX_EXTENTS extents, or an I/O error occurs.
+ */
+int imageWrite(FsImage *img, int inode, uint32_t offset, const char *data, uint32_t length);
+
+#endif // DANIEL_FSIMAGE_H
@@ -1,123 +1,428 @@
 #include "Daniel_libFS.h"
+#include <limits.h>  // For INT_MAX
 
 
 // Global variables
-FileEntry file_table[MAX_FILES];  // File table to track files
+FileEntry *file_table = NULL;     // File table to track files (grows as needed)
 int file_count = 0;               // Number of files in the system
+int file_table_size = 0;          // Entries handed out so far
+int fs_verbose = 1;               // Print success messages
+int fs_cache_blocks = DEFAULT_CACHE_BLOCKS;  // Cache size of the next mount
+
+// File table storage and free list of deleted entries
+static int file_table_capacity = 0;
+static int free_head = -1;
+
+// Mounted image holding the files
+static FsImage image;
+static int mounted = 0;
+static int exit_hook = 0;
+
+// Filename index: open addressing with linear probing over a power-of-two
+// bucket array. Each bucket holds a file index, INDEX_EMPTY, or INDEX_DELETED
+// (a tombstone left by fileDelete so later probes continue past it).
+#define INDEX_EMPTY -1
+#define INDEX_DELETED -2
+#define INDEX_MIN_BUCKETS 64
+static int *index_buckets = NULL;
+static int index_capacity = 0;
+static int index_used = 0;        // Live entries plus tombstones
+
+
+
+// Hash a filename (FNV-1a)
+static unsigned int hashName(const char *filename) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)filename; *c; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
+
+
+// Find the bucket holding a filename, or -1 if it is not indexed
+static int indexFind(const char *filename, unsigned int hash) {
+    if (index_capacity == 0) {
+        return -1;
+    }
+    unsigned int mask = index_capacity - 1;
+    for (unsigned int b = hash & mask; ; b = (b + 1) & mask) {
+        int i = index_buckets[b];
+        if (i == INDEX_EMPTY) {
+            return -1;
+        }
+        if (i != INDEX_DELETED && file_table[i].hash == hash && strcmp(file_table[i].filename, filename) == 0) {
+            return (int)b;
+        }
+    }
+}
+
+
+
+// Rebuild the index for the live files and one more, at most 1/4 full, dropping tombstones
+static int indexRebuild(void) {
+    int capacity = INDEX_MIN_BUCKETS;
+    while (capacity < (file_count + 1) * 4) {
+        capacity *= 2;
+    }
+    int *buckets = (int *)malloc(capacity * sizeof(int));
+    if (!buckets) {
+        return -1;
+    }
+    for (int b = 0; b < capacity; b++) {
+        buckets[b] = INDEX_EMPTY;
+    }
+    unsigned int mask = capacity - 1;
+    for (int i = 0; i < file_table_size; i++) {
+        if (file_table[i].in_use) {
+            unsigned int b = file_table[i].hash & mask;
+            while (buckets[b] != INDEX_EMPTY) {
+                b = (b + 1) & mask;
+            }
+            buckets[b] = i;
+        }
+    }
+    free(index_buckets);
+    index_buckets = buckets;
+    index_capacity = capacity;
+    index_used = file_count;
+    return 0;
+}
+
+
+
+// Add a file to the index (it must not be indexed already)
+static int indexInsert(int file_index) {
+    // Keep the table at most 3/4 full, tombstones included, so probes stay short
+    if ((index_used + 1) * 4 > index_capacity * 3 && indexRebuild() != 0) {
+        return -1;
+    }
+    unsigned int mask = index_capacity - 1;
+    unsigned int b = file_table[file_index].hash & mask;
+    while (index_buckets[b] != INDEX_EMPTY && index_buckets[b] != INDEX_DELETED) {
+        b = (b + 1) & mask;
+    }
+    if (index_buckets[b] == INDEX_EMPTY) {
+        index_used++;
+    }
+    index_buckets[b] = file_index;
+    return 0;
+}
+
+
+
+// Take an entry for a new file: a deleted one if any, else a new one at the end
+static int allocateEntry(void) {
+    if (free_head != -1) {
+        int i = free_head;
+        free_head = file_table[i].next_free;
+        return i;
+    }
+    if (file_table_size == file_table_capacity) {
+        int capacity = file_table_capacity ? file_table_capacity * 2 : 64;
+        FileEntry *grown = (FileEntry *)realloc(file_table, capacity * sizeof(FileEntry));
+        if (!grown) {
+            return -1;
+        }
+        file_table = grown;
+        file_table_capacity = capacity;
+    }
+    return file_table_size++;
+}
+
+
+
+// Add a file of the image to the file table and the index
+static int addEntry(const char *filename, unsigned int hash, int inode) {
+    int i = allocateEntry();
+    if (i == -1) {
+        return -1;
+    }
+    strncpy(file_table[i].filename, filename, MAX_FILENAME - 1);
+    file_table[i].filename[MAX_FILENAME - 1] = '\0';
+    file_table[i].size = (int)image.inodes[inode].size;
+    file_table[i].is_open = 0;  // File is closed
+    file_table[i].in_use = 0;   // Not yet: a rebuild during the insert must not index it twice
+    file_table[i].next_free = -1;
+    file_table[i].hash = hash;
+    file_table[i].inode = inode;
+    file_table[i].offset = 0;
+    file_table[i].open_flags = 0;
+    if (indexInsert(i) != 0) {
+        file_table[i].next_free = free_head;
+        free_head = i;
+        return -1;
+    }
+    file_table[i].in_use = 1;
+    file_count++;
+    return i;
+}
+
+
+
+// Release the file table and the index
+static void releaseTable(void) {
+    free(file_table);
+    free(index_buckets);
+    file_table = NULL;
+    index_buckets = NULL;
+    file_count = file_table_size = file_table_capacity = 0;
+    index_capacity = index_used = 0;
+    free_head = -1;
+}
+
+
+
+// Unmount at exit, so an image left mounted still gets its metadata
+static void unmountAtExit(void) {
+    if (mounted) {
+        fileSystemUnmount();
+    }
+}
+
+
+
+// Mount the default image if no image is mounted yet
+static int ensureMounted(void) {
+    if (mounted) {
+        return 0;
+    }
+    if (access(DEFAULT_IMAGE, F_OK) != 0) {
+        if (fileSystemFormat(DEFAULT_IMAGE, DEFAULT_IMAGE_BLOCKS, DEFAULT_IMAGE_INODES) != 0) {
+            return -1;
+        }
+        if (fs_verbose) printf("Formatted new image '%s'.\n", DEFAULT_IMAGE);
+    }
+    return fileSystemMount(DEFAULT_IMAGE);
+}
+
+
+
+// Check that an index refers to a file
+static int validIndex(int file_index) {
+    if (file_index < 0 || file_index >= file_table_size || !file_table[file_index].in_use) {
+        printf("Error: Invalid file index %d.\n", file_index);
+        return 0;
+    }
+    return 1;
+}
 
 
 
 // Create a new file
 int fileCreate(const char *filename) {
 
+    if (ensureMounted() != 0) {
+        return -1;
+    }
+    if (strlen(filename) >= MAX_FILENAME) {
+        printf("Error: File name '%s' is too long.\n", filename);
+        return -1;
+    }
+
     // Check if file already exists
-    for (int i = 0; i < file_count; i++) {
-        if (strcmp(file_table[i].filename, filename) == 0) {
-            printf("Error: File '%s' already exists.\n", filename);
-            return -1;
-        }
+    unsigned int hash = hashName(filename);
+    if (indexFind(filename, hash) != -1) {
+        printf("Error: File '%s' already exists.\n", filename);
+        return -1;
     }
 
-    // Create the file on the local disk
-    FILE *file = fopen(filename, "w");
-    if (!file) {
-        printf("Error: Unable to create file '%s'.\n", filename);
+    // Create the file in the image
+    int inode = imageAllocInode(&image, filename);
+    if (inode == -1) {
+        printf("Error: Unable to create file '%s': the image has no free inode.\n", filename);
         return -1;
     }
-    fclose(file);
 
-    // Add file to the file table
-    strcpy(file_table[file_count].filename, filename);
-    file_table[file_count].size = 0;
-    file_table[file_count].is_open = 0;  // File is closed
-    file_count++;
+    // Add file to the file table and the index
+    if (addEntry(filename, hash, inode) == -1) {
+        printf("Error: Unable to grow the file table for '%s'.\n", filename);
+        imageFreeInode(&image, inode);
+        return -1;
+    }
 
-    printf("File '%s' created successfully.\n", filename);
+    if (fs_verbose) printf("File '%s' created successfully.\n", filename);
     return 0;
 }
 
 
 
+// Check that an index refers to an open file
+static int validOpen(int file_index) {
+    if (!validIndex(file_index)) {
+        return 0;
+    }
+    if (!file_table[file_index].is_open) {
+        printf("Error: File '%s' is not open.\n", file_table[file_index].filename);
+        return 0;
+    }
+    return 1;
+}
+
+
+
+// Read from a file in the image
+static int readAt(int file_index, int offset, char *buffer, int length) {
+    if (offset < 0 || length < 0) {
+        printf("Error: Invalid read of %d bytes at offset %d from file '%s'.\n", length, offset,
+               file_table[file_index].filename);
+        return -1;
+    }
+    int bytes_read = length > 0 ? imageRead(&image, file_table[file_index].inode, offset, buffer, length) : 0;
+    if (bytes_read < 0) {
+        printf("Error: Failed to read from file '%s'.\n", file_table[file_index].filename);
+        return -1;
+    }
+    return bytes_read;
+}
+
+
+
+// Write to a file in the image and keep its size in the file table
+static int writeAt(int file_index, int offset, const char *data, int length) {
+    if (offset < 0 || length < 0 || length > INT_MAX - offset) {
+        printf("Error: Invalid write of %d bytes at offset %d to file '%s'.\n", length, offset,
+               file_table[file_index].filename);
+        return -1;
+    }
+    int inode = file_table[file_index].inode;
+    int written = length > 0 ? imageWrite(&image, inode, offset, data, length) : 0;
+    file_table[file_index].size = (int)image.inodes[inode].size;
+    if (written != length) {
+        printf("Error: Unable to write file '%s': the image is full or the file too fragmented.\n",
+               file_table[file_index].filename);
+        return -1;
+    }
+    return written;
+}
+
+
+
 // Open a file
 int fileOpen(const char *filename) {
-    for (int i = 0; i < file_count; i++) {
-        if (strcmp(file_table[i].filename, filename) == 0) {
-            if (file_table[i].is_open) {
-                printf("Error: File '%s' is already open.\n", filename);
-                return -1;
-            }
-            file_table[i].is_open = 1;  // Mark file as open
-            printf("File '%s' opened successfully.\n", filename);
-            return i;  // Return file index
-        }
+    return fileOpenMode(filename, 0);
+}
+
+
+
+// Open a file with options
+int fileOpenMode(const char *filename, int flags) {
+    if (ensureMounted() != 0) {
+        return -1;
+    }
+    int b = indexFind(filename, hashName(filename));
+    if (b == -1) {
+        printf("Error: File '%s' not found.\n", filename);
+        return -1;
     }
 
-    printf("Error: File '%s' not found.\n", filename);
-    return -1;
+    int i = index_buckets[b];
+    if (file_table[i].is_open) {
+        printf("Error: File '%s' is already open.\n", filename);
+        return -1;
+    }
+    if ((flags & FILE_TRUNCATE) && file_table[i].size > 0) {
+        if (imageTruncate(&image, file_table[i].inode, 0) != 0) {
+            printf("Error: Unable to truncate file '%s'.\n", filename);
+            return -1;
+        }
+        file_table[i].size = 0;
+    }
+    file_table[i].is_open = 1;  // Mark file as open
+    file_table[i].offset = 0;
+    file_table[i].open_flags = flags & FILE_APPEND;
+    if (fs_verbose) printf("File '%s' opened successfully.\n", filename);
+    return i;  // Return file index
 }
 
 
 
-// Write data to a file
+// Write data at the offset of a file
 int fileWrite(int file_index, const char *data) {
-
-    if (!file_table[file_index].is_open) {
-        printf("Error: File '%s' is not open.\n", file_table[file_index].filename);
+    // Validate file index
+    if (!validOpen(file_index)) {
         return -1;
     }
 
+    // Append mode writes at the end whatever the offset
+    int offset = (file_table[file_index].open_flags & FILE_APPEND) ? file_table[file_index].size
+                                                                    : file_table[file_index].offset;
     int data_size = strlen(data);
-
-    // Write data to the local file
-    FILE *file = fopen(file_table[file_index].filename, "w");
-    if (!file) {
-        printf("Error: Unable to open file '%s' for writing.\n", file_table[file_index].filename);
+    if (writeAt(file_index, offset, data, data_size) == -1) {
         return -1;
     }
-    fwrite(data, 1, data_size, file);
-    fclose(file);
 
-    file_table[file_index].size = data_size;
-    printf("Data written to file '%s' successfully.\n", file_table[file_index].filename);
+    file_table[file_index].offset = offset + data_size;
+    if (fs_verbose) printf("Data written to file '%s' successfully.\n", file_table[file_index].filename);
     return 0;
 }
 
 
 
-// Read data from a file
+// Read data from the offset of a file
 int fileRead(int file_index, char *buffer, int buffer_size) {
     // Validate file index
-    if (file_index < 0 || file_index >= file_count) {
-        printf("Error: Invalid file index %d.\n", file_index);
+    if (!validOpen(file_index)) {
         return -1;
     }
 
-    // Check if the file is open
-    if (!file_table[file_index].is_open) {
-        printf("Error: File '%s' is not open.\n", file_table[file_index].filename);
+    int bytes_read = readAt(file_index, file_table[file_index].offset, buffer, buffer_size);
+    if (bytes_read == -1) {
+        return -1;
+    }
+
+    file_table[file_index].offset += bytes_read;
+    if (fs_verbose) printf("Read %d bytes from file '%s' successfully.\n", bytes_read, file_table[file_index].filename);
+    return bytes_read;
+}
+
+
+
+// Move the offset of a file
+int fileSeek(int file_index, int offset, int whence) {
+    if (!validOpen(file_index)) {
         return -1;
     }
 
-    // Open the file in read mode
-    FILE *file = fopen(file_table[file_index].filename, "r");
-    if (!file) {
-        printf("Error: Unable to open file '%s' for reading.\n", file_table[file_index].filename);
+    int base;
+    if (whence == SEEK_SET) {
+        base = 0;
+    } else if (whence == SEEK_CUR) {
+        base = file_table[file_index].offset;
+    } else if (whence == SEEK_END) {
+        base = file_table[file_index].size;
+    } else {
+        printf("Error: Invalid seek origin %d.\n", whence);
+        return -1;
+    }
+    if ((offset < 0 && base + offset < 0) || (offset > 0 && offset > INT_MAX - base)) {
+        printf("Error: Seek to an invalid offset in file '%s'.\n", file_table[file_index].filename);
         return -1;
     }
 
-    // Read data from the file
-    size_t bytes_read = fread(buffer, 1, buffer_size, file);
-    if (ferror(file)) {
-        printf("Error: Failed to read from file '%s'.\n", file_table[file_index].filename);
-        fclose(file);
+    file_table[file_index].offset = base + offset;
+    return file_table[file_index].offset;
+}
+
+
+
+// Read data from a position of a file
+int fileReadAt(int file_index, int offset, char *buffer, int length) {
+    if (!validOpen(file_index)) {
         return -1;
     }
+    return readAt(file_index, offset, buffer, length);
+}
 
-    // Close the file
-    fclose(file);
 
-    printf("Read %zu bytes from file '%s' successfully.\n", bytes_read, file_table[file_index].filename);
-    return (int)bytes_read;
+
+// Write data at a position of a file
+int fileWriteAt(int file_index, int offset, const char *data, int length) {
+    if (!validOpen(file_index)) {
+        return -1;
+    }
+    return writeAt(file_index, offset, data, length);
 }
 
 
@@ -125,8 +430,7 @@ int fileRead(int file_index, char *buffer, int buffer_size) {
 // Close a file
 int fileClose(int file_index) {
     // Validate file index
-    if (file_index < 0 || file_index >= file_count) {
-        printf("Error: Invalid file index %d.\n", file_index);
+    if (!validIndex(file_index)) {
         return -1;
     }
 
@@ -139,7 +443,7 @@ int fileClose(int file_index) {
     // Mark the file as closed
     file_table[file_index].is_open = 0;
 
-    printf("File '%s' closed successfully.\n", file_table[file_index].filename);
+    if (fs_verbose) printf("File '%s' closed successfully.\n", file_table[file_index].filename);
     return 0;
 }
 
@@ -147,20 +451,19 @@ int fileClose(int file_index) {
 
 // Delete a file
 int fileDelete(const char *filename) {
-    // Find the file in the file table
-    int file_index = -1;
-    for (int i = 0; i < file_count; i++) {
-        if (strcmp(file_table[i].filename, filename) == 0) {
-            file_index = i;
-            break;
-        }
+    if (ensureMounted() != 0) {
+        return -1;
     }
 
+    // Find the file in the index
+    int b = indexFind(filename, hashName(filename));
+
     // Check if the file was found
-    if (file_index == -1) {
+    if (b == -1) {
         printf("Error: File '%s' not found.\n", filename);
         return -1;
     }
+    int file_index = index_buckets[b];
 
     // Check if the file is open
     if (file_table[file_index].is_open) {
@@ -168,18 +471,104 @@ int fileDelete(const char *filename) {
         return -1;
     }
 
-    // Delete the file from the local disk
-    if (remove(filename) != 0) {
-        printf("Error: Unable to delete file '%s'.\n", filename);
+    // Free its inode and blocks in the image
+    imageFreeInode(&image, file_table[file_index].inode);
+
+    // Leave a tombstone in the index and put the entry on the free list;
+    // the other files keep their indices
+    index_buckets[b] = INDEX_DELETED;
+    file_table[file_index].in_use = 0;
+    file_table[file_index].next_free = free_head;
+    free_head = file_index;
+    file_count--;
+
+    if (fs_verbose) printf("File '%s' deleted successfully.\n", filename);
+    return 0;
+}
+
+
+
+// Create an empty image
+int fileSystemFormat(const char *image_path, int blocks, int inodes) {
+    if (blocks < 1 || inodes < 1) {
+        printf("Error: Invalid image size %d blocks, %d inodes.\n", blocks, inodes);
         return -1;
     }
+    return imageFormat(image_path, (uint32_t)blocks, (uint32_t)inodes);
+}
 
-    // Remove the file from the file table by shifting subsequent entries
-    for (int i = file_index; i < file_count - 1; i++) {
-        file_table[i] = file_table[i + 1];
+
+
+// Mount an image and load its files into the file table
+int fileSystemMount(const char *image_path) {
+    if (mounted) {
+        printf("Error: An image is already mounted.\n");
+        return -1;
+    }
+    if (imageOpen(&image, image_path, fs_cache_blocks) != 0) {
+        printf("Error: Unable to mount image '%s'.\n", image_path);
+        return -1;
+    }
+    mounted = 1;
+    if (!exit_hook) {
+        exit_hook = atexit(unmountAtExit) == 0;
     }
-    file_count--;
 
-    printf("File '%s' deleted successfully.\n", filename);
+    for (uint32_t inode = 0; inode < image.super.inode_count; inode++) {
+        const Inode *node = &image.inodes[inode];
+        if (!(node->flags & FS_INODE_USED)) {
+            continue;
+        }
+        if (!memchr(node->filename, '\0', MAX_FILENAME)) {
+            printf("Error: Image '%s' has a file name of %d characters or more.\n", image_path, MAX_FILENAME);
+            fileSystemUnmount();
+            return -1;
+        }
+        if (addEntry(node->filename, hashName(node->filename), (int)inode) == -1) {
+            printf("Error: Out of memory loading image '%s'.\n", image_path);
+            fileSystemUnmount();
+            return -1;
+        }
+    }
+    if (fs_verbose) printf("Mounted image '%s' with %d files.\n", image_path, file_count);
+    return 0;
+}
+
+
+
+// Write the changed metadata to the image
+int fileSystemSync(void) {
+    if (mounted && imageSync(&image) != 0) {
+        printf("Error: Unable to sync the image.\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+
+// Read the counters of the block cache
+int fileSystemCacheStats(CacheStats *stats) {
+    if (!mounted) {
+        printf("Error: No image is mounted.\n");
+        return -1;
+    }
+    cacheGetStats(&image.cache, stats);
     return 0;
 }
+
+
+
+// Unmount the image and release the file table and the index
+int fileSystemUnmount(void) {
+    int status = 0;
+    if (mounted) {
+        if (imageClose(&image) != 0) {
+            printf("Error: Unable to sync the image.\n");
+            status = -1;
+        }
+        mounted = 0;
+    }
+    releaseTable();
+    return status;
+}
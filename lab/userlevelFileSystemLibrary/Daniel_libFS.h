@@ -4,13 +4,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unistd.h> // For unlink() function (used in file deletion)
+#include <unistd.h>
+#include "Daniel_fsImage.h"
 
 
 // ----- Constants -----
-#define MAX_FILES 100
 #define MAX_FILENAME 50
 #define MAX_FILE_SIZE 1024
+#define DEFAULT_IMAGE "libFS.img"   // Image mounted by the first file operation if none is
+#define DEFAULT_IMAGE_BLOCKS 16384  // Size of a default image: 64 MiB
+#define DEFAULT_IMAGE_INODES 16384  // Files a default image can hold
+#define DEFAULT_CACHE_BLOCKS 4096   // Blocks of file data cached while an image is mounted: 16 MiB
+#define FILE_APPEND 1               // fileOpenMode(): every write goes to the end of the file
+#define FILE_TRUNCATE 2             // fileOpenMode(): empty the file when opening it
 
 
 // ----- File system structures -----
@@ -18,21 +24,31 @@
 
 /**
  * Structure representing a file entry in the file system.
+ * A file keeps its entry (and so its index) from creation to deletion;
+ * the entry of a deleted file is reused by a later fileCreate().
  */
 typedef struct {
     char filename[MAX_FILENAME]; /**< Name of the file */
     int size;                    /**< Size of the file in bytes */
     int is_open;                 /**< Flag indicating if the file is open (1) or closed (0) */
+    int in_use;                  /**< Flag indicating if the entry holds a file (1) or is free (0) */
+    int next_free;               /**< Next free entry after this one, or -1 (free entries only) */
+    unsigned int hash;           /**< Hash of the filename, kept for the index */
+    int inode;                   /**< Inode holding the file in the image */
+    int offset;                  /**< Position of the next fileRead()/fileWrite() while open */
+    int open_flags;              /**< FILE_APPEND if the file was opened for appending */
 } FileEntry;
 
 
 
 // ----- Global Variables -----
 /**
- * Global file table tracking all files in the system.
+ * Global file table tracking all files in the system, indexed by file index.
  * Defined in Daniel_libFS.c, but referenced in other files using `extern`.
+ * It grows as files are created, so it has no fixed limit; entries may move
+ * in memory when it grows, so keep indices rather than pointers to them.
  */
-extern FileEntry file_table[MAX_FILES];
+extern FileEntry *file_table;
 
 
 
@@ -43,6 +59,27 @@ extern int file_count;
 
 
 
+/**
+ * Number of entries of file_table handed out so far (valid indices are below it).
+ */
+extern int file_table_size;
+
+
+
+/**
+ * Set to 0 to silence the success messages of the file operations (errors are still printed).
+ */
+extern int fs_verbose;
+
+
+
+/**
+ * Blocks of file data the next fileSystemMount() caches (DEFAULT_CACHE_BLOCKS unless changed).
+ */
+extern int fs_cache_blocks;
+
+
+
 // ----- Function prototypes -----
 
 
@@ -57,7 +94,9 @@ int fileCreate(const char *filename);
 
 
 /**
- * Opens an existing file in the file system.
+ * Opens an existing file in the file system for reading and writing, at offset 0.
+ * Files are found through a hash index on the filename, so the cost does
+ * not depend on the number of files.
  *
  * @param filename The name of the file to open.
  * @return The index of the file in the file table if successful, or -1 if an error occurs.
@@ -67,7 +106,20 @@ int fileOpen(const char *filename);
 
 
 /**
- * Writes data to an open file.
+ * Opens an existing file like fileOpen(), with options.
+ *
+ * @param filename The name of the file to open.
+ * @param flags 0, or FILE_APPEND and/or FILE_TRUNCATE.
+ * @return The index of the file in the file table if successful, or -1 if an error occurs.
+ */
+int fileOpenMode(const char *filename, int flags);
+
+
+
+/**
+ * Writes a string (without its terminating null) at the offset of an open
+ * file, or at its end if it was opened with FILE_APPEND, and moves the
+ * offset past it. Writing past the end extends the file; a gap reads as zeros.
  *
  * @param file_index The index of the file in the file table.
  * @param data The data to write to the file.
@@ -78,17 +130,56 @@ int fileWrite(int file_index, const char *data);
 
 
 /**
- * Reads data from an open file.
+ * Reads data from the offset of an open file and moves the offset past it.
  *
  * @param file_index The index of the file in the file table.
  * @param buffer The buffer where the read data will be stored.
  * @param buffer_size The size of the buffer.
- * @return The number of bytes read, or -1 if an error occurs.
+ * @return The number of bytes read (0 at the end of the file), or -1 if an error occurs.
  */
 int fileRead(int file_index, char *buffer, int buffer_size);
 
 
 
+/**
+ * Moves the offset of an open file.
+ *
+ * @param file_index The index of the file in the file table.
+ * @param offset Bytes from the position given by whence (may be negative).
+ * @param whence SEEK_SET (start of the file), SEEK_CUR (current offset) or SEEK_END (end of the file).
+ * @return The new offset, or -1 if an error occurs (it would be negative).
+ */
+int fileSeek(int file_index, int offset, int whence);
+
+
+
+/**
+ * Reads from an open file at a given position, without using or moving its offset.
+ *
+ * @param file_index The index of the file in the file table.
+ * @param offset Byte position in the file.
+ * @param buffer The buffer where the read data will be stored.
+ * @param length The most bytes to read.
+ * @return The number of bytes read (0 at or past the end of the file), or -1 if an error occurs.
+ */
+int fileReadAt(int file_index, int offset, char *buffer, int length);
+
+
+
+/**
+ * Writes to an open file at a given position, without using or moving its
+ * offset (also in append mode).
+ *
+ * @param file_index The index of the file in the file table.
+ * @param offset Byte position in the file.
+ * @param data The data to write.
+ * @param length The number of bytes to write.
+ * @return The number of bytes written, or -1 if an error occurs.
+ */
+int fileWriteAt(int file_index, int offset, const char *data, int length);
+
+
+
 /**
  * Closes an open file.
  *
@@ -101,10 +192,69 @@ int fileClose(int file_index);
 
 /**
  * Deletes a file from the file system.
+ * The indices of the other files do not change.
  *
  * @param filename The name of the file to delete.
  * @return 0 if successful, or -1 if an error occurs.
  */
 int fileDelete(const char *filename);
 
+
+
+/**
+ * Creates an empty image file that can be mounted with fileSystemMount().
+ *
+ * @param image_path The image file to create (overwritten if it exists).
+ * @param blocks Size of the image in FS_BLOCK_SIZE blocks, metadata included.
+ * @param inodes The most files the image can hold.
+ * @return 0 if successful, or -1 if an error occurs.
+ */
+int fileSystemFormat(const char *image_path, int blocks, int inodes);
+
+
+
+/**
+ * Mounts an image: its files become the files of the file system.
+ * The first file operation mounts DEFAULT_IMAGE (formatting it if it does
+ * not exist) unless an image is mounted already.
+ *
+ * @param image_path The image file.
+ * @return 0 if successful, or -1 if an error occurs (an image is mounted already, or it is not an image).
+ */
+int fileSystemMount(const char *image_path);
+
+
+
+/**
+ * Writes the cached file blocks that changed, then the changed metadata
+ * (file sizes, names, allocation), to the image. Small files live in their
+ * inode and reach the image with the metadata. A background flusher also
+ * writes changed blocks every CACHE_FLUSH_MS, but only a sync makes the
+ * metadata that points at them durable.
+ *
+ * @return 0 if successful, or -1 if an error occurs.
+ */
+int fileSystemSync(void);
+
+
+
+/**
+ * Reads the counters of the block cache of the mounted image (hits, misses,
+ * disk reads, write-backs, evictions).
+ *
+ * @param stats Where to store the counters.
+ * @return 0 if successful, or -1 if no image is mounted.
+ */
+int fileSystemCacheStats(CacheStats *stats);
+
+
+
+/**
+ * Syncs and unmounts the image and releases the file table and its index.
+ * Also runs at exit for an image still mounted.
+ *
+ * @return 0 if successful, or -1 if the final sync failed.
+ */
+int fileSystemUnmount(void);
+
 #endif // DANIEL_LIBFS_H
\ No newline at end of file
@@ -11,7 +11,8 @@ void displayMenu() {
     printf("4. Read from a file\n");
     printf("5. Close a file\n");
     printf("6. Delete a file\n");
-    printf("7. Exit\n");
+    printf("7. Seek in a file\n");
+    printf("8. Exit\n");
     printf("Enter your choice: ");
 }
 
@@ -62,7 +63,10 @@ int main() {
                     break;
                 }
                 filename[strcspn(filename, "\n")] = '\0';  // Remove newline
-                file_index = fileOpen(filename);
+                printf("Open for appending? (y/n): ");
+                char answer[8];
+                int append = fgets(answer, sizeof(answer), stdin) != NULL && tolower((unsigned char)answer[0]) == 'y';
+                file_index = fileOpenMode(filename, append ? FILE_APPEND : 0);
                 if (file_index == -1) {
                     printf("Error opening file.\n");
                 }
@@ -132,7 +136,23 @@ int main() {
                 waitForUser();
                 break;
 
-            case 7:  // Exit
+            case 7:  // Seek in a file
+                if (file_index == -1) {
+                    printf("Error: No file is open. Please open a file first.\n");
+                } else {
+                    int offset;
+                    printf("Enter the offset to move to (bytes from the start): ");
+                    if (scanf("%d", &offset) != 1) {
+                        printf("Invalid input. Please enter a number.\n");
+                    } else if (fileSeek(file_index, offset, SEEK_SET) != -1) {
+                        printf("Offset of file '%s' is now %d.\n", file_table[file_index].filename, offset);
+                    }
+                    while (getchar() != '\n');  // Clear the rest of the line
+                }
+                waitForUser();
+                break;
+
+            case 8:  // Exit
                 printf("Exiting the program. Goodbye!\n");
                 return 0;
 
@@ -0,0 +1,232 @@
+/**
+ * @file client.c
+ * @brief Tic-Tac-Toe Client - Joins matchmaking on the server and plays one game.
+ *
+ * The client keeps its own copy of the board and applies the server's DELTA
+ * messages to it, so the board is never transferred in full. If the host dies
+ * mid-game the client reconnects (to the failover address, if given) and
+ * RESUMEs the game from the standby's SNAPSHOT.
+ *
+ * Usage: ./client [-a] <server_ip> [port] [failover_ip]   play (-a: automatic random moves)
+ *        ./client -s <server_ip> [port]                   run as the host's standby
+ *        ./client -w <game_id> <server_ip> [port]         spectate a live game
+ */
+
+#include <getopt.h>
+#include <time.h>
+#include "tictactoe.h"
+#include "protocol.h"
+
+#define RECONNECT_INTERVAL_MS 100   /**< Delay between reconnection attempts */
+#define RECONNECT_TIMEOUT_MS 10000  /**< Give up resuming after this long */
+#define AUTO_MOVE_DELAY_MS 200      /**< Think time of the automatic player */
+
+/**
+ * @brief Connects a TCP socket to the server.
+ * @return Socket descriptor, or -1 on failure.
+ */
+static int connectToServer(const char *ip, int port, int quiet) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        perror("Socket creation failed");
+        return -1;
+    }
+
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) <= 0) {
+        perror("Invalid address");
+        close(sock);
+        return -1;
+    }
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        if (!quiet) perror("Connection failed");
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+/**
+ * @brief Picks a cell (from stdin, or at random in automatic mode) and sends the MOVE.
+ */
+static int sendMove(int sock, Game *game, OutBuf *out, int automatic) {
+    int position;
+
+    if (automatic) {
+        struct timespec delay = { 0, AUTO_MOVE_DELAY_MS * 1000000L };
+        nanosleep(&delay, NULL);
+        do {
+            position = rand() % NUM_CELLS;
+        } while (game->board[position / MAX_SIZE][position % MAX_SIZE] != EMPTY_CELL);
+        printf("Playing cell %d\n", position + 1);
+    } else {
+        while (1) {
+            printf("Your move (1-%d): ", NUM_CELLS);
+            fflush(stdout);
+            if (scanf("%d", &position) != 1) {
+                if (feof(stdin)) return -1;
+                while (getchar() != '\n');  // Clear invalid input
+                continue;
+            }
+            position--;
+            if (position >= 0 && position < NUM_CELLS &&
+                game->board[position / MAX_SIZE][position % MAX_SIZE] == EMPTY_CELL) {
+                break;
+            }
+            printf("That cell is not available.\n");
+        }
+    }
+
+    Message move = { .type = MSG_MOVE, .game_id = (unsigned)game->game_id, .cell = (unsigned)position };
+    protoEncode(out, &move);
+    return outBufFlush(sock, out);
+}
+
+/**
+ * @brief Reconnects after the host died and asks to RESUME the current game.
+ * @return The new socket, or -1 if no host answered within RECONNECT_TIMEOUT_MS.
+ */
+static int resumeGame(const char *ip, int port, Game *game, char symbol, OutBuf *out) {
+    long long lost_us = monotonicMicros();
+
+    printf("Connection to the host was lost; reconnecting to %s:%d...\n", ip, port);
+    while (monotonicMicros() - lost_us < RECONNECT_TIMEOUT_MS * 1000LL) {
+        int sock = connectToServer(ip, port, 1);
+        if (sock >= 0) {
+            Message hello = { .type = MSG_HELLO, .value = PROTO_VERSION, .role = ROLE_PLAYER };
+            Message resume = { .type = MSG_RESUME, .game_id = (unsigned)game->game_id, .symbol = symbol };
+            out->len = 0;
+            protoEncode(out, &hello);
+            protoEncode(out, &resume);
+            if (outBufFlush(sock, out) == 0) {
+                printf("Reconnected after %.1f ms.\n", (monotonicMicros() - lost_us) / 1000.0);
+                return sock;
+            }
+            close(sock);
+        }
+        struct timespec delay = { 0, RECONNECT_INTERVAL_MS * 1000000L };
+        nanosleep(&delay, NULL);
+    }
+    return -1;
+}
+
+int main(int argc, char *argv[]) {
+    int automatic = 0, standby = 0, watch_game = -1, opt;
+
+    while ((opt = getopt(argc, argv, "asw:")) != -1) {
+        if (opt == 'a') automatic = 1;
+        else if (opt == 's') standby = 1;
+        else if (opt == 'w') watch_game = atoi(optarg);
+    }
+    if (optind >= argc) {
+        printf("Usage: %s [-a] <server_ip> [port] [failover_ip]\n", argv[0]);
+        printf("       %s -s <server_ip> [port]\n", argv[0]);
+        printf("       %s -w <game_id> <server_ip> [port]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *server_ip = argv[optind];
+    int port = (optind + 1 < argc) ? atoi(argv[optind + 1]) : PORT;
+    const char *failover_ip = (optind + 2 < argc) ? argv[optind + 2] : server_ip;
+
+    if (standby) return (runStandby(server_ip, port) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    srand((unsigned)(time(NULL) ^ getpid()));
+    int sock = connectToServer(server_ip, port, 0);
+    if (sock < 0) return EXIT_FAILURE;
+
+    // HELLO and JOIN (or WATCH) leave together in one write.
+    OutBuf out = { 0 };
+    int spectator = (watch_game >= 0);
+    Message hello = { .type = MSG_HELLO, .value = PROTO_VERSION, .role = spectator ? ROLE_SPECTATOR : ROLE_PLAYER };
+    Message join = { .type = MSG_JOIN };
+    Message watch = { .type = MSG_WATCH, .game_id = (unsigned)watch_game };
+    protoEncode(&out, &hello);
+    protoEncode(&out, spectator ? &watch : &join);
+    if (outBufFlush(sock, &out) != 0) {
+        perror("Send failed");
+        return EXIT_FAILURE;
+    }
+
+    static InBuf in;
+    Game game = { .game_id = -1 };
+    char my_symbol = 0;
+    int done = 0;
+
+    while (!done) {
+        int n = inBufFill(sock, &in);
+        if (n <= 0) {
+            close(sock);
+            in.start = in.len = 0;
+            sock = (game.game_id >= 0 && !spectator) ? resumeGame(failover_ip, port, &game, my_symbol, &out) : -1;
+            if (sock < 0) {
+                printf("Connection to the server was lost.\n");
+                break;
+            }
+            continue;
+        }
+
+        Message msg;
+        int my_turn = 0;
+        while (!done && inBufNext(&in, &msg) == 1) {
+            switch (msg.type) {
+                case MSG_HELLO:
+                    break;
+                case MSG_WAIT:
+                    printf("Waiting for an opponent...\n");
+                    break;
+                case MSG_START:
+                    if (msg.value != MAX_SIZE) {
+                        printf("Server uses a %ux%u board; this client supports %dx%d.\n",
+                               msg.value, msg.value, MAX_SIZE, MAX_SIZE);
+                        done = 1;
+                        break;
+                    }
+                    initializeBoard(&game);
+                    game.game_id = (int)msg.game_id;
+                    my_symbol = msg.symbol;
+                    printf("Game %d started. You are '%c'.\n", game.game_id, my_symbol);
+                    displayBoard(&game);
+                    my_turn = (my_symbol == 'X');
+                    break;
+                case MSG_SNAPSHOT:
+                    protoRestore(&msg, &game);
+                    printf("%s game %d at move %d.\n", spectator ? "Watching" : "Resumed",
+                           game.game_id, game.move_count);
+                    displayBoard(&game);
+                    my_turn = ((game.current_turn == 0 ? 'X' : 'O') == my_symbol);
+                    break;
+                case MSG_DELTA:
+                    makeMove(&game, (int)msg.cell, msg.symbol);
+                    displayBoard(&game);
+                    my_turn = (msg.symbol != my_symbol);
+                    break;
+                case MSG_ERROR:
+                    printf("Server rejected the request (error %u).\n", msg.value);
+                    my_turn = (msg.value == ERR_ILLEGAL_MOVE);
+                    if (msg.value == ERR_NO_SUCH_GAME || msg.value == ERR_SEAT_TAKEN) done = 1;
+                    break;
+                case MSG_END:
+                    if (msg.value == RESULT_DRAW) {
+                        printf("Game over: draw.\n");
+                    } else if (msg.value == RESULT_ABANDONED) {
+                        printf("Game over: %s left.\n", spectator ? "a player" : "your opponent");
+                    } else if (spectator) {
+                        printf("Game over: %c wins.\n", (msg.value == RESULT_X_WINS) ? 'X' : 'O');
+                    } else {
+                        char winner = (msg.value == RESULT_X_WINS) ? 'X' : 'O';
+                        printf("Game over: %s\n", (winner == my_symbol) ? "you win!" : "you lose.");
+                    }
+                    done = 1;
+                    break;
+            }
+        }
+        fflush(stdout);
+
+        // A failed send means the host died; the next read notices and resumes.
+        if (!done && my_turn && !spectator && sendMove(sock, &game, &out, automatic) != 0 && feof(stdin)) break;
+    }
+
+    outBufFree(&out);
+    if (sock >= 0) close(sock);
+    return 0;
+}
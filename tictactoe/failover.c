@@ -0,0 +1,125 @@
+/**
+ * @file failover.c
+ * @brief Standby replica that takes over hosting when the active host dies.
+ *
+ * The standby connects to the host with role STANDBY, applies the SNAPSHOT and
+ * REPL stream to a local replica Host and acknowledges each batch. When the
+ * host closes the connection or stays silent for HEARTBEAT_TIMEOUT_MS, the
+ * standby promotes itself: it listens on the host's port and players RESUME
+ * their games from the last acknowledged move.
+ */
+
+#include <poll.h>
+#include "host.h"
+
+static Host replica;               /**< Replicated copy of the host's games */
+static int replica_port;           /**< Port to listen on after promotion */
+static long long last_heartbeat_us; /**< Time anything was last heard from the host */
+
+/**
+ * @brief Reports whether the host has been heard from recently.
+ * @return 1 if the last heartbeat is within HEARTBEAT_TIMEOUT_MS, 0 otherwise.
+ */
+int isServerRunning() {
+    return last_heartbeat_us != 0 &&
+           monotonicMicros() - last_heartbeat_us < HEARTBEAT_TIMEOUT_MS * 1000LL;
+}
+
+/**
+ * @brief Turns the replica into the active host and serves games until exit.
+ */
+void promoteNewHost() {
+    long long detected_us = monotonicMicros();
+
+    hostPromote(&replica);
+    if (hostListen(&replica, replica_port) != 0) {
+        printf("Promotion failed: unable to listen on port %d.\n", replica_port);
+        exit(EXIT_FAILURE);
+    }
+    printf("Failover: last heard from host %.1f ms before detection; serving on port %d %.2f ms after detection.\n",
+           (detected_us - last_heartbeat_us) / 1000.0, replica_port,
+           (monotonicMicros() - detected_us) / 1000.0);
+    fflush(stdout);
+
+    int status = hostRun(&replica);
+    hostDestroy(&replica);
+    exit(status == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/**
+ * @brief Replicates the host at host_ip:port and takes over when it dies.
+ * @param host_ip Address of the active host.
+ * @param port Port of the active host (reused after promotion).
+ * @return -1 if the host could not be reached; otherwise does not return.
+ */
+int runStandby(const char *host_ip, int port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+    if (sock < 0 || inet_pton(AF_INET, host_ip, &addr.sin_addr) <= 0 ||
+        connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("Standby connection failed");
+        if (sock >= 0) close(sock);
+        return -1;
+    }
+
+    OutBuf out = { 0 };
+    Message hello = { .type = MSG_HELLO, .value = PROTO_VERSION, .role = ROLE_STANDBY };
+    protoEncode(&out, &hello);
+    if (outBufFlush(sock, &out) != 0) {
+        close(sock);
+        return -1;
+    }
+
+    hostInit(&replica);
+    replica_port = port;
+    last_heartbeat_us = monotonicMicros();
+    printf("Standby replicating host %s:%d\n", host_ip, port);
+
+    static InBuf in;
+    long long applied_total = 0;
+    while (1) {
+        struct pollfd pfd = { .fd = sock, .events = POLLIN };
+        if (poll(&pfd, 1, HEARTBEAT_INTERVAL_MS) > 0) {
+            if (inBufFill(sock, &in) <= 0) {
+                printf("Connection to host lost.\n");
+                break;
+            }
+            last_heartbeat_us = monotonicMicros();
+
+            Message msg;
+            int applied = 0;
+            while (inBufNext(&in, &msg) == 1) {
+                if (msg.type == MSG_SNAPSHOT || msg.type == MSG_REPL) {
+                    if (hostApplyReplication(&replica, &msg) != 0) {
+                        printf("Replica diverged from host at seq %u.\n", msg.seq);
+                    }
+                    applied++;
+                } else if (msg.type == MSG_HEARTBEAT) {
+                    replica.repl_seq = msg.seq;
+                } else if (msg.type == MSG_ERROR) {
+                    printf("Host refused the standby (error %u).\n", msg.value);
+                    close(sock);
+                    return -1;
+                }
+            }
+
+            // One ACK covers every entry applied from this read.
+            if (applied) {
+                Message ack = { .type = MSG_ACK, .seq = replica.repl_seq };
+                protoEncode(&out, &ack);
+                if (outBufFlush(sock, &out) != 0) break;
+                applied_total += applied;
+            }
+        }
+        if (!isServerRunning()) {
+            printf("No heartbeat for %d ms.\n", HEARTBEAT_TIMEOUT_MS);
+            break;
+        }
+    }
+
+    printf("Replica applied %lld messages up to seq %u.\n", applied_total, replica.repl_seq);
+    outBufFree(&out);
+    close(sock);
+    promoteNewHost();
+    return 0;
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+# Demonstrates host failover on one machine:
+#   1. start a host and a standby replica,
+#   2. start two automatic players,
+#   3. kill -9 the host mid-game,
+#   4. the standby takes over the port and both players resume the game.
+
+PORT=${1:-9090}
+
+./server "$PORT" > failover_host.log &
+HOST_PID=$!
+sleep 0.3
+./client -s 127.0.0.1 "$PORT" > failover_standby.log &
+STANDBY_PID=$!
+sleep 0.3
+
+./client -a 127.0.0.1 "$PORT" > failover_player1.log &
+P1=$!
+./client -a 127.0.0.1 "$PORT" > failover_player2.log &
+P2=$!
+
+sleep 0.7
+echo "Killing host (PID $HOST_PID)..."
+kill -9 "$HOST_PID"
+
+wait "$P1" "$P2"
+sleep 0.2
+kill "$STANDBY_PID" 2>/dev/null
+
+echo "--- standby ---";  cat failover_standby.log
+echo "--- player 1 ---"; grep -E "Reconnected|Resumed|Game over" failover_player1.log
+echo "--- player 2 ---"; grep -E "Reconnected|Resumed|Game over" failover_player2.log
@@ -0,0 +1,1048 @@
+/**
+ * @file host.c
+ * @brief Single-threaded poll() event loop that hosts Tic-Tac-Toe games.
+ *
+ * Each loop iteration reads every ready socket, applies the decoded messages,
+ * and then flushes each connection that received output exactly once. All
+ * messages produced for one player while handling a batch of input (for
+ * example a DELTA followed by an END) therefore leave in a single send().
+ * Connections that also have shared buffers queued (spectators) are flushed
+ * with a single writev() over the queue instead.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "host.h"
+
+/**
+ * @brief Grows an array to hold at least need elements.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int growArray(void **array, int *cap, int need, size_t elem_size) {
+    if (need <= *cap) return 0;
+
+    int new_cap = *cap ? *cap : 16;
+    while (new_cap < need) new_cap *= 2;
+    void *grown = realloc(*array, (size_t)new_cap * elem_size);
+    if (!grown) return -1;
+    memset((char *)grown + (size_t)*cap * elem_size, 0, (size_t)(new_cap - *cap) * elem_size);
+    *array = grown;
+    *cap = new_cap;
+    return 0;
+}
+
+/**
+ * @brief Puts a socket into non-blocking mode.
+ */
+static int setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return (flags < 0) ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+/**
+ * @brief Puts a connection on the flush list (once).
+ */
+static void markDirty(Host *host, Conn *conn) {
+    if (conn->dirty) return;
+    if (growArray((void **)&host->dirty, &host->dirty_cap, host->num_dirty + 1, sizeof(int)) != 0) return;
+    conn->dirty = 1;
+    host->dirty[host->num_dirty++] = conn->player.socket;
+}
+
+/**
+ * @brief Encodes a message into a connection's output buffer and schedules a flush.
+ */
+static void queueMsg(Host *host, Conn *conn, const Message *msg) {
+    int bytes = protoEncode(&conn->out, msg);
+    if (conn->role == ROLE_STANDBY && bytes > 0) host->stats.bytes += bytes;
+    markDirty(host, conn);
+}
+
+/* ================== SEND QUEUE ================== */
+
+/**
+ * @brief Appends a reference to a shared buffer to a connection's send queue.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int queuePush(Conn *conn, SharedBuf *buf) {
+    if (conn->q_len == conn->q_cap) {
+        int new_cap = conn->q_cap ? conn->q_cap * 2 : 8;
+        QueuedBuf *grown = malloc((size_t)new_cap * sizeof(QueuedBuf));
+        if (!grown) return -1;
+        for (int i = 0; i < conn->q_len; i++) {
+            grown[i] = conn->queue[(conn->q_head + i) % conn->q_cap];
+        }
+        free(conn->queue);
+        conn->queue = grown;
+        conn->q_head = 0;
+        conn->q_cap = new_cap;
+    }
+
+    conn->queue[(conn->q_head + conn->q_len) % conn->q_cap] = (QueuedBuf){ sharedBufRetain(buf), 0 };
+    conn->q_len++;
+    conn->q_bytes += buf->len;
+    return 0;
+}
+
+/**
+ * @brief Moves pending private messages onto the send queue so ordering is kept.
+ */
+static void sealPrivate(Conn *conn) {
+    if (conn->out.len == 0) return;
+
+    SharedBuf *buf = sharedBufCreate(&conn->out);
+    if (!buf) return;
+    if (queuePush(conn, buf) == 0) conn->out.len = 0;
+    sharedBufRelease(buf);
+}
+
+/**
+ * @brief Queues a shared buffer on a connection without copying it.
+ */
+static void queueShared(Host *host, Conn *conn, SharedBuf *buf) {
+    sealPrivate(conn);
+    if (queuePush(conn, buf) == 0) markDirty(host, conn);
+}
+
+/**
+ * @brief Releases queued buffers that have not started to go out.
+ * - A partially written head entry is kept so the byte stream stays framed.
+ */
+static void queueDropUnsent(Conn *conn) {
+    int keep = (conn->q_len > 0 && conn->queue[conn->q_head].off > 0) ? 1 : 0;
+
+    for (int i = keep; i < conn->q_len; i++) {
+        QueuedBuf *entry = &conn->queue[(conn->q_head + i) % conn->q_cap];
+        conn->q_bytes -= entry->buf->len;
+        sharedBufRelease(entry->buf);
+    }
+    conn->q_len = keep;
+    conn->out.len = 0;
+}
+
+/**
+ * @brief Releases every queued buffer of a connection.
+ */
+static void queueFree(Conn *conn) {
+    for (int i = 0; i < conn->q_len; i++) {
+        sharedBufRelease(conn->queue[(conn->q_head + i) % conn->q_cap].buf);
+    }
+    free(conn->queue);
+    conn->queue = NULL;
+    conn->q_len = conn->q_cap = 0;
+    conn->q_bytes = 0;
+}
+
+/**
+ * @brief Writes a connection's pending output.
+ * - Without queued shared buffers this is one send() of the private buffer.
+ * - Otherwise the queue (private bytes sealed at its tail) goes out with writev().
+ *
+ * @return 0 on success or a would-block, -1 if the socket failed.
+ */
+static int flushConn(Conn *conn) {
+    int fd = conn->player.socket;
+
+    if (conn->q_len == 0) return outBufFlush(fd, &conn->out);
+
+    sealPrivate(conn);
+    while (conn->q_len > 0) {
+        struct iovec iov[SEND_BATCH];
+        int count = (conn->q_len < SEND_BATCH) ? conn->q_len : SEND_BATCH;
+        for (int i = 0; i < count; i++) {
+            QueuedBuf *entry = &conn->queue[(conn->q_head + i) % conn->q_cap];
+            iov[i].iov_base = entry->buf->data + entry->off;
+            iov[i].iov_len = entry->buf->len - entry->off;
+        }
+
+        ssize_t sent = writev(fd, iov, count);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!conn->stalled_us) conn->stalled_us = monotonicMicros();
+                return 0;
+            }
+            return -1;
+        }
+        conn->stalled_us = 0;
+
+        // Retire fully written entries; the last one may be partial.
+        size_t left = (size_t)sent;
+        while (left > 0) {
+            QueuedBuf *entry = &conn->queue[conn->q_head];
+            size_t remaining = entry->buf->len - entry->off;
+            if (left < remaining) {
+                entry->off += left;
+                conn->q_bytes -= left;
+                break;
+            }
+            left -= remaining;
+            conn->q_bytes -= remaining;
+            sharedBufRelease(entry->buf);
+            conn->q_head = (conn->q_head + 1) % conn->q_cap;
+            conn->q_len--;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Reports whether a connection still has bytes waiting to be written.
+ */
+static int hasPendingOutput(const Conn *conn) {
+    return conn->out.len > 0 || conn->q_len > 0;
+}
+
+/* ================== REPLICATION ================== */
+
+/**
+ * @brief Streams one move-log entry to the standby, if one is attached.
+ */
+static void replicate(Host *host, int op, int game_id, unsigned cell) {
+    if (host->standby_fd < 0) return;
+
+    // Keep a send timestamp for every unacknowledged entry to measure ack latency.
+    unsigned outstanding = host->repl_seq + 1 - host->repl_acked;
+    if (outstanding > (unsigned)host->sent_cap) {
+        int new_cap = host->sent_cap ? host->sent_cap * 2 : 64;
+        long long *grown = malloc((size_t)new_cap * sizeof(long long));
+        if (!grown) return;
+        for (unsigned s = host->repl_acked + 1; s != host->repl_seq + 1; s++) {
+            grown[s & (unsigned)(new_cap - 1)] = host->sent_us[s & (unsigned)(host->sent_cap - 1)];
+        }
+        free(host->sent_us);
+        host->sent_us = grown;
+        host->sent_cap = new_cap;
+    }
+
+    Message entry = { .type = MSG_REPL, .seq = ++host->repl_seq, .value = (unsigned)op,
+                      .game_id = (unsigned)game_id, .cell = cell };
+    host->sent_us[entry.seq & (unsigned)(host->sent_cap - 1)] = monotonicMicros();
+    host->stats.entries++;
+    queueMsg(host, host->conns[host->standby_fd], &entry);
+}
+
+/**
+ * @brief Queues a message for a player, holding it while a log entry is unacknowledged.
+ * - Once a connection has held messages, later ones are held too so order is kept.
+ */
+static void sendToPlayer(Host *host, int fd, const Message *msg) {
+    Conn *conn = (fd >= 0) ? host->conns[fd] : NULL;
+    if (!conn) return;
+
+    if (host->standby_fd < 0 || (host->repl_acked == host->repl_seq && conn->held == 0)) {
+        queueMsg(host, conn, msg);
+        return;
+    }
+
+    if (host->held_len == host->held_cap) {
+        int new_cap = host->held_cap ? host->held_cap * 2 : 64;
+        HeldMsg *grown = malloc((size_t)new_cap * sizeof(HeldMsg));
+        if (!grown) return;
+        for (int i = 0; i < host->held_len; i++) {
+            grown[i] = host->held[(host->held_head + i) % host->held_cap];
+        }
+        free(host->held);
+        host->held = grown;
+        host->held_head = 0;
+        host->held_cap = new_cap;
+    }
+
+    HeldMsg *slot = &host->held[(host->held_head + host->held_len) % host->held_cap];
+    slot->seq = host->repl_seq;
+    slot->fd = fd;
+    slot->player_id = conn->player.id;
+    slot->msg = *msg;
+    host->held_len++;
+    conn->held++;
+}
+
+/**
+ * @brief Releases held messages whose log entry is acknowledged (or all of them).
+ */
+static void releaseHeld(Host *host, int all) {
+    while (host->held_len > 0) {
+        HeldMsg *slot = &host->held[host->held_head];
+        if (!all && (int)(slot->seq - host->repl_acked) > 0) break;
+
+        Conn *conn = host->conns[slot->fd];
+        if (conn && conn->player.id == slot->player_id) {
+            conn->held--;
+            queueMsg(host, conn, &slot->msg);
+        }
+        host->held_head = (host->held_head + 1) % host->held_cap;
+        host->held_len--;
+    }
+}
+
+/**
+ * @brief Records an ACK from the standby and releases the messages it unblocks.
+ */
+static void handleAck(Host *host, unsigned seq) {
+    // Ignore acks for entries that were never sent or are already acknowledged.
+    if ((int)(seq - host->repl_seq) > 0 || (int)(seq - host->repl_acked) <= 0) return;
+
+    long long now = monotonicMicros();
+    for (unsigned s = host->repl_acked + 1; s != seq + 1; s++) {
+        long long latency = now - host->sent_us[s & (unsigned)(host->sent_cap - 1)];
+        host->stats.ack_us_total += latency;
+        if (latency > host->stats.ack_us_max) host->stats.ack_us_max = latency;
+        host->stats.acks++;
+    }
+    host->repl_acked = seq;
+    releaseHeld(host, 0);
+}
+
+/**
+ * @brief Prints the replication overhead counters.
+ */
+static void reportReplication(Host *host) {
+    ReplStats *st = &host->stats;
+    long long streamed = st->entries + st->snapshots;
+
+    printf("Replication: %lld log entries + %lld snapshots, %lld bytes (%.1f B/message), "
+           "ack latency avg %.1f us max %lld us\n",
+           st->entries, st->snapshots, st->bytes, streamed ? (double)st->bytes / streamed : 0.0,
+           st->acks ? (double)st->ack_us_total / st->acks : 0.0, st->ack_us_max);
+    fflush(stdout);
+    st->last_report_us = monotonicMicros();
+}
+
+/**
+ * @brief Makes a connection the standby and sends it a snapshot of every active game.
+ * @return 0 on success, -1 if a standby is already attached.
+ */
+static int attachStandby(Host *host, Conn *conn) {
+    if (host->standby_fd >= 0) return -1;
+
+    conn->role = ROLE_STANDBY;
+    host->standby_fd = conn->player.socket;
+    host->repl_acked = host->repl_seq;
+    memset(&host->stats, 0, sizeof(host->stats));
+
+    Message hello = { .type = MSG_HELLO, .value = PROTO_VERSION, .role = ROLE_STANDBY };
+    queueMsg(host, conn, &hello);
+    for (int id = 0; id < poolCapacity(&host->games); id++) {
+        if (!poolIsLive(&host->games, id)) continue;
+        Message snapshot;
+        protoSnapshot(poolGet(&host->games, id), &snapshot);
+        queueMsg(host, conn, &snapshot);
+        host->stats.snapshots++;
+    }
+    Message heartbeat = { .type = MSG_HEARTBEAT, .seq = host->repl_seq };
+    queueMsg(host, conn, &heartbeat);
+    host->last_heartbeat_us = host->stats.last_report_us = monotonicMicros();
+
+    printf("Standby attached; streamed %lld game snapshots.\n", host->stats.snapshots);
+    return 0;
+}
+
+/**
+ * @brief Stops replicating and releases everything that was waiting for the standby.
+ */
+static void detachStandby(Host *host) {
+    host->standby_fd = -1;
+    releaseHeld(host, 1);
+    printf("Standby detached.\n");
+    reportReplication(host);
+}
+
+/* ================== GAMES ================== */
+
+/**
+ * @brief Looks up an active game by id.
+ * @return The game, or NULL if the id is unknown or the game is over.
+ */
+static Game *findGame(Host *host, unsigned game_id) {
+    if (game_id >= (unsigned)poolCapacity(&host->games) || !poolIsLive(&host->games, (int)game_id)) return NULL;
+    Game *game = poolGet(&host->games, (int)game_id);
+    return game->active ? game : NULL;
+}
+
+/**
+ * @brief Sets up a freshly allocated game slot and the watcher list for its id.
+ * @return The game, or NULL on allocation failure (the slot is released).
+ */
+static Game *gameSlot(Host *host, int id) {
+    if (growArray((void **)&host->watchers, &host->watcher_cap, poolCapacity(&host->games), sizeof(Watchers)) != 0) {
+        poolFree(&host->games, NULL, id);
+        return NULL;
+    }
+    Game *game = poolGet(&host->games, id);
+    game->game_id = id;
+    return game;
+}
+
+/**
+ * @brief Returns the game with a given id on a replica, allocating that exact id if needed.
+ * @return The game, or NULL if the id cannot be allocated.
+ */
+static Game *claimGame(Host *host, int id) {
+    if (poolIsLive(&host->games, id)) return poolGet(&host->games, id);
+    return (poolClaim(&host->games, id) == 0) ? gameSlot(host, id) : NULL;
+}
+
+/* ================== SPECTATORS ================== */
+
+/**
+ * @brief Returns a shared SNAPSHOT of a game's current state, encoding it at most once per move.
+ */
+static SharedBuf *sharedSnapshot(Host *host, Game *game) {
+    Watchers *w = &host->watchers[game->game_id];
+    if (w->snapshot && w->snapshot_moves == game->move_count) return w->snapshot;
+
+    OutBuf scratch = { 0 };
+    Message snapshot;
+    protoSnapshot(game, &snapshot);
+    protoEncode(&scratch, &snapshot);
+    sharedBufRelease(w->snapshot);
+    w->snapshot = sharedBufCreate(&scratch);
+    w->snapshot_moves = game->move_count;
+    outBufFree(&scratch);
+    return w->snapshot;
+}
+
+/**
+ * @brief Removes a spectator from the watcher list of its game.
+ */
+static void unwatch(Host *host, Conn *conn) {
+    if (conn->watching < 0) return;
+
+    Watchers *w = &host->watchers[conn->watching];
+    int last_fd = w->fds[--w->count];
+    if (conn->watch_index != w->count) {
+        w->fds[conn->watch_index] = last_fd;
+        host->conns[last_fd]->watch_index = conn->watch_index;
+    }
+    conn->watching = -1;
+}
+
+/**
+ * @brief Encodes one update once and queues it by reference on every spectator of a game.
+ * - A spectator already holding SPECTATOR_QUEUE_LIMIT unsent updates drops its backlog
+ *   and receives a snapshot of the latest state instead of this update. The
+ *   limit counts queue entries, not bytes: a whole game is a few hundred bytes,
+ *   so a byte limit a single game reaches would hold almost no backlog.
+ */
+static void fanOut(Host *host, Game *game, const Message *msg) {
+    Watchers *w = &host->watchers[game->game_id];
+    if (w->count == 0) return;
+
+    OutBuf scratch = { 0 };
+    protoEncode(&scratch, msg);
+    SharedBuf *update = sharedBufCreate(&scratch);
+    outBufFree(&scratch);
+    if (!update) return;
+    host->fanout.updates++;
+
+    for (int i = 0; i < w->count; i++) {
+        Conn *conn = host->conns[w->fds[i]];
+        if (conn->q_len >= SPECTATOR_QUEUE_LIMIT) {
+            // The snapshot already contains this move; only END still has to follow it.
+            queueDropUnsent(conn);
+            queueShared(host, conn, sharedSnapshot(host, game));
+            host->fanout.skipped++;
+            if (msg->type != MSG_END) continue;
+        }
+        queueShared(host, conn, update);
+        host->fanout.deliveries++;
+        host->fanout.window_deliveries++;
+    }
+    sharedBufRelease(update);
+}
+
+/**
+ * @brief Starts streaming a game to a spectator with a snapshot of its current state.
+ */
+static void handleWatch(Host *host, Conn *conn, const Message *msg) {
+    Game *game = findGame(host, msg->game_id);
+    if (!game) {
+        Message err = { .type = MSG_ERROR, .game_id = msg->game_id, .value = ERR_NO_SUCH_GAME };
+        queueMsg(host, conn, &err);
+        return;
+    }
+
+    unwatch(host, conn);
+    Watchers *w = &host->watchers[game->game_id];
+    if (growArray((void **)&w->fds, &w->cap, w->count + 1, sizeof(int)) != 0) return;
+    conn->watching = game->game_id;
+    conn->watch_index = w->count;
+    w->fds[w->count++] = conn->player.socket;
+
+    queueShared(host, conn, sharedSnapshot(host, game));
+}
+
+/**
+ * @brief Prints spectator fan-out throughput for the current window and starts a new one.
+ */
+static void reportFanout(Host *host, long long now) {
+    FanoutStats *st = &host->fanout;
+    double seconds = (now - st->window_start_us) / 1e6;
+
+    if (st->window_deliveries > 0 && seconds > 0) {
+        printf("Fan-out: %.0f updates x spectators/sec (%d spectators; totals: %lld updates, "
+               "%lld deliveries, %lld skipped to snapshot, %lld dropped)\n",
+               st->window_deliveries / seconds, host->num_spectators, st->updates,
+               st->deliveries, st->skipped, st->dropped);
+        fflush(stdout);
+    }
+    st->window_deliveries = 0;
+    st->window_start_us = now;
+}
+
+/* ================== PLAY ================== */
+
+/**
+ * @brief Marks a game as finished, tells both players the result and frees the id.
+ */
+static void endGame(Host *host, Game *game, int result) {
+    Message end = { .type = MSG_END, .game_id = (unsigned)game->game_id, .value = (unsigned)result };
+    int sockets[2] = { game->player_x_socket, game->player_o_socket };
+
+    replicate(host, REPL_END, game->game_id, (unsigned)result);
+    for (int i = 0; i < 2; i++) {
+        Conn *conn = (sockets[i] >= 0) ? host->conns[sockets[i]] : NULL;
+        if (!conn) continue;
+        sendToPlayer(host, sockets[i], &end);
+        conn->game_id = -1;
+        conn->player.active = 1;
+    }
+
+    // Spectators see the result, then stop watching.
+    Watchers *w = &host->watchers[game->game_id];
+    fanOut(host, game, &end);
+    while (w->count > 0) unwatch(host, host->conns[w->fds[w->count - 1]]);
+    sharedBufRelease(w->snapshot);
+    w->snapshot = NULL;
+
+    game->active = 0;
+    poolFree(&host->games, NULL, game->game_id);
+}
+
+/**
+ * @brief Allocates a game id, reusing finished games before growing the table.
+ * @return The new game, or NULL on allocation failure.
+ */
+static Game *newGame(Host *host) {
+    int id = poolAlloc(&host->games, NULL);
+    Game *game = (id != POOL_NO_HANDLE) ? gameSlot(host, id) : NULL;
+    if (!game) return NULL;
+
+    initializeBoard(game);
+    replicate(host, REPL_START, id, 0);
+    return game;
+}
+
+/**
+ * @brief Pairs waiting players, oldest first, into new games.
+ */
+static void matchmake(Host *host) {
+    while (host->wait_len >= 2) {
+        int pair[2];
+        int found = 0;
+
+        // Pop entries until two live, still-waiting players are found.
+        while (found < 2 && host->wait_len > 0) {
+            int fd = host->wait_queue[host->wait_head];
+            host->wait_head = (host->wait_head + 1) % host->wait_cap;
+            host->wait_len--;
+            Conn *conn = host->conns[fd];
+            // A reused fd can leave a stale duplicate entry behind; never pair a player with itself.
+            if (conn && conn->waiting && !(found == 1 && pair[0] == fd)) pair[found++] = fd;
+        }
+        if (found < 2) {
+            // Put the lone survivor back at the front of the queue.
+            if (found == 1) {
+                host->wait_head = (host->wait_head + host->wait_cap - 1) % host->wait_cap;
+                host->wait_queue[host->wait_head] = pair[0];
+                host->wait_len++;
+            }
+            return;
+        }
+
+        Game *game = newGame(host);
+        if (!game) return;
+        game->player_x_socket = pair[0];
+        game->player_o_socket = pair[1];
+
+        for (int i = 0; i < 2; i++) {
+            Conn *conn = host->conns[pair[i]];
+            Message start = { .type = MSG_START, .game_id = (unsigned)game->game_id,
+                              .symbol = (i == 0) ? 'X' : 'O', .value = MAX_SIZE };
+            conn->waiting = 0;
+            conn->player.active = 0;
+            conn->game_id = game->game_id;
+            sendToPlayer(host, pair[i], &start);
+        }
+        printf("Game %d started: Player %d (X) vs Player %d (O)\n", game->game_id,
+               host->conns[pair[0]]->player.id, host->conns[pair[1]]->player.id);
+    }
+}
+
+/**
+ * @brief Adds a connection to the matchmaking queue.
+ */
+static void enqueuePlayer(Host *host, Conn *conn) {
+    if (host->wait_len == host->wait_cap) {
+        // Unroll the ring into a larger buffer.
+        int new_cap = host->wait_cap ? host->wait_cap * 2 : 16;
+        int *grown = malloc((size_t)new_cap * sizeof(int));
+        if (!grown) return;
+        for (int i = 0; i < host->wait_len; i++) {
+            grown[i] = host->wait_queue[(host->wait_head + i) % host->wait_cap];
+        }
+        free(host->wait_queue);
+        host->wait_queue = grown;
+        host->wait_head = 0;
+        host->wait_cap = new_cap;
+    }
+
+    host->wait_queue[(host->wait_head + host->wait_len) % host->wait_cap] = conn->player.socket;
+    host->wait_len++;
+    conn->waiting = 1;
+
+    Message wait = { .type = MSG_WAIT };
+    sendToPlayer(host, conn->player.socket, &wait);
+    matchmake(host);
+}
+
+/**
+ * @brief Validates and applies a MOVE, then sends the resulting DELTA (and END) to both players.
+ */
+static void handleMove(Host *host, Conn *conn, const Message *msg) {
+    Game *game = findGame(host, msg->game_id);
+    int fd = conn->player.socket;
+    Message reply = { .type = MSG_ERROR, .game_id = msg->game_id };
+
+    if (!game || (game->player_x_socket != fd && game->player_o_socket != fd)) {
+        reply.value = ERR_NO_SUCH_GAME;
+        sendToPlayer(host, fd, &reply);
+        return;
+    }
+
+    char symbol = (game->player_x_socket == fd) ? 'X' : 'O';
+    if (symbol != (game->current_turn == 0 ? 'X' : 'O')) {
+        reply.value = ERR_NOT_YOUR_TURN;
+        sendToPlayer(host, fd, &reply);
+        return;
+    }
+    if (!makeMove(game, (int)msg->cell, symbol)) {
+        reply.value = ERR_ILLEGAL_MOVE;
+        sendToPlayer(host, fd, &reply);
+        return;
+    }
+    replicate(host, REPL_MOVE, game->game_id, msg->cell);
+
+    // After a failover the opponent may not have reattached yet; it gets a SNAPSHOT on RESUME.
+    Message delta = { .type = MSG_DELTA, .game_id = msg->game_id, .cell = msg->cell, .symbol = symbol };
+    sendToPlayer(host, game->player_x_socket, &delta);
+    sendToPlayer(host, game->player_o_socket, &delta);
+    fanOut(host, game, &delta);
+
+    if (checkWin(game, symbol)) {
+        endGame(host, game, symbol == 'X' ? RESULT_X_WINS : RESULT_O_WINS);
+    } else if (isBoardFull(game)) {
+        endGame(host, game, RESULT_DRAW);
+    }
+}
+
+/**
+ * @brief Reattaches a player to its seat after a failover and sends the current board.
+ */
+static void handleResume(Host *host, Conn *conn, const Message *msg) {
+    Game *game = findGame(host, msg->game_id);
+    int fd = conn->player.socket;
+    Message reply = { .type = MSG_ERROR, .game_id = msg->game_id };
+
+    if (!game) {
+        reply.value = ERR_NO_SUCH_GAME;
+        sendToPlayer(host, fd, &reply);
+        return;
+    }
+    int *seat = (msg->symbol == 'X') ? &game->player_x_socket : &game->player_o_socket;
+    if (*seat >= 0 || conn->game_id >= 0 || conn->waiting) {
+        reply.value = ERR_SEAT_TAKEN;
+        sendToPlayer(host, fd, &reply);
+        return;
+    }
+
+    *seat = fd;
+    conn->game_id = game->game_id;
+    conn->player.active = 0;
+
+    Message snapshot;
+    protoSnapshot(game, &snapshot);
+    sendToPlayer(host, fd, &snapshot);
+
+    if (host->promoted_us) {
+        printf("Game %d: player '%c' resumed %.1f ms after promotion (move %d)\n", game->game_id,
+               msg->symbol, (monotonicMicros() - host->promoted_us) / 1000.0, game->move_count);
+        fflush(stdout);
+    }
+}
+
+/**
+ * @brief Dispatches one decoded message from a connection.
+ * @return 0 to keep the connection, -1 to drop it.
+ */
+static int handleMessage(Host *host, Conn *conn, const Message *msg) {
+    if (!conn->greeted) {
+        if (msg->type != MSG_HELLO || msg->value != PROTO_VERSION) {
+            Message err = { .type = MSG_ERROR, .value = ERR_BAD_VERSION };
+            queueMsg(host, conn, &err);
+            outBufFlush(conn->player.socket, &conn->out);
+            return -1;
+        }
+        conn->greeted = 1;
+        if (msg->role == ROLE_STANDBY) return attachStandby(host, conn);
+        if (msg->role == ROLE_SPECTATOR) {
+            conn->role = ROLE_SPECTATOR;
+            // A fixed kernel buffer keeps the backlog in the queue, where SPECTATOR_QUEUE_LIMIT sees it.
+            int sndbuf = SPECTATOR_SNDBUF;
+            setsockopt(conn->player.socket, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+            if (host->num_spectators++ == 0) host->fanout.window_start_us = monotonicMicros();
+        }
+
+        Message hello = { .type = MSG_HELLO, .value = PROTO_VERSION, .role = conn->role };
+        queueMsg(host, conn, &hello);
+        return 0;
+    }
+
+    if (conn->role == ROLE_SPECTATOR) {
+        if (msg->type == MSG_WATCH) {
+            handleWatch(host, conn, msg);
+        } else {
+            Message err = { .type = MSG_ERROR, .value = ERR_BAD_MESSAGE };
+            queueMsg(host, conn, &err);
+        }
+        return 0;
+    }
+
+    switch (msg->type) {
+        case MSG_JOIN:
+            if (conn->game_id < 0 && !conn->waiting) enqueuePlayer(host, conn);
+            return 0;
+        case MSG_MOVE:
+            handleMove(host, conn, msg);
+            return 0;
+        case MSG_RESUME:
+            handleResume(host, conn, msg);
+            return 0;
+        case MSG_ACK:
+            if (conn->role == ROLE_STANDBY) handleAck(host, msg->seq);
+            return 0;
+        default: {
+            Message err = { .type = MSG_ERROR, .value = ERR_BAD_MESSAGE };
+            sendToPlayer(host, conn->player.socket, &err);
+            return 0;
+        }
+    }
+}
+
+/* ================== CONNECTIONS ================== */
+
+/**
+ * @brief Registers a freshly accepted socket.
+ */
+static void addConn(Host *host, int fd) {
+    int handle = poolAlloc(&host->players, NULL);
+    if (handle == POOL_NO_HANDLE || setNonBlocking(fd) != 0 ||
+        growArray((void **)&host->conns, &host->conn_cap, fd + 1, sizeof(Conn *)) != 0 ||
+        growArray((void **)&host->pfds, &host->pfd_cap, host->num_pfds + 1, sizeof(struct pollfd)) != 0) {
+        if (handle != POOL_NO_HANDLE) poolFree(&host->players, NULL, handle);
+        close(fd);
+        return;
+    }
+    Conn *conn = poolGet(&host->players, handle);
+    conn->handle = handle;
+
+    // Messages are coalesced by the host, so Nagle would only add latency.
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    conn->player.socket = fd;
+    conn->player.id = ++host->next_player_id;
+    conn->player.active = 1;
+    conn->role = ROLE_PLAYER;
+    conn->game_id = -1;
+    conn->watching = -1;
+    conn->pfd_index = host->num_pfds;
+    host->conns[fd] = conn;
+    host->pfds[host->num_pfds++] = (struct pollfd){ .fd = fd, .events = POLLIN };
+}
+
+/**
+ * @brief Closes a connection and forfeits any game it was playing.
+ */
+static void removeConn(Host *host, int fd) {
+    Conn *conn = host->conns[fd];
+    if (!conn) return;
+
+    if (fd == host->standby_fd) detachStandby(host);
+    if (conn->role == ROLE_SPECTATOR) {
+        unwatch(host, conn);
+        host->num_spectators--;
+    }
+
+    Game *game = (conn->game_id >= 0) ? findGame(host, (unsigned)conn->game_id) : NULL;
+    if (game) {
+        if (game->player_x_socket == fd) game->player_x_socket = -1;
+        if (game->player_o_socket == fd) game->player_o_socket = -1;
+        printf("Game %d abandoned by Player %d\n", game->game_id, conn->player.id);
+        endGame(host, game, RESULT_ABANDONED);
+    }
+
+    // Swap the last pollfd into the freed slot.
+    int last = --host->num_pfds;
+    if (conn->pfd_index != last) {
+        host->pfds[conn->pfd_index] = host->pfds[last];
+        host->conns[host->pfds[last].fd]->pfd_index = conn->pfd_index;
+    }
+
+    host->conns[fd] = NULL;
+    outBufFree(&conn->out);
+    queueFree(conn);
+    poolFree(&host->players, NULL, conn->handle);
+    close(fd);
+}
+
+/**
+ * @brief Writes every connection's pending output with one send() each.
+ */
+static void flushDirty(Host *host) {
+    // removeConn can queue END messages for opponents, which extends the list.
+    for (int i = 0; i < host->num_dirty; i++) {
+        int fd = host->dirty[i];
+        Conn *conn = host->conns[fd];
+        if (!conn || !conn->dirty) continue;
+
+        conn->dirty = 0;
+        if (flushConn(conn) != 0) {
+            removeConn(host, fd);
+            continue;
+        }
+        if (conn->stalled_us && monotonicMicros() - conn->stalled_us >= SPECTATOR_STALL_MS * 1000LL &&
+            conn->role == ROLE_SPECTATOR) {
+            host->fanout.dropped++;
+            removeConn(host, fd);
+            continue;
+        }
+        // Ask poll() to report writability only while output is backed up.
+        host->pfds[conn->pfd_index].events = hasPendingOutput(conn) ? (POLLIN | POLLOUT) : POLLIN;
+    }
+    host->num_dirty = 0;
+}
+
+/**
+ * @brief Accepts every pending connection on the listening socket.
+ */
+static void acceptAll(Host *host) {
+    while (1) {
+        int fd = accept(host->listen_socket, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) perror("Client accept failed");
+            return;
+        }
+        addConn(host, fd);
+    }
+}
+
+/**
+ * @brief Reads from one connection and handles every complete message.
+ */
+static void serviceConn(Host *host, int fd, short revents) {
+    Conn *conn = host->conns[fd];
+
+    if (revents & POLLOUT) markDirty(host, conn);
+    if (!(revents & (POLLIN | POLLHUP | POLLERR))) return;
+
+    int n = inBufFill(fd, &conn->in);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        removeConn(host, fd);
+        return;
+    }
+
+    Message msg;
+    int status;
+    while ((status = inBufNext(&conn->in, &msg)) == 1) {
+        if (handleMessage(host, conn, &msg) != 0) {
+            removeConn(host, fd);
+            return;
+        }
+    }
+    if (status < 0) removeConn(host, fd);
+}
+
+/**
+ * @brief Runs timer-driven work: heartbeats, replication reports and the resume deadline.
+ */
+static void hostTick(Host *host) {
+    long long now = monotonicMicros();
+
+    if (host->standby_fd >= 0) {
+        if (now - host->last_heartbeat_us >= HEARTBEAT_INTERVAL_MS * 1000LL) {
+            Message heartbeat = { .type = MSG_HEARTBEAT, .seq = host->repl_seq };
+            queueMsg(host, host->conns[host->standby_fd], &heartbeat);
+            host->last_heartbeat_us = now;
+        }
+        if (now - host->stats.last_report_us >= REPL_REPORT_INTERVAL_MS * 1000LL) reportReplication(host);
+    }
+
+    if (host->num_spectators > 0 && now - host->fanout.window_start_us >= FANOUT_REPORT_INTERVAL_MS * 1000LL) {
+        reportFanout(host, now);
+    }
+
+    // A spectator that stopped reading gets no POLLOUT and, once its game is over, no new
+    // output: flushDirty() only sees it again, and drops it, if it is marked here.
+    if (host->num_spectators > 0 && now - host->stall_sweep_us >= SPECTATOR_SWEEP_MS * 1000LL) {
+        for (int i = 1; i < host->num_pfds; i++) {
+            Conn *conn = host->conns[host->pfds[i].fd];
+            if (conn && conn->role == ROLE_SPECTATOR && conn->stalled_us &&
+                now - conn->stalled_us >= SPECTATOR_STALL_MS * 1000LL) {
+                markDirty(host, conn);
+            }
+        }
+        host->stall_sweep_us = now;
+    }
+
+    // Games whose players never came back after a failover are forfeited.
+    if (host->promoted_us && now - host->promoted_us >= RESUME_TIMEOUT_MS * 1000LL) {
+        for (int id = 0; id < poolCapacity(&host->games); id++) {
+            Game *game = findGame(host, (unsigned)id);
+            if (game && (game->player_x_socket < 0 || game->player_o_socket < 0)) {
+                printf("Game %d: players did not resume; abandoned.\n", id);
+                endGame(host, game, RESULT_ABANDONED);
+            }
+        }
+        host->promoted_us = 0;
+    }
+}
+
+/* ================== PUBLIC API ================== */
+
+void hostInit(Host *host) {
+    memset(host, 0, sizeof(*host));
+    host->listen_socket = -1;
+    host->standby_fd = -1;
+    poolInit(&host->games, "game", sizeof(Game));
+    poolInit(&host->players, "player", sizeof(Conn));
+}
+
+int hostListen(Host *host, int port) {
+    host->listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (host->listen_socket < 0) {
+        perror("Socket creation failed");
+        return -1;
+    }
+
+    int one = 1;
+    setsockopt(host->listen_socket, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_addr.s_addr = INADDR_ANY, .sin_port = htons(port) };
+    if (bind(host->listen_socket, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("Bind failed");
+        close(host->listen_socket);
+        host->listen_socket = -1;
+        return -1;
+    }
+    if (listen(host->listen_socket, SOMAXCONN) < 0 || setNonBlocking(host->listen_socket) != 0) {
+        perror("Listen failed");
+        close(host->listen_socket);
+        host->listen_socket = -1;
+        return -1;
+    }
+
+    if (growArray((void **)&host->pfds, &host->pfd_cap, 1, sizeof(struct pollfd)) != 0) return -1;
+    host->pfds[0] = (struct pollfd){ .fd = host->listen_socket, .events = POLLIN };
+    host->num_pfds = 1;
+    return 0;
+}
+
+int hostApplyReplication(Host *host, const Message *msg) {
+    Game *game;
+
+    if (msg->type == MSG_SNAPSHOT) {
+        if (!(game = claimGame(host, (int)msg->game_id))) return -1;
+        protoRestore(msg, game);
+        game->player_x_socket = game->player_o_socket = -1;
+        return 0;
+    }
+    if (msg->type != MSG_REPL) return -1;
+
+    host->repl_seq = msg->seq;
+    switch (msg->value) {
+        case REPL_START:
+            if (!(game = claimGame(host, (int)msg->game_id))) return -1;
+            initializeBoard(game);
+            game->player_x_socket = game->player_o_socket = -1;
+            return 0;
+        case REPL_MOVE:
+            if (!(game = findGame(host, msg->game_id))) return -1;
+            return makeMove(game, (int)msg->cell, game->current_turn == 0 ? 'X' : 'O') ? 0 : -1;
+        case REPL_END:
+            if (poolIsLive(&host->games, (int)msg->game_id)) poolFree(&host->games, NULL, (int)msg->game_id);
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+void hostPromote(Host *host) {
+    // Replicated games keep their ids; finished ones are already back in the pool.
+    int active = host->games.live;
+    host->promoted_us = monotonicMicros();
+    printf("Promoted to host with %d active games awaiting RESUME.\n", active);
+}
+
+int hostRun(Host *host) {
+    while (1) {
+        // Timers only matter while a standby is attached or players are resuming.
+        int timeout = -1;
+        if (host->standby_fd >= 0) timeout = HEARTBEAT_INTERVAL_MS;
+        if ((host->promoted_us || host->num_spectators > 0) && timeout < 0) timeout = 1000;
+
+        if (poll(host->pfds, (nfds_t)host->num_pfds, timeout) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll failed");
+            return -1;
+        }
+
+        // Walk backwards so removals (swap with last) never skip a ready socket.
+        for (int i = host->num_pfds - 1; i >= 1; i--) {
+            if (i >= host->num_pfds || !host->pfds[i].revents) continue;
+            short revents = host->pfds[i].revents;
+            host->pfds[i].revents = 0;
+            serviceConn(host, host->pfds[i].fd, revents);
+        }
+        if (host->pfds[0].revents & POLLIN) acceptAll(host);
+
+        hostTick(host);
+        flushDirty(host);
+    }
+    return 0;
+}
+
+void hostDestroy(Host *host) {
+    for (int fd = 0; fd < host->conn_cap; fd++) {
+        if (host->conns[fd]) removeConn(host, fd);
+    }
+    if (host->listen_socket >= 0) close(host->listen_socket);
+    free(host->pfds);
+    free(host->conns);
+    free(host->dirty);
+    free(host->wait_queue);
+    for (int id = 0; id < host->watcher_cap; id++) {
+        free(host->watchers[id].fds);
+        sharedBufRelease(host->watchers[id].snapshot);
+    }
+    poolDestroy(&host->games);
+    poolDestroy(&host->players);
+    free(host->watchers);
+    free(host->held);
+    free(host->sent_us);
+    memset(host, 0, sizeof(*host));
+}
@@ -0,0 +1,207 @@
+/**
+ * @file host.h
+ * @brief Game host: accepts players, pairs them into games and relays moves.
+ *
+ * A host can stream its state to one standby replica. The standby receives a
+ * SNAPSHOT of every active game when it attaches and a REPL move-log entry for
+ * every game start, move and end afterwards. Player-visible messages produced
+ * after a log entry are held until the standby acknowledges it, so the standby
+ * always knows at least as much as any player has seen.
+ *
+ * Spectators WATCH a game. Each board update is encoded once into a SharedBuf
+ * and queued by reference on every spectator; a spectator that falls
+ * SPECTATOR_QUEUE_LIMIT updates behind loses its unsent updates and skips to a
+ * snapshot of the latest state, and one that accepts no bytes for
+ * SPECTATOR_STALL_MS is dropped. Spectator sockets get a fixed SPECTATOR_SNDBUF
+ * so that a lagging spectator's backlog builds up in the host's queue rather
+ * than in the kernel.
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#include <poll.h>
+#include "tictactoe.h"
+#include "protocol.h"
+#include "pool.h"
+
+#define HEARTBEAT_INTERVAL_MS 100   /**< Host -> standby heartbeat period */
+#define HEARTBEAT_TIMEOUT_MS 500    /**< Silence after which the standby declares the host dead */
+#define RESUME_TIMEOUT_MS 10000     /**< Time players get to reattach after a failover */
+#define REPL_REPORT_INTERVAL_MS 10000 /**< Period of the replication statistics report */
+#define SPECTATOR_QUEUE_LIMIT 8     /**< Queued updates after which a spectator skips to the latest state (a game sends up to NUM_CELLS + 1) */
+#define SPECTATOR_SNDBUF 8192       /**< Kernel send buffer of a spectator socket (autotuning would hide its lag) */
+#define SPECTATOR_STALL_MS 5000     /**< A spectator that accepts nothing for this long is dropped */
+#define SPECTATOR_SWEEP_MS 1000     /**< Period of the check for stalled spectators that get no new output */
+#define FANOUT_REPORT_INTERVAL_MS 5000 /**< Period of the fan-out throughput report */
+#define SEND_BATCH 64               /**< Queue entries handed to one writev() */
+
+/**
+ * @struct QueuedBuf
+ * @brief One entry of a connection's send queue.
+ */
+typedef struct {
+    SharedBuf *buf;    /**< Referenced bytes */
+    size_t off;        /**< Bytes of buf already written */
+} QueuedBuf;
+
+/**
+ * @struct Conn
+ * @brief Per-socket connection state kept by the host.
+ */
+typedef struct {
+    Player player;     /**< Player record (socket, id, availability) */
+    InBuf in;          /**< Bytes received but not yet decoded */
+    OutBuf out;        /**< Private messages encoded since the last flush */
+    QueuedBuf *queue;  /**< FIFO ring of shared buffers waiting to be written */
+    int q_head;        /**< Index of the oldest queued buffer */
+    int q_len;         /**< Number of queued buffers */
+    int q_cap;         /**< Ring capacity */
+    size_t q_bytes;    /**< Unwritten bytes in the queue */
+    long long stalled_us; /**< Time a write last made no progress, or 0 */
+    int watching;      /**< Game being spectated, or -1 */
+    int watch_index;   /**< Slot in that game's watcher list */
+    int role;          /**< Role announced in HELLO */
+    int game_id;       /**< Game being played, or -1 */
+    int greeted;       /**< 1 once a valid HELLO was received */
+    int waiting;       /**< 1 while queued for matchmaking */
+    int dirty;         /**< 1 while on the flush list */
+    int held;          /**< Messages held for this connection until the standby acks */
+    int pfd_index;     /**< Slot in the host's pollfd array */
+    int handle;        /**< Handle in the host's player pool */
+} Conn;
+
+/**
+ * @struct HeldMsg
+ * @brief A player message waiting for the standby to acknowledge a log entry.
+ */
+typedef struct {
+    unsigned seq;      /**< Log entry that must be acknowledged first */
+    int fd;            /**< Destination socket */
+    int player_id;     /**< Destination player, to detect a reused fd */
+    Message msg;       /**< Message to release */
+} HeldMsg;
+
+/**
+ * @struct ReplStats
+ * @brief Counters describing the cost of replication.
+ */
+typedef struct {
+    long long entries;        /**< REPL entries streamed */
+    long long snapshots;      /**< SNAPSHOT messages streamed */
+    long long bytes;          /**< Bytes sent to the standby */
+    long long acks;           /**< Log entries acknowledged */
+    long long ack_us_total;   /**< Sum of entry -> ack latencies */
+    long long ack_us_max;     /**< Worst entry -> ack latency */
+    long long last_report_us; /**< Time of the last report */
+} ReplStats;
+
+/**
+ * @struct Watchers
+ * @brief Spectators of one game and the shared snapshot of its latest state.
+ */
+typedef struct {
+    int *fds;             /**< Spectator sockets */
+    int count;            /**< Entries in fds */
+    int cap;              /**< Allocated entries in fds */
+    SharedBuf *snapshot;  /**< Encoded SNAPSHOT for lagging spectators, or NULL */
+    int snapshot_moves;   /**< move_count the cached snapshot reflects */
+} Watchers;
+
+/**
+ * @struct FanoutStats
+ * @brief Counters describing spectator fan-out.
+ */
+typedef struct {
+    long long updates;        /**< Shared update buffers encoded */
+    long long deliveries;     /**< Update buffers queued on spectator sockets */
+    long long skipped;        /**< Times a lagging spectator skipped to a snapshot */
+    long long dropped;        /**< Stalled spectators disconnected */
+    long long window_start_us;/**< Start of the current report window */
+    long long window_deliveries; /**< Deliveries in the current window */
+} FanoutStats;
+
+/**
+ * @struct Host
+ * @brief Complete state of a running game host.
+ */
+typedef struct {
+    int listen_socket;       /**< Listening socket, or -1 while acting as a replica */
+    struct pollfd *pfds;     /**< pollfd array: [0] is the listener, then one per connection */
+    int num_pfds;            /**< Entries in use in pfds */
+    int pfd_cap;             /**< Allocated entries in pfds */
+    Conn **conns;            /**< Connections indexed by socket fd */
+    int conn_cap;            /**< Allocated entries in conns */
+    int *dirty;              /**< Sockets with pending output, flushed once per loop */
+    int num_dirty;           /**< Entries in dirty */
+    int dirty_cap;           /**< Allocated entries in dirty */
+    int *wait_queue;         /**< Matchmaking FIFO of sockets (ring buffer) */
+    int wait_head;           /**< Index of the oldest waiting entry */
+    int wait_len;            /**< Number of queued entries */
+    int wait_cap;            /**< Ring buffer capacity */
+    Pool games;              /**< Game objects; a game's id is its pool handle */
+    Pool players;            /**< Conn objects, each embedding its Player record */
+    Watchers *watchers;      /**< Spectators per game, indexed by game_id */
+    int watcher_cap;         /**< Allocated entries in watchers */
+    int next_player_id;      /**< Id assigned to the next player */
+
+    int standby_fd;          /**< Socket of the attached standby, or -1 */
+    unsigned repl_seq;       /**< Sequence number of the last log entry sent */
+    unsigned repl_acked;     /**< Last sequence number acknowledged by the standby */
+    HeldMsg *held;           /**< FIFO ring of messages waiting for an ack */
+    int held_head;           /**< Index of the oldest held message */
+    int held_len;            /**< Number of held messages */
+    int held_cap;            /**< Ring capacity */
+    long long *sent_us;      /**< Send time of each unacknowledged entry, indexed by seq % sent_cap */
+    int sent_cap;            /**< Capacity of sent_us (a power of two) */
+    long long last_heartbeat_us; /**< Time the last heartbeat was sent */
+    ReplStats stats;         /**< Replication cost counters */
+    long long promoted_us;   /**< Time this host took over from a dead host, or 0 */
+
+    int num_spectators;      /**< Connected spectators */
+    long long stall_sweep_us; /**< Time stalled spectators were last looked for */
+    FanoutStats fanout;      /**< Spectator fan-out counters */
+} Host;
+
+/**
+ * @brief Prepares an empty host that is not yet listening.
+ * @param host Host to initialize.
+ */
+void hostInit(Host *host);
+
+/**
+ * @brief Binds the listening socket.
+ * @param host Initialized host.
+ * @param port TCP port to listen on.
+ * @return 0 on success, -1 on failure.
+ */
+int hostListen(Host *host, int port);
+
+/**
+ * @brief Applies a SNAPSHOT or REPL message received from the active host to a replica.
+ * @param host Replica host (not listening).
+ * @param msg Replication message.
+ * @return 0 on success, -1 if the message does not fit the replica's state.
+ */
+int hostApplyReplication(Host *host, const Message *msg);
+
+/**
+ * @brief Turns a replica into the active host: games wait for their players to RESUME.
+ * @param host Replica host.
+ */
+void hostPromote(Host *host);
+
+/**
+ * @brief Runs the host event loop until a fatal error occurs.
+ * @param host Listening host.
+ * @return 0 on clean exit, -1 on error.
+ */
+int hostRun(Host *host);
+
+/**
+ * @brief Closes every socket and frees all host memory.
+ * @param host Host to tear down.
+ */
+void hostDestroy(Host *host);
+
+#endif // HOST_H
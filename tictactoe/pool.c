@@ -0,0 +1,226 @@
+/**
+ * @file pool.c
+ * @brief Slab-backed fixed-size object pool.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+
+#define POOL_POISON 0xDD   /**< Fill byte of freed slots in POOL_DEBUG builds */
+
+/**
+ * @brief Returns the state word of a slot.
+ */
+static int *slotState(const Pool *pool, int handle) {
+    return &pool->slabs[handle >> POOL_SLAB_SHIFT].state[handle & (POOL_SLAB_SLOTS - 1)];
+}
+
+/**
+ * @brief Returns the memory of a slot without liveness checks.
+ */
+static unsigned char *slotMemory(const Pool *pool, int handle) {
+    return pool->slabs[handle >> POOL_SLAB_SHIFT].slots +
+           (size_t)(handle & (POOL_SLAB_SLOTS - 1)) * pool->slot_size;
+}
+
+/**
+ * @brief Pushes a free handle on the shared stack. Caller holds the lock.
+ */
+static void pushFree(Pool *pool, int handle) {
+    *slotState(pool, handle) = pool->num_free;
+    pool->free_stack[pool->num_free++] = handle;
+}
+
+/**
+ * @brief Removes the handle at a position of the shared stack. Caller holds the lock.
+ */
+static void removeFree(Pool *pool, int position) {
+    int last = pool->free_stack[--pool->num_free];
+    if (position != pool->num_free) {
+        pool->free_stack[position] = last;
+        *slotState(pool, last) = position;
+    }
+}
+
+/**
+ * @brief Adds one slab and puts its slots on the free stack. Caller holds the lock.
+ * @return 0 on success, -1 if memory or the slab directory is exhausted.
+ */
+static int addSlab(Pool *pool) {
+    if (pool->num_slabs == POOL_MAX_SLABS) return -1;
+
+    int total = (pool->num_slabs + 1) * POOL_SLAB_SLOTS;
+    int *stack = realloc(pool->free_stack, (size_t)total * sizeof(int));
+    if (!stack) return -1;
+    pool->free_stack = stack;
+
+    PoolSlab *slab = &pool->slabs[pool->num_slabs];
+    slab->slots = aligned_alloc(CACHE_LINE_SIZE, pool->slot_size * POOL_SLAB_SLOTS);
+    slab->state = malloc(POOL_SLAB_SLOTS * sizeof(int));
+    if (!slab->slots || !slab->state) {
+        free(slab->slots);
+        free(slab->state);
+        slab->slots = NULL;
+        slab->state = NULL;
+        return -1;
+    }
+#ifdef POOL_DEBUG
+    memset(slab->slots, POOL_POISON, pool->slot_size * POOL_SLAB_SLOTS);
+#endif
+
+    // Push in reverse so the lowest handle is handed out first.
+    int base = pool->num_slabs++ * POOL_SLAB_SLOTS;
+    for (int i = POOL_SLAB_SLOTS - 1; i >= 0; i--) pushFree(pool, base + i);
+    return 0;
+}
+
+/**
+ * @brief Marks a free slot as allocated and zeroes it.
+ */
+static void *takeSlot(Pool *pool, int handle) {
+    unsigned char *slot = slotMemory(pool, handle);
+#ifdef POOL_DEBUG
+    for (size_t i = 0; i < pool->object_size; i++) {
+        if (slot[i] != POOL_POISON) {
+            fprintf(stderr, "%s pool: handle %d was written after it was freed\n", pool->name, handle);
+            break;
+        }
+    }
+#endif
+    *slotState(pool, handle) = SLOT_LIVE;
+    memset(slot, 0, pool->object_size);
+    return slot;
+}
+
+/**
+ * @brief Marks a live slot as free and poisons it in debug builds.
+ */
+static void releaseSlot(Pool *pool, int handle) {
+#ifdef POOL_DEBUG
+    poolCheckLive(pool, handle);
+    memset(slotMemory(pool, handle), POOL_POISON, pool->object_size);
+#endif
+    *slotState(pool, handle) = SLOT_CACHED;
+}
+
+int poolInit(Pool *pool, const char *name, size_t object_size) {
+    memset(pool, 0, sizeof(*pool));
+    pool->name = name;
+    pool->object_size = object_size;
+    pool->slot_size = (object_size + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    return (pthread_mutex_init(&pool->lock, NULL) == 0) ? 0 : -1;
+}
+
+int poolAlloc(Pool *pool, PoolCache *cache) {
+    int handle = POOL_NO_HANDLE;
+
+    if (cache && cache->count > 0) {
+        handle = cache->handles[--cache->count];
+        takeSlot(pool, handle);
+        __atomic_add_fetch(&pool->live, 1, __ATOMIC_RELAXED);
+        return handle;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->num_free > 0 || addSlab(pool) == 0) {
+        handle = pool->free_stack[pool->num_free - 1];
+        removeFree(pool, pool->num_free - 1);
+
+        // Refill half the cache while the lock is held.
+        while (cache && cache->count < POOL_CACHE_SIZE / 2 && pool->num_free > 0) {
+            int spare = pool->free_stack[pool->num_free - 1];
+            removeFree(pool, pool->num_free - 1);
+            *slotState(pool, spare) = SLOT_CACHED;
+            cache->handles[cache->count++] = spare;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (handle != POOL_NO_HANDLE) {
+        takeSlot(pool, handle);
+        __atomic_add_fetch(&pool->live, 1, __ATOMIC_RELAXED);
+    }
+    return handle;
+}
+
+int poolClaim(Pool *pool, int handle) {
+    int status = -1;
+
+    if (handle < 0 || handle >= POOL_MAX_SLABS * POOL_SLAB_SLOTS) return -1;
+    pthread_mutex_lock(&pool->lock);
+    while (handle >= pool->num_slabs * POOL_SLAB_SLOTS && addSlab(pool) == 0);
+    if (handle < pool->num_slabs * POOL_SLAB_SLOTS && *slotState(pool, handle) >= 0) {
+        removeFree(pool, *slotState(pool, handle));
+        status = 0;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (status == 0) {
+        takeSlot(pool, handle);
+        __atomic_add_fetch(&pool->live, 1, __ATOMIC_RELAXED);
+    }
+    return status;
+}
+
+void poolFree(Pool *pool, PoolCache *cache, int handle) {
+    releaseSlot(pool, handle);
+    __atomic_sub_fetch(&pool->live, 1, __ATOMIC_RELAXED);
+
+    if (cache) {
+        if (cache->count == POOL_CACHE_SIZE) {
+            // Spill half so the next frees and allocs both stay local.
+            pthread_mutex_lock(&pool->lock);
+            while (cache->count > POOL_CACHE_SIZE / 2) pushFree(pool, cache->handles[--cache->count]);
+            pthread_mutex_unlock(&pool->lock);
+        }
+        cache->handles[cache->count++] = handle;
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pushFree(pool, handle);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+int poolIsLive(const Pool *pool, int handle) {
+    return handle >= 0 && handle < pool->num_slabs * POOL_SLAB_SLOTS &&
+           *slotState(pool, handle) == SLOT_LIVE;
+}
+
+void poolCheckLive(const Pool *pool, int handle) {
+    if (poolIsLive(pool, handle)) return;
+    if (handle >= 0 && handle < pool->num_slabs * POOL_SLAB_SLOTS) {
+        fprintf(stderr, "%s pool: use after free of handle %d\n", pool->name, handle);
+    } else {
+        fprintf(stderr, "%s pool: invalid handle %d\n", pool->name, handle);
+    }
+    abort();
+}
+
+int poolCapacity(const Pool *pool) {
+    return pool->num_slabs * POOL_SLAB_SLOTS;
+}
+
+void poolCacheInit(PoolCache *cache, Pool *pool) {
+    cache->pool = pool;
+    cache->count = 0;
+}
+
+void poolCacheFlush(PoolCache *cache) {
+    if (cache->count == 0) return;
+    pthread_mutex_lock(&cache->pool->lock);
+    while (cache->count > 0) pushFree(cache->pool, cache->handles[--cache->count]);
+    pthread_mutex_unlock(&cache->pool->lock);
+}
+
+void poolDestroy(Pool *pool) {
+    for (int i = 0; i < pool->num_slabs; i++) {
+        free(pool->slabs[i].slots);
+        free(pool->slabs[i].state);
+    }
+    free(pool->free_stack);
+    pthread_mutex_destroy(&pool->lock);
+    memset(pool, 0, sizeof(*pool));
+}
@@ -0,0 +1,160 @@
+/**
+ * @file pool.h
+ * @brief Fixed-size object pool with stable integer handles.
+ *
+ * Objects live in slabs of POOL_SLAB_SLOTS cache-line-aligned slots. Slabs are
+ * never moved or freed while the pool exists, so a handle (the slot number)
+ * stays valid for the object's lifetime and resolving it is a single index
+ * into the slab directory. Freed slots are reused before new slabs are added,
+ * which keeps create/destroy churn away from malloc entirely.
+ *
+ * The shared free list is protected by a mutex. Threads that allocate and free
+ * at high rates attach a PoolCache, a private stack of free handles that is
+ * refilled from and spilled to the shared list in batches.
+ *
+ * Building with -DPOOL_DEBUG poisons freed slots, aborts when a freed handle
+ * is resolved or freed again, and reports writes through stale pointers when
+ * the slot is handed out next.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#define CACHE_LINE_SIZE 64     /**< Slot alignment; keeps objects from sharing cache lines */
+#define POOL_SLAB_SHIFT 10     /**< log2 of the slots per slab */
+#define POOL_SLAB_SLOTS (1 << POOL_SLAB_SHIFT) /**< Slots per slab */
+#define POOL_MAX_SLABS 1024    /**< Slab directory size (caps a pool at 1M objects) */
+#define POOL_CACHE_SIZE 64     /**< Free handles a PoolCache holds at most */
+#define POOL_NO_HANDLE (-1)    /**< Returned when no object could be allocated */
+
+/** Slot states kept in PoolSlab::state. */
+enum {
+    SLOT_LIVE = -1,    /**< Allocated */
+    SLOT_CACHED = -2   /**< Free, parked in a PoolCache */
+};
+
+/**
+ * @struct PoolSlab
+ * @brief One block of slots and their bookkeeping.
+ */
+typedef struct {
+    unsigned char *slots;  /**< POOL_SLAB_SLOTS objects, CACHE_LINE_SIZE aligned */
+    int *state;            /**< Per slot: SLOT_LIVE, SLOT_CACHED or index in the free stack */
+} PoolSlab;
+
+/**
+ * @struct Pool
+ * @brief A pool of equally sized objects.
+ */
+typedef struct {
+    const char *name;        /**< Label used in diagnostics */
+    size_t object_size;      /**< Bytes requested per object */
+    size_t slot_size;        /**< object_size rounded up to a cache line */
+    pthread_mutex_t lock;    /**< Guards the free stack and slab growth */
+    PoolSlab slabs[POOL_MAX_SLABS]; /**< Slab directory */
+    int num_slabs;           /**< Slabs allocated */
+    int *free_stack;         /**< Free handles, most recently freed on top */
+    int num_free;            /**< Entries in free_stack */
+    int live;                /**< Objects currently allocated */
+} Pool;
+
+/**
+ * @struct PoolCache
+ * @brief Per-thread stack of free handles for one pool.
+ */
+typedef struct {
+    Pool *pool;                      /**< Pool the handles belong to */
+    int handles[POOL_CACHE_SIZE];    /**< Free handles */
+    int count;                       /**< Entries in handles */
+} PoolCache;
+
+/**
+ * @brief Prepares an empty pool.
+ * @param pool Pool to initialize.
+ * @param name Label for diagnostics.
+ * @param object_size Size of one object in bytes.
+ * @return 0 on success, -1 on failure.
+ */
+int poolInit(Pool *pool, const char *name, size_t object_size);
+
+/**
+ * @brief Allocates a zeroed object.
+ * @param pool Pool to allocate from.
+ * @param cache Calling thread's cache, or NULL to use the shared list directly.
+ * @return The object's handle, or POOL_NO_HANDLE when memory or the directory is exhausted.
+ */
+int poolAlloc(Pool *pool, PoolCache *cache);
+
+/**
+ * @brief Allocates the object with a specific handle (used by replicas that mirror ids).
+ * - The handle must not be parked in a PoolCache.
+ *
+ * @param pool Pool to allocate from.
+ * @param handle Handle to take.
+ * @return 0 on success, -1 if the handle is live or cannot be reached.
+ */
+int poolClaim(Pool *pool, int handle);
+
+/**
+ * @brief Returns an object to the pool.
+ * @param pool Pool that owns the object.
+ * @param cache Calling thread's cache, or NULL.
+ * @param handle Handle of a live object.
+ */
+void poolFree(Pool *pool, PoolCache *cache, int handle);
+
+/**
+ * @brief Reports whether a handle refers to an allocated object.
+ * @param pool Pool to check.
+ * @param handle Any integer (out-of-range values are not live).
+ * @return 1 if live, 0 otherwise.
+ */
+int poolIsLive(const Pool *pool, int handle);
+
+/**
+ * @brief Aborts with a diagnostic if a handle is not live (POOL_DEBUG builds).
+ */
+void poolCheckLive(const Pool *pool, int handle);
+
+/**
+ * @brief Resolves a handle to its object.
+ * @param pool Pool that owns the object.
+ * @param handle Handle of a live object.
+ * @return Pointer to the object; stable until the object is freed.
+ */
+static inline void *poolGet(const Pool *pool, int handle) {
+#ifdef POOL_DEBUG
+    poolCheckLive(pool, handle);
+#endif
+    return pool->slabs[handle >> POOL_SLAB_SHIFT].slots +
+           (size_t)(handle & (POOL_SLAB_SLOTS - 1)) * pool->slot_size;
+}
+
+/**
+ * @brief Returns one past the largest handle the pool can currently hold.
+ */
+int poolCapacity(const Pool *pool);
+
+/**
+ * @brief Attaches an empty cache to a pool.
+ * @param cache Cache to initialize.
+ * @param pool Pool it serves.
+ */
+void poolCacheInit(PoolCache *cache, Pool *pool);
+
+/**
+ * @brief Returns every cached handle to the shared list (call before the thread exits).
+ * @param cache Cache to drain.
+ */
+void poolCacheFlush(PoolCache *cache);
+
+/**
+ * @brief Frees every slab. Handles and pointers from the pool become invalid.
+ * @param pool Pool to tear down.
+ */
+void poolDestroy(Pool *pool);
+
+#endif // POOL_H
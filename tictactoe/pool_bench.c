@@ -0,0 +1,129 @@
+/**
+ * @file pool_bench.c
+ * @brief Create/destroy storm: object pool versus malloc/free.
+ *
+ * Every thread keeps a working set of live objects and repeatedly destroys a
+ * random one and creates a replacement, touching the new object the way the
+ * host initializes a Game or a connection. The same storm runs once through
+ * malloc/free and once through a shared Pool with a PoolCache per thread.
+ *
+ * Usage: ./pool_bench [operations per thread] [max threads]
+ */
+
+#include <time.h>
+#include "tictactoe.h"
+#include "host.h"
+#include "pool.h"
+
+#define DEFAULT_OPS 2000000   /**< Create/destroy pairs per thread */
+#define DEFAULT_THREADS 4     /**< Largest thread count measured */
+#define WORKING_SET 4096      /**< Live objects per thread */
+#define BENCH_SEED 42         /**< Fixed seed so runs are comparable */
+
+/**
+ * @struct StormArgs
+ * @brief Parameters and result of one thread's storm.
+ */
+typedef struct {
+    Pool *pool;          /**< Pool to use, or NULL for malloc/free */
+    size_t size;         /**< Object size */
+    long ops;            /**< Create/destroy pairs */
+    unsigned seed;       /**< Per-thread random seed */
+    long long checksum;  /**< Keeps the touches from being optimized out */
+} StormArgs;
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ */
+static long long nowNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Runs one thread's storm.
+ */
+static void *storm(void *arg) {
+    StormArgs *a = arg;
+    void *objects[WORKING_SET];
+    int handles[WORKING_SET];
+    PoolCache cache;
+
+    if (a->pool) poolCacheInit(&cache, a->pool);
+    for (int i = 0; i < WORKING_SET; i++) {
+        if (a->pool) {
+            handles[i] = poolAlloc(a->pool, &cache);
+            objects[i] = poolGet(a->pool, handles[i]);
+        } else {
+            objects[i] = calloc(1, a->size);
+        }
+    }
+
+    for (long op = 0; op < a->ops; op++) {
+        int victim = (int)(rand_r(&a->seed) % WORKING_SET);
+        a->checksum += *(int *)objects[victim];
+        if (a->pool) {
+            poolFree(a->pool, &cache, handles[victim]);
+            handles[victim] = poolAlloc(a->pool, &cache);
+            objects[victim] = poolGet(a->pool, handles[victim]);
+        } else {
+            free(objects[victim]);
+            objects[victim] = calloc(1, a->size);
+        }
+        *(int *)objects[victim] = (int)op;
+    }
+
+    for (int i = 0; i < WORKING_SET; i++) {
+        if (a->pool) poolFree(a->pool, &cache, handles[i]);
+        else free(objects[i]);
+    }
+    if (a->pool) poolCacheFlush(&cache);
+    return NULL;
+}
+
+/**
+ * @brief Runs the storm on several threads and returns nanoseconds per create/destroy pair.
+ */
+static double runStorm(Pool *pool, size_t size, long ops, int threads) {
+    pthread_t tids[threads];
+    StormArgs args[threads];
+    long long start = nowNanos();
+
+    for (int t = 0; t < threads; t++) {
+        args[t] = (StormArgs){ .pool = pool, .size = size, .ops = ops, .seed = BENCH_SEED + (unsigned)t };
+        pthread_create(&tids[t], NULL, storm, &args[t]);
+    }
+    for (int t = 0; t < threads; t++) pthread_join(tids[t], NULL);
+    return (double)(nowNanos() - start) / ((double)ops * threads);
+}
+
+/**
+ * @brief Benchmarks one object type at every thread count.
+ */
+static void benchType(const char *name, size_t size, long ops, int max_threads) {
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        Pool pool;
+        if (poolInit(&pool, name, size) != 0) return;
+        double malloc_ns = runStorm(NULL, size, ops, threads);
+        double pool_ns = runStorm(&pool, size, ops, threads);
+        printf("%-8s %6zu B  %2d thread%s  malloc %7.1f ns/op  pool %7.1f ns/op  (%.2fx)\n",
+               name, size, threads, threads == 1 ? " " : "s", malloc_ns, pool_ns, malloc_ns / pool_ns);
+        poolDestroy(&pool);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long ops = (argc > 1) ? atol(argv[1]) : DEFAULT_OPS;
+    int max_threads = (argc > 2) ? atoi(argv[2]) : DEFAULT_THREADS;
+
+    if (ops < 1 || max_threads < 1) {
+        printf("Usage: %s [operations per thread] [max threads]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("Create/destroy storm: %ld ops per thread, working set %d objects per thread\n",
+           ops, WORKING_SET);
+    benchType("Game", sizeof(Game), ops, max_threads);
+    benchType("Player", sizeof(Conn), ops, max_threads);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,309 @@
+/**
+ * @file protocol.c
+ * @brief Encoding, decoding and buffering for the Tic-Tac-Toe wire protocol.
+ */
+
+#include <errno.h>
+#include <time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "protocol.h"
+
+/**
+ * @brief Makes room for at least extra more bytes in an output buffer.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int outBufReserve(OutBuf *out, size_t extra) {
+    if (out->len + extra <= out->cap) return 0;
+
+    size_t cap = out->cap ? out->cap : 64;
+    while (cap < out->len + extra) cap *= 2;
+    uint8_t *data = realloc(out->data, cap);
+    if (!data) return -1;
+    out->data = data;
+    out->cap = cap;
+    return 0;
+}
+
+/**
+ * @brief Writes an unsigned LEB128 varint.
+ * @return Number of bytes written (at most 5).
+ */
+static int putVarint(uint8_t *p, unsigned value) {
+    int n = 0;
+    while (value >= 0x80) {
+        p[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * @brief Reads an unsigned LEB128 varint.
+ * @return Bytes consumed, 0 if the input ends mid-varint, -1 if it is too long.
+ */
+static int getVarint(const uint8_t *p, size_t len, unsigned *value) {
+    unsigned result = 0;
+    for (size_t i = 0; i < len && i < 5; i++) {
+        result |= (unsigned)(p[i] & 0x7F) << (7 * i);
+        if (!(p[i] & 0x80)) {
+            *value = result;
+            return (int)i + 1;
+        }
+    }
+    return (len >= 5) ? -1 : 0;
+}
+
+int protoEncode(OutBuf *out, const Message *msg) {
+    if (outBufReserve(out, MAX_MSG_SIZE) != 0) return -1;
+
+    uint8_t *start = out->data + out->len;
+    uint8_t *p = start;
+    *p++ = (uint8_t)msg->type;
+
+    switch (msg->type) {
+        case MSG_HELLO:
+            *p++ = (uint8_t)msg->value;
+            *p++ = (uint8_t)msg->role;
+            break;
+        case MSG_JOIN:
+        case MSG_WAIT:
+            break;
+        case MSG_START:
+            p += putVarint(p, msg->game_id);
+            *p++ = (msg->symbol == 'O');
+            p += putVarint(p, msg->value);
+            break;
+        case MSG_MOVE:
+            p += putVarint(p, msg->game_id);
+            p += putVarint(p, msg->cell);
+            break;
+        case MSG_DELTA:
+            p += putVarint(p, msg->game_id);
+            p += putVarint(p, msg->cell);
+            *p++ = (msg->symbol == 'O');
+            break;
+        case MSG_END:
+        case MSG_ERROR:
+            p += putVarint(p, msg->game_id);
+            *p++ = (uint8_t)msg->value;
+            break;
+        case MSG_SNAPSHOT:
+            p += putVarint(p, msg->game_id);
+            p += putVarint(p, msg->seq);
+            p += putVarint(p, msg->value);
+            // Four cells per byte: 0 = empty, 1 = X, 2 = O.
+            memset(p, 0, (NUM_CELLS + 3) / 4);
+            for (int i = 0; i < NUM_CELLS; i++) {
+                int code = (msg->board[i] == 'X') ? 1 : (msg->board[i] == 'O') ? 2 : 0;
+                p[i / 4] |= (uint8_t)(code << (2 * (i % 4)));
+            }
+            p += (NUM_CELLS + 3) / 4;
+            break;
+        case MSG_REPL:
+            p += putVarint(p, msg->seq);
+            *p++ = (uint8_t)msg->value;
+            p += putVarint(p, msg->game_id);
+            p += putVarint(p, msg->cell);
+            break;
+        case MSG_HEARTBEAT:
+        case MSG_ACK:
+            p += putVarint(p, msg->seq);
+            break;
+        case MSG_RESUME:
+            p += putVarint(p, msg->game_id);
+            *p++ = (msg->symbol == 'O');
+            break;
+        case MSG_WATCH:
+            p += putVarint(p, msg->game_id);
+            break;
+        default:
+            return -1;
+    }
+
+    out->len += (size_t)(p - start);
+    return (int)(p - start);
+}
+
+/* Decoding helpers: bail out with 0 (incomplete) or -1 (malformed). */
+#define NEED_BYTE()  do { if (pos >= len) return 0; } while (0)
+#define GET_VARINT(field) do {                                   \
+        int n_ = getVarint(buf + pos, len - pos, &(field));      \
+        if (n_ <= 0) return n_;                                  \
+        pos += (size_t)n_;                                       \
+    } while (0)
+
+int protoDecode(const uint8_t *buf, size_t len, Message *msg) {
+    size_t pos = 0;
+
+    memset(msg, 0, sizeof(*msg));
+    NEED_BYTE();
+    msg->type = buf[pos++];
+
+    switch (msg->type) {
+        case MSG_HELLO:
+            NEED_BYTE();
+            msg->value = buf[pos++];
+            NEED_BYTE();
+            msg->role = buf[pos++];
+            break;
+        case MSG_JOIN:
+        case MSG_WAIT:
+            break;
+        case MSG_START:
+            GET_VARINT(msg->game_id);
+            NEED_BYTE();
+            msg->symbol = buf[pos++] ? 'O' : 'X';
+            GET_VARINT(msg->value);
+            break;
+        case MSG_MOVE:
+            GET_VARINT(msg->game_id);
+            GET_VARINT(msg->cell);
+            break;
+        case MSG_DELTA:
+            GET_VARINT(msg->game_id);
+            GET_VARINT(msg->cell);
+            NEED_BYTE();
+            msg->symbol = buf[pos++] ? 'O' : 'X';
+            break;
+        case MSG_END:
+        case MSG_ERROR:
+            GET_VARINT(msg->game_id);
+            NEED_BYTE();
+            msg->value = buf[pos++];
+            break;
+        case MSG_SNAPSHOT:
+            GET_VARINT(msg->game_id);
+            GET_VARINT(msg->seq);
+            GET_VARINT(msg->value);
+            if (msg->value != MAX_SIZE) return -1;
+            if (len - pos < (NUM_CELLS + 3) / 4) return 0;
+            for (int i = 0; i < NUM_CELLS; i++) {
+                int code = (buf[pos + i / 4] >> (2 * (i % 4))) & 3;
+                msg->board[i] = (code == 1) ? 'X' : (code == 2) ? 'O' : EMPTY_CELL;
+            }
+            pos += (NUM_CELLS + 3) / 4;
+            break;
+        case MSG_REPL:
+            GET_VARINT(msg->seq);
+            NEED_BYTE();
+            msg->value = buf[pos++];
+            GET_VARINT(msg->game_id);
+            GET_VARINT(msg->cell);
+            break;
+        case MSG_HEARTBEAT:
+        case MSG_ACK:
+            GET_VARINT(msg->seq);
+            break;
+        case MSG_RESUME:
+            GET_VARINT(msg->game_id);
+            NEED_BYTE();
+            msg->symbol = buf[pos++] ? 'O' : 'X';
+            break;
+        case MSG_WATCH:
+            GET_VARINT(msg->game_id);
+            break;
+        default:
+            return -1;
+    }
+    return (int)pos;
+}
+
+#undef NEED_BYTE
+#undef GET_VARINT
+
+void protoSnapshot(const Game *game, Message *msg) {
+    memset(msg, 0, sizeof(*msg));
+    msg->type = MSG_SNAPSHOT;
+    msg->game_id = (unsigned)game->game_id;
+    msg->seq = (unsigned)game->move_count;
+    msg->value = MAX_SIZE;
+    memcpy(msg->board, game->board, NUM_CELLS);
+}
+
+void protoRestore(const Message *msg, Game *game) {
+    game->game_id = (int)msg->game_id;
+    memcpy(game->board, msg->board, NUM_CELLS);
+    game->move_count = (int)msg->seq;
+    game->current_turn = game->move_count % 2;
+    game->active = 1;
+}
+
+long long monotonicMicros(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+void outBufConsume(OutBuf *out, size_t count) {
+    if (count >= out->len) {
+        out->len = 0;
+        return;
+    }
+    memmove(out->data, out->data + count, out->len - count);
+    out->len -= count;
+}
+
+void outBufFree(OutBuf *out) {
+    free(out->data);
+    out->data = NULL;
+    out->len = out->cap = 0;
+}
+
+SharedBuf *sharedBufCreate(const OutBuf *out) {
+    SharedBuf *buf = malloc(sizeof(SharedBuf) + out->len);
+    if (!buf) return NULL;
+    buf->refcount = 1;
+    buf->len = out->len;
+    memcpy(buf->data, out->data, out->len);
+    return buf;
+}
+
+SharedBuf *sharedBufRetain(SharedBuf *buf) {
+    buf->refcount++;
+    return buf;
+}
+
+void sharedBufRelease(SharedBuf *buf) {
+    if (buf && --buf->refcount == 0) free(buf);
+}
+
+int outBufFlush(int fd, OutBuf *out) {
+    while (out->len > 0) {
+        ssize_t sent = send(fd, out->data, out->len, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            return -1;
+        }
+        outBufConsume(out, (size_t)sent);
+    }
+    return 0;
+}
+
+int inBufFill(int fd, InBuf *in) {
+    ssize_t n;
+
+    // Slide undecoded bytes to the front only when a read is about to happen.
+    if (in->start > 0) {
+        in->len -= in->start;
+        memmove(in->data, in->data + in->start, in->len);
+        in->start = 0;
+    }
+    do {
+        n = recv(fd, in->data + in->len, IN_BUF_SIZE - in->len, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n > 0) in->len += (size_t)n;
+    return (int)n;
+}
+
+int inBufNext(InBuf *in, Message *msg) {
+    int used = protoDecode(in->data + in->start, in->len - in->start, msg);
+    if (used <= 0) return used;
+
+    in->start += (size_t)used;
+    return 1;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file protocol.h
+ * @brief Compact binary wire protocol between the Tic-Tac-Toe server and clients.
+ *
+ * Every message starts with a one-byte type followed by a fixed list of fields.
+ * Integer fields are unsigned LEB128 varints, so small game ids and cell indexes
+ * cost one byte each: a MOVE is 3 bytes and a DELTA is 4 bytes for the first
+ * 128 games, regardless of MAX_SIZE. The protocol version is negotiated once
+ * with HELLO when the connection opens.
+ *
+ * The server never sends the whole board: it sends a DELTA for every move, and
+ * the client applies it to its own copy. Messages bound for one peer are
+ * appended to an OutBuf and leave in a single write.
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tictactoe.h"
+
+#define PROTO_VERSION 3      /**< Wire format version carried by HELLO */
+#define IN_BUF_SIZE 4096     /**< Receive buffer size per connection */
+#define MAX_MSG_SIZE (32 + NUM_CELLS / 4) /**< Upper bound on the encoded size of one message */
+
+/**
+ * @enum MsgType
+ * @brief Message type byte. Direction is noted as c->s (client to server) or s->c.
+ */
+typedef enum {
+    MSG_HELLO = 1,   /**< c<->s: version, role */
+    MSG_JOIN,        /**< c->s: enter matchmaking */
+    MSG_WAIT,        /**< s->c: queued, waiting for an opponent */
+    MSG_START,       /**< s->c: game_id, symbol, board size */
+    MSG_MOVE,        /**< c->s: game_id, cell */
+    MSG_DELTA,       /**< s->c: game_id, cell, symbol */
+    MSG_END,         /**< s->c: game_id, result */
+    MSG_ERROR,       /**< s->c: game_id, error code */
+    MSG_SNAPSHOT,    /**< s->c: game_id, move count, board size, 2-bit packed cells */
+    MSG_REPL,        /**< host->standby: seq, op, game_id, cell or result (one move-log entry) */
+    MSG_HEARTBEAT,   /**< host->standby: latest seq */
+    MSG_ACK,         /**< standby->host: last applied seq */
+    MSG_RESUME,      /**< c->s: game_id, symbol; reattach to a game after failover */
+    MSG_WATCH,       /**< c->s: game_id; spectate a game (SNAPSHOT, then DELTAs and END) */
+    MSG_TYPE_COUNT
+} MsgType;
+
+/** Connection roles announced in HELLO. */
+typedef enum {
+    ROLE_PLAYER = 0,
+    ROLE_STANDBY,    /**< Replica that takes over when the host dies */
+    ROLE_SPECTATOR   /**< Read-only observer of live games */
+} Role;
+
+/** Move-log operations carried by REPL. */
+typedef enum {
+    REPL_START = 0,  /**< Game created; cell unused */
+    REPL_MOVE,       /**< Move applied at cell */
+    REPL_END         /**< Game finished; cell holds the GameResult */
+} ReplOp;
+
+/** Game results carried by END. */
+typedef enum {
+    RESULT_X_WINS = 0,
+    RESULT_O_WINS,
+    RESULT_DRAW,
+    RESULT_ABANDONED   /**< The opponent disconnected */
+} GameResult;
+
+/** Error codes carried by ERROR. */
+typedef enum {
+    ERR_NOT_YOUR_TURN = 1,
+    ERR_ILLEGAL_MOVE,
+    ERR_NO_SUCH_GAME,
+    ERR_BAD_VERSION,
+    ERR_BAD_MESSAGE,
+    ERR_SEAT_TAKEN   /**< RESUME for a seat that is already attached */
+} ErrorCode;
+
+/**
+ * @struct Message
+ * @brief Decoded form of any message; fields unused by a type are left at 0.
+ */
+typedef struct {
+    int type;          /**< MsgType */
+    unsigned game_id;  /**< Game the message refers to */
+    unsigned cell;     /**< 0-based cell index (MOVE, DELTA, REPL) */
+    unsigned value;    /**< Version (HELLO), board size (START, SNAPSHOT), result (END),
+                            error code (ERROR) or ReplOp (REPL) */
+    unsigned seq;      /**< Move-log sequence (REPL, HEARTBEAT, ACK) or move count (SNAPSHOT) */
+    int role;          /**< Role (HELLO) */
+    char symbol;       /**< 'X' or 'O' (START, DELTA, RESUME) */
+    char board[NUM_CELLS]; /**< Row-major cells (SNAPSHOT) */
+} Message;
+
+/**
+ * @struct OutBuf
+ * @brief Growable byte buffer collecting outbound messages for one peer.
+ */
+typedef struct {
+    uint8_t *data;  /**< Encoded bytes */
+    size_t len;     /**< Bytes queued */
+    size_t cap;     /**< Allocated size */
+} OutBuf;
+
+/**
+ * @struct SharedBuf
+ * @brief Immutable, reference-counted block of encoded messages.
+ *
+ * A board update is encoded once into a SharedBuf and the same block is queued
+ * on every spectator socket; each queue holds a reference instead of a copy.
+ * Reference counts are not atomic: buffers belong to the single host thread.
+ */
+typedef struct {
+    int refcount;     /**< Number of queues holding the buffer */
+    size_t len;       /**< Bytes in data */
+    uint8_t data[];   /**< Encoded messages */
+} SharedBuf;
+
+/**
+ * @struct InBuf
+ * @brief Receive buffer used to reassemble messages split across reads.
+ */
+typedef struct {
+    uint8_t data[IN_BUF_SIZE]; /**< Received bytes */
+    size_t start;              /**< Offset of the first byte not yet decoded */
+    size_t len;                /**< End of the valid bytes */
+} InBuf;
+
+/**
+ * @brief Appends one encoded message to an output buffer.
+ * @param out Buffer to append to (grown as needed).
+ * @param msg Message to encode.
+ * @return Number of bytes appended, or -1 on allocation failure or unknown type.
+ */
+int protoEncode(OutBuf *out, const Message *msg);
+
+/**
+ * @brief Decodes one message from the front of a byte stream.
+ * @param buf Received bytes.
+ * @param len Number of bytes available.
+ * @param msg Output message.
+ * @return Bytes consumed, 0 if the message is incomplete, or -1 if malformed.
+ */
+int protoDecode(const uint8_t *buf, size_t len, Message *msg);
+
+/**
+ * @brief Fills a SNAPSHOT message from a game.
+ * @param game Game to capture.
+ * @param msg Output message.
+ */
+void protoSnapshot(const Game *game, Message *msg);
+
+/**
+ * @brief Overwrites a game's board and turn from a SNAPSHOT message.
+ * @param msg SNAPSHOT to apply.
+ * @param game Game to update; it is marked active.
+ */
+void protoRestore(const Message *msg, Game *game);
+
+/**
+ * @brief Reads a monotonic clock.
+ * @return Microseconds since an arbitrary fixed point.
+ */
+long long monotonicMicros(void);
+
+/**
+ * @brief Drops the first count bytes of an output buffer after a partial write.
+ * @param out Buffer to trim.
+ * @param count Number of bytes already sent.
+ */
+void outBufConsume(OutBuf *out, size_t count);
+
+/**
+ * @brief Releases the memory held by an output buffer.
+ * @param out Buffer to free.
+ */
+void outBufFree(OutBuf *out);
+
+/**
+ * @brief Copies the contents of an output buffer into a new shared buffer.
+ * @param out Encoded messages.
+ * @return A buffer holding one reference, or NULL on allocation failure.
+ */
+SharedBuf *sharedBufCreate(const OutBuf *out);
+
+/**
+ * @brief Adds a reference to a shared buffer.
+ * @param buf Buffer to retain.
+ * @return buf, for convenience.
+ */
+SharedBuf *sharedBufRetain(SharedBuf *buf);
+
+/**
+ * @brief Drops a reference and frees the buffer when none remain.
+ * @param buf Buffer to release (NULL is ignored).
+ */
+void sharedBufRelease(SharedBuf *buf);
+
+/**
+ * @brief Sends everything queued in an output buffer with one write.
+ * - Blocking sockets are drained completely; on non-blocking sockets the
+ *   unsent tail stays queued.
+ *
+ * @param fd Socket to write to.
+ * @param out Buffer to flush.
+ * @return 0 on success (including a partial non-blocking write), -1 on error.
+ */
+int outBufFlush(int fd, OutBuf *out);
+
+/**
+ * @brief Reads available bytes from a socket into a receive buffer.
+ * @param fd Socket to read from.
+ * @param in Buffer to fill.
+ * @return Bytes read, 0 on orderly shutdown, or -1 on error.
+ */
+int inBufFill(int fd, InBuf *in);
+
+/**
+ * @brief Decodes the next complete message held in a receive buffer.
+ * @param in Buffer to decode from; consumed bytes are removed.
+ * @param msg Output message.
+ * @return 1 if a message was decoded, 0 if more bytes are needed, -1 if malformed.
+ */
+int inBufNext(InBuf *in, Message *msg);
+
+#endif // PROTOCOL_H
@@ -0,0 +1,30 @@
+/**
+ * @file server.c
+ * @brief Tic-Tac-Toe Server - Hosts games for connecting clients.
+ *
+ * Usage: ./server [port]
+ *
+ * A standby started with `./client -s <server_ip> [port]` replicates every game
+ * and takes over the port if this process dies.
+ */
+
+#include <signal.h>
+#include "host.h"
+
+int main(int argc, char *argv[]) {
+    int port = (argc > 1) ? atoi(argv[1]) : PORT;
+    Host host;
+
+    signal(SIGPIPE, SIG_IGN);
+
+    hostInit(&host);
+    if (hostListen(&host, port) != 0) {
+        printf("Unable to start the server.\n");
+        return EXIT_FAILURE;
+    }
+    printf("Server listening on port %d...\n", port);
+
+    int status = hostRun(&host);
+    hostDestroy(&host);
+    return (status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
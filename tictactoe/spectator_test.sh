@@ -0,0 +1,27 @@
+#!/bin/bash
+# Checks that slow spectators are skipped to snapshots:
+#   1. start a host,
+#   2. run a bot swarm with slow spectators against it (the swarm fails if a
+#      spectator's copy of a game ever goes out of sync),
+#   3. require the host's fan-out report to count skips to snapshot.
+
+PORT=${1:-9193}
+
+./server "$PORT" > spectator_host.log &
+HOST_PID=$!
+sleep 0.3
+
+# Longer than FANOUT_REPORT_INTERVAL_MS, so the host reports at least once
+./swarm -c -n 50 -d 6 -s 4 "$PORT"
+STATUS=$?
+kill "$HOST_PID"
+wait "$HOST_PID" 2>/dev/null
+
+REPORT=$(grep "^Fan-out:" spectator_host.log | tail -n 1)
+echo "--- host ---"; echo "$REPORT"
+SKIPPED=$(echo "$REPORT" | sed -n 's/.* \([0-9]*\) skipped to snapshot.*/\1/p')
+if [ "$STATUS" -ne 0 ] || [ "${SKIPPED:-0}" -eq 0 ]; then
+    echo "FAILED: swarm status $STATUS, ${SKIPPED:-0} skipped to snapshot"
+    exit 1
+fi
+echo "OK: $SKIPPED updates skipped to snapshot"
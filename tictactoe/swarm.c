@@ -0,0 +1,585 @@
+/**
+ * @file swarm.c
+ * @brief Bot swarm load tester - drives a server with many simulated players.
+ *
+ * The swarm starts its own server (or attaches to a running one with -c),
+ * opens one connection per bot and keeps every bot in matchmaking: a bot that
+ * sees END immediately JOINs again. All bots share one poll() loop, so a few
+ * thousand players fit in a single process. Every move is checked with
+ * makeMove() on the bot's copy of the board before it is sent.
+ *
+ * At the end it reports games/sec, move round-trip latency percentiles (MOVE
+ * sent until the bot's own DELTA arrives) and the server's memory per session.
+ *
+ * With -s, slow spectators watch the bots' games: each one has a small receive
+ * buffer and reads it only every SPECTATOR_READ_INTERVAL_MS, so once the
+ * socket buffers are full the server has to skip it to snapshots
+ * (spectator_test.sh checks the server's count). Every update is applied to
+ * the spectator's copy of the board, which a lost update without a snapshot
+ * would put out of turn; the run fails if that happens. The bots stop when
+ * the run ends and the spectators then read what the server still holds.
+ *
+ * Usage: ./swarm [-n bots] [-d seconds] [-p random|ai] [-s spectators] [-c] [port]
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "tictactoe.h"
+#include "protocol.h"
+
+#define DEFAULT_BOTS 200          /**< Simulated players */
+#define DEFAULT_SECONDS 10        /**< Length of the measured run */
+#define SERVER_START_TIMEOUT_MS 3000 /**< Time the spawned server gets to start listening */
+#define SWARM_SEED 42             /**< Fixed seed so runs are comparable */
+#define RSS_SAMPLE_INTERVAL_MS 100 /**< Period of server memory sampling */
+#define SPECTATOR_READ_INTERVAL_MS 2000 /**< Time a slow spectator leaves its socket unread */
+#define SPECTATOR_RCVBUF 8192     /**< Receive buffer of a slow spectator, small enough to fill between reads */
+#define SPECTATOR_DRAIN_MS 500   /**< Time spectators get after the run to read what the server still holds */
+
+/** Move selection policies. */
+typedef enum {
+    POLICY_RANDOM = 0,  /**< Any empty cell */
+    POLICY_AI           /**< Win if possible, else block, else centre, else random */
+} Policy;
+
+/**
+ * @struct Bot
+ * @brief State of one simulated player.
+ */
+typedef struct {
+    int fd;              /**< Connection to the server */
+    InBuf in;            /**< Bytes received but not yet decoded */
+    OutBuf out;          /**< Messages waiting to be written */
+    Game game;           /**< Bot's copy of the current game */
+    char symbol;         /**< 'X' or 'O' in the current game */
+    long long move_us;   /**< Time the pending MOVE was sent, or 0 */
+} Bot;
+
+/**
+ * @struct Spectator
+ * @brief State of one slow spectator.
+ */
+typedef struct {
+    int fd;              /**< Connection to the server */
+    InBuf in;            /**< Bytes received but not yet decoded */
+    OutBuf out;          /**< WATCH requests waiting to be written */
+    Game game;           /**< Copy of the game being streamed (game_id -1 between games) */
+    int watching;        /**< Game asked for last, or -1 once it has ended */
+    long long read_us;   /**< Time of the last read */
+} Spectator;
+
+/**
+ * @struct SwarmStats
+ * @brief Counters collected over the run.
+ */
+typedef struct {
+    long long games;       /**< Games finished (counted once, by the X seat) */
+    long long moves;       /**< Moves played by bots */
+    long long errors;      /**< ERROR messages received */
+    long long *rtt_us;     /**< Round-trip time of every move */
+    long long num_rtt;     /**< Entries in rtt_us */
+    long long rtt_cap;     /**< Allocated entries in rtt_us */
+    long long watches;     /**< WATCH requests sent by spectators */
+    long long snapshots;   /**< SNAPSHOT messages received by spectators */
+    long long desyncs;     /**< Updates a spectator could not apply to its copy of the board */
+} SwarmStats;
+
+static Policy policy = POLICY_RANDOM;
+static SwarmStats stats;
+static Spectator *spectators;
+static int num_spectators;
+
+/**
+ * @brief Reads the resident set size of a process.
+ * @return RSS in kilobytes, or -1 if /proc is unavailable.
+ */
+static long readRssKb(pid_t pid) {
+    char path[64], line[128];
+    long rss = -1;
+
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "VmRSS: %ld", &rss) == 1) break;
+    }
+    fclose(f);
+    return rss;
+}
+
+/**
+ * @brief Connects a non-blocking TCP socket to the server.
+ * @param port Server port.
+ * @param rcvbuf Receive buffer size, set before connecting, or 0 for the default.
+ * @return Socket descriptor, or -1 on failure.
+ */
+static int connectBot(int port, int rcvbuf) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) return -1;
+    if (rcvbuf > 0) setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    return sock;
+}
+
+/**
+ * @brief Starts ./server on the given port and waits until it accepts connections.
+ * @return The server's pid, or -1 on failure.
+ */
+static pid_t spawnServer(int port) {
+    char port_arg[16];
+    snprintf(port_arg, sizeof(port_arg), "%d", port);
+
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) dup2(devnull, STDOUT_FILENO);
+        execl("./server", "server", port_arg, (char *)NULL);
+        _exit(127);
+    }
+
+    long long start_us = monotonicMicros();
+    while (monotonicMicros() - start_us < SERVER_START_TIMEOUT_MS * 1000LL) {
+        int sock = connectBot(port, 0);
+        if (sock >= 0) {
+            close(sock);
+            return pid;
+        }
+        struct timespec delay = { 0, 10 * 1000000L };
+        nanosleep(&delay, NULL);
+    }
+    kill(pid, SIGTERM);
+    waitpid(pid, NULL, 0);
+    return -1;
+}
+
+/**
+ * @brief Returns a random empty cell.
+ */
+static int randomCell(Game *game) {
+    int position;
+    do {
+        position = rand() % NUM_CELLS;
+    } while (game->board[position / MAX_SIZE][position % MAX_SIZE] != EMPTY_CELL);
+    return position;
+}
+
+/**
+ * @brief Finds a cell that completes a line for symbol.
+ * - Each empty cell is tried on a scratch copy of the game with makeMove()
+ *   and checkWin(), so the bot uses the same rules as the server.
+ *
+ * @return The cell, or -1 if none wins.
+ */
+static int winningCell(const Game *game, char symbol) {
+    for (int position = 0; position < NUM_CELLS; position++) {
+        Game trial = *game;
+        trial.current_turn = (symbol == 'X') ? 0 : 1;
+        if (makeMove(&trial, position, symbol) && checkWin(&trial, symbol)) return position;
+    }
+    return -1;
+}
+
+/**
+ * @brief Picks the bot's next move according to the swarm policy.
+ */
+static int chooseCell(Bot *bot) {
+    Game *game = &bot->game;
+
+    if (policy == POLICY_AI) {
+        char other = (bot->symbol == 'X') ? 'O' : 'X';
+        int position = winningCell(game, bot->symbol);
+        if (position < 0) position = winningCell(game, other);
+        if (position < 0 && game->board[MAX_SIZE / 2][MAX_SIZE / 2] == EMPTY_CELL) {
+            position = (MAX_SIZE / 2) * MAX_SIZE + MAX_SIZE / 2;
+        }
+        if (position >= 0) return position;
+    }
+    return randomCell(game);
+}
+
+/**
+ * @brief Chooses a move, checks it against the engine and queues the MOVE.
+ */
+static void playMove(Bot *bot) {
+    int position = chooseCell(bot);
+    Game check = bot->game;
+
+    if (!makeMove(&check, position, bot->symbol)) {
+        printf("Bot on socket %d chose illegal cell %d\n", bot->fd, position);
+        return;
+    }
+    Message move = { .type = MSG_MOVE, .game_id = (unsigned)bot->game.game_id, .cell = (unsigned)position };
+    protoEncode(&bot->out, &move);
+    bot->move_us = monotonicMicros();
+}
+
+/**
+ * @brief Records one move round trip.
+ */
+static void recordRtt(long long us) {
+    if (stats.num_rtt == stats.rtt_cap) {
+        long long cap = stats.rtt_cap ? stats.rtt_cap * 2 : 4096;
+        long long *rtt = realloc(stats.rtt_us, (size_t)cap * sizeof(long long));
+        if (!rtt) return;
+        stats.rtt_us = rtt;
+        stats.rtt_cap = cap;
+    }
+    stats.rtt_us[stats.num_rtt++] = us;
+}
+
+/**
+ * @brief Hands a game that just started to the first spectator without one.
+ */
+static void offerGame(int game_id) {
+    for (int i = 0; i < num_spectators; i++) {
+        Spectator *spectator = &spectators[i];
+        if (spectator->watching >= 0) continue;
+        Message watch = { .type = MSG_WATCH, .game_id = (unsigned)game_id };
+        protoEncode(&spectator->out, &watch);
+        spectator->watching = game_id;
+        stats.watches++;
+        return;
+    }
+}
+
+/**
+ * @brief Frees the spectator that asked for a game once the game has ended.
+ */
+static void endGame(int game_id) {
+    for (int i = 0; i < num_spectators; i++) {
+        if (spectators[i].watching == game_id) spectators[i].watching = -1;
+    }
+}
+
+/**
+ * @brief Applies one server message to a spectator's copy of the game.
+ * - A SNAPSHOT replaces the copy, whether it answers a WATCH or skips a backlog.
+ *   A DELTA that is illegal on the copy means an update went missing without a
+ *   snapshot to cover it.
+ */
+static void handleSpectatorMessage(Spectator *spectator, const Message *msg) {
+    switch (msg->type) {
+        case MSG_SNAPSHOT:
+            stats.snapshots++;
+            protoRestore(msg, &spectator->game);
+            break;
+        case MSG_DELTA:
+            if ((int)msg->game_id != spectator->game.game_id ||
+                !makeMove(&spectator->game, (int)msg->cell, msg->symbol)) {
+                stats.desyncs++;
+            }
+            break;
+        case MSG_END:
+            spectator->game.game_id = -1;
+            break;
+        case MSG_ERROR:
+            // ERR_NO_SUCH_GAME: the game ended before the WATCH arrived.
+            if (msg->value != ERR_NO_SUCH_GAME) stats.errors++;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Sends a spectator's WATCH requests and, once per SPECTATOR_READ_INTERVAL_MS,
+ * reads everything the server has managed to send it.
+ * @return 0 if the connection is still usable, -1 otherwise.
+ */
+static int serviceSpectator(Spectator *spectator) {
+    if (spectator->out.len > 0 && outBufFlush(spectator->fd, &spectator->out) != 0) return -1;
+    if (monotonicMicros() - spectator->read_us < SPECTATOR_READ_INTERVAL_MS * 1000LL) return 0;
+
+    spectator->read_us = monotonicMicros();
+    while (1) {
+        int n = inBufFill(spectator->fd, &spectator->in);
+        if (n <= 0) return (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) ? 0 : -1;
+        Message msg;
+        int status;
+        while ((status = inBufNext(&spectator->in, &msg)) == 1) handleSpectatorMessage(spectator, &msg);
+        if (status < 0) {
+            printf("Spectator on socket %d received a malformed message.\n", spectator->fd);
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Reads spectators continuously for SPECTATOR_DRAIN_MS once the bots have stopped.
+ * @return Number of spectators still connected.
+ */
+static int drainSpectators(int alive) {
+    long long end_us = monotonicMicros() + SPECTATOR_DRAIN_MS * 1000LL;
+    struct timespec delay = { 0, 10 * 1000000L };
+
+    while (alive > 0 && monotonicMicros() < end_us) {
+        for (int i = 0; i < num_spectators; i++) {
+            if (spectators[i].fd < 0) continue;
+            spectators[i].read_us = 0;
+            if (serviceSpectator(&spectators[i]) != 0) {
+                close(spectators[i].fd);
+                spectators[i].fd = -1;
+                alive--;
+            }
+        }
+        nanosleep(&delay, NULL);
+    }
+    return alive;
+}
+
+/**
+ * @brief Applies one server message to a bot and queues its reply, if any.
+ */
+static void handleMessage(Bot *bot, const Message *msg) {
+    Message join = { .type = MSG_JOIN };
+
+    switch (msg->type) {
+        case MSG_START:
+            initializeBoard(&bot->game);
+            bot->game.game_id = (int)msg->game_id;
+            bot->symbol = msg->symbol;
+            if (bot->symbol == 'X') {
+                offerGame(bot->game.game_id);
+                playMove(bot);
+            }
+            break;
+        case MSG_DELTA:
+            makeMove(&bot->game, (int)msg->cell, msg->symbol);
+            if (msg->symbol == bot->symbol) {
+                recordRtt(monotonicMicros() - bot->move_us);
+                bot->move_us = 0;
+                stats.moves++;
+            } else if (!checkWin(&bot->game, msg->symbol) && !isBoardFull(&bot->game)) {
+                playMove(bot);
+            }
+            break;
+        case MSG_ERROR:
+            stats.errors++;
+            break;
+        case MSG_END:
+            if (bot->symbol == 'X') {
+                stats.games++;
+                endGame((int)msg->game_id);
+            }
+            protoEncode(&bot->out, &join);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Comparison function for qsort over latencies.
+ */
+static int compareLongLong(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns the q-th quantile of a sorted array.
+ */
+static long long percentile(const long long *sorted, long long count, double q) {
+    if (count == 0) return 0;
+    long long index = (long long)(q * (double)(count - 1) + 0.5);
+    return sorted[index];
+}
+
+int main(int argc, char *argv[]) {
+    int num_bots = DEFAULT_BOTS, seconds = DEFAULT_SECONDS, external = 0, opt;
+
+    while ((opt = getopt(argc, argv, "n:d:p:s:c")) != -1) {
+        if (opt == 'n') num_bots = atoi(optarg);
+        else if (opt == 's') num_spectators = atoi(optarg);
+        else if (opt == 'd') seconds = atoi(optarg);
+        else if (opt == 'p') policy = (strcmp(optarg, "ai") == 0) ? POLICY_AI : POLICY_RANDOM;
+        else if (opt == 'c') external = 1;
+        else {
+            printf("Usage: %s [-n bots] [-d seconds] [-p random|ai] [-s spectators] [-c] [port]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    int port = (optind < argc) ? atoi(argv[optind]) : PORT;
+    if (num_bots < 2 || seconds < 1 || num_spectators < 0) {
+        printf("Need at least 2 bots, 1 second and no negative spectator count.\n");
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    srand(SWARM_SEED);
+
+    // Room for our sockets; the spawned server inherits the raised limit.
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < (rlim_t)(num_bots + num_spectators) + 64) {
+        rlim_t want = (rlim_t)(num_bots + num_spectators) + 64;
+        rl.rlim_cur = (rl.rlim_max < want) ? rl.rlim_max : want;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    pid_t server = -1;
+    if (!external) {
+        server = spawnServer(port);
+        if (server < 0) {
+            printf("Unable to start ./server on port %d.\n", port);
+            return EXIT_FAILURE;
+        }
+    }
+    long rss_idle = (server > 0) ? readRssKb(server) : -1;
+
+    Bot *bots = calloc((size_t)num_bots, sizeof(Bot));
+    struct pollfd *pfds = calloc((size_t)num_bots, sizeof(struct pollfd));
+    spectators = calloc((size_t)num_spectators + 1, sizeof(Spectator));
+    if (!bots || !pfds || !spectators) {
+        printf("Memory allocation failed.\n");
+        return EXIT_FAILURE;
+    }
+
+    Message hello = { .type = MSG_HELLO, .value = PROTO_VERSION, .role = ROLE_PLAYER };
+    Message join = { .type = MSG_JOIN };
+    for (int i = 0; i < num_bots; i++) {
+        bots[i].fd = connectBot(port, 0);
+        if (bots[i].fd < 0) {
+            printf("Bot %d failed to connect: %s\n", i, strerror(errno));
+            num_bots = i;
+            break;
+        }
+        protoEncode(&bots[i].out, &hello);
+        protoEncode(&bots[i].out, &join);
+        pfds[i].fd = bots[i].fd;
+    }
+    Message watcher = { .type = MSG_HELLO, .value = PROTO_VERSION, .role = ROLE_SPECTATOR };
+    for (int i = 0; i < num_spectators; i++) {
+        spectators[i].fd = connectBot(port, SPECTATOR_RCVBUF);
+        if (spectators[i].fd < 0) {
+            printf("Spectator %d failed to connect: %s\n", i, strerror(errno));
+            num_spectators = i;
+            break;
+        }
+        protoEncode(&spectators[i].out, &watcher);
+        spectators[i].game.game_id = -1;
+        spectators[i].watching = -1;
+        spectators[i].read_us = monotonicMicros();
+    }
+
+    printf("Swarm: %d bots, %d slow spectators, %s policy, %d s on port %d\n",
+           num_bots, num_spectators, (policy == POLICY_AI) ? "ai" : "random", seconds, port);
+    fflush(stdout);
+
+    long long start_us = monotonicMicros();
+    long long end_us = start_us + seconds * 1000000LL;
+    long rss_peak = rss_idle;
+    long long rss_sampled_us = 0;
+    int alive = num_bots, spectators_alive = num_spectators;
+
+    while (alive > 0 && monotonicMicros() < end_us) {
+        for (int i = 0; i < num_bots; i++) {
+            if (pfds[i].fd < 0) continue;
+            if (bots[i].out.len > 0 && outBufFlush(bots[i].fd, &bots[i].out) != 0) {
+                printf("Bot %d failed to send: %s\n", i, strerror(errno));
+                pfds[i].fd = -1;
+                alive--;
+                continue;
+            }
+            pfds[i].events = POLLIN | (bots[i].out.len > 0 ? POLLOUT : 0);
+        }
+
+        for (int i = 0; i < num_spectators; i++) {
+            if (spectators[i].fd >= 0 && serviceSpectator(&spectators[i]) != 0) {
+                close(spectators[i].fd);
+                spectators[i].fd = -1;
+                spectators_alive--;
+            }
+        }
+
+        int timeout_ms = (int)((end_us - monotonicMicros()) / 1000);
+        if (num_spectators > 0 && timeout_ms > SPECTATOR_READ_INTERVAL_MS) timeout_ms = SPECTATOR_READ_INTERVAL_MS;
+        if (poll(pfds, (nfds_t)num_bots, timeout_ms > 0 ? timeout_ms : 0) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        for (int i = 0; i < num_bots; i++) {
+            if (pfds[i].fd < 0 || !(pfds[i].revents & (POLLIN | POLLERR | POLLHUP))) continue;
+
+            int n = inBufFill(bots[i].fd, &bots[i].in);
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+                pfds[i].fd = -1;
+                alive--;
+                continue;
+            }
+            Message msg;
+            int status;
+            while ((status = inBufNext(&bots[i].in, &msg)) == 1) handleMessage(&bots[i], &msg);
+            if (status < 0) {
+                printf("Bot %d received a malformed message.\n", i);
+                pfds[i].fd = -1;
+                alive--;
+            }
+        }
+
+        if (server > 0 && monotonicMicros() - rss_sampled_us >= RSS_SAMPLE_INTERVAL_MS * 1000LL) {
+            long rss = readRssKb(server);
+            if (rss > rss_peak) rss_peak = rss;
+            rss_sampled_us = monotonicMicros();
+        }
+    }
+    double elapsed = (monotonicMicros() - start_us) / 1e6;
+    spectators_alive = drainSpectators(spectators_alive);
+
+    if (alive < num_bots) printf("%d bots lost their connection.\n", num_bots - alive);
+    if (spectators_alive < num_spectators) printf("%d spectators lost their connection.\n", num_spectators - spectators_alive);
+    for (int i = 0; i < num_bots; i++) {
+        close(bots[i].fd);
+        outBufFree(&bots[i].out);
+    }
+    for (int i = 0; i < num_spectators; i++) {
+        if (spectators[i].fd >= 0) close(spectators[i].fd);
+        outBufFree(&spectators[i].out);
+    }
+    free(bots);
+    free(pfds);
+    free(spectators);
+
+    qsort(stats.rtt_us, (size_t)stats.num_rtt, sizeof(long long), compareLongLong);
+    printf("Games:        %lld in %.2f s (%.1f games/sec)\n", stats.games, elapsed, stats.games / elapsed);
+    printf("Moves:        %lld (%.1f moves/sec), %lld errors\n", stats.moves, stats.moves / elapsed, stats.errors);
+    printf("Move RTT us:  p50 %lld  p90 %lld  p99 %lld  max %lld\n",
+           percentile(stats.rtt_us, stats.num_rtt, 0.50), percentile(stats.rtt_us, stats.num_rtt, 0.90),
+           percentile(stats.rtt_us, stats.num_rtt, 0.99),
+           stats.num_rtt ? stats.rtt_us[stats.num_rtt - 1] : 0);
+    if (server > 0 && rss_idle >= 0) {
+        printf("Server RSS:   %ld KB idle, %ld KB peak, %.2f KB per session\n",
+               rss_idle, rss_peak, (double)(rss_peak - rss_idle) / num_bots);
+    }
+    if (num_spectators > 0) {
+        printf("Spectators:   %lld watches, %lld snapshots, %lld out of sync\n",
+               stats.watches, stats.snapshots, stats.desyncs);
+    }
+    free(stats.rtt_us);
+
+    if (server > 0) {
+        kill(server, SIGTERM);
+        waitpid(server, NULL, 0);
+    }
+    int ok = stats.errors == 0 && stats.desyncs == 0 && alive == num_bots && spectators_alive == num_spectators;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
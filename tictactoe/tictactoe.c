@@ -0,0 +1,107 @@
+/**
+ * @file tictactoe.c
+ * @brief Tic-Tac-Toe game logic shared by the server and the client.
+ *
+ * Cells are addressed by a 0-based position: row * MAX_SIZE + column.
+ * Every function works for any MAX_SIZE, so the board size can grow
+ * without touching the networking code.
+ */
+
+#include "tictactoe.h"
+
+/**
+ * @brief Clears the board and resets the turn to Player X.
+ * @param game Game to reset.
+ */
+void initializeBoard(Game *game) {
+    memset(game->board, EMPTY_CELL, sizeof(game->board));
+    game->current_turn = 0;
+    game->move_count = 0;
+    game->active = 1;
+}
+
+/**
+ * @brief Prints the board; empty cells show their 1-based position number.
+ * @param game Game to display.
+ */
+void displayBoard(Game *game) {
+    int width = (NUM_CELLS >= 100) ? 3 : (NUM_CELLS >= 10) ? 2 : 1;
+
+    printf("\n");
+    for (int row = 0; row < MAX_SIZE; row++) {
+        for (int col = 0; col < MAX_SIZE; col++) {
+            char cell = game->board[row][col];
+            if (cell == EMPTY_CELL) {
+                printf(" %*d ", width, row * MAX_SIZE + col + 1);
+            } else {
+                printf(" %*c ", width, cell);
+            }
+            if (col < MAX_SIZE - 1) printf("|");
+        }
+        printf("\n");
+        if (row < MAX_SIZE - 1) {
+            for (int col = 0; col < MAX_SIZE; col++) {
+                for (int i = 0; i < width + 2; i++) printf("-");
+                if (col < MAX_SIZE - 1) printf("+");
+            }
+            printf("\n");
+        }
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Checks whether a symbol owns a full row, column or diagonal.
+ * @param game Game to inspect.
+ * @param symbol 'X' or 'O'.
+ * @return 1 if the symbol has won, 0 otherwise.
+ */
+int checkWin(Game *game, char symbol) {
+    int diag = 1, anti_diag = 1;
+
+    for (int i = 0; i < MAX_SIZE; i++) {
+        int row = 1, col = 1;
+        for (int j = 0; j < MAX_SIZE; j++) {
+            if (game->board[i][j] != symbol) row = 0;
+            if (game->board[j][i] != symbol) col = 0;
+        }
+        if (row || col) return 1;
+
+        if (game->board[i][i] != symbol) diag = 0;
+        if (game->board[i][MAX_SIZE - 1 - i] != symbol) anti_diag = 0;
+    }
+    return diag || anti_diag;
+}
+
+/**
+ * @brief Places a symbol on the board if the move is legal.
+ * - The game must be active, the position on the board and the cell empty.
+ * - The symbol must belong to the player whose turn it is.
+ * - On success the turn passes to the other player.
+ *
+ * @param game Game to update.
+ * @param position 0-based cell index.
+ * @param symbol 'X' or 'O'.
+ * @return 1 if the move was applied, 0 if it was rejected.
+ */
+int makeMove(Game *game, int position, char symbol) {
+    if (!game->active || position < 0 || position >= NUM_CELLS) return 0;
+    if (symbol != (game->current_turn == 0 ? 'X' : 'O')) return 0;
+
+    char *cell = &game->board[position / MAX_SIZE][position % MAX_SIZE];
+    if (*cell != EMPTY_CELL) return 0;
+
+    *cell = symbol;
+    game->move_count++;
+    game->current_turn = !game->current_turn;
+    return 1;
+}
+
+/**
+ * @brief Reports whether every cell has been played.
+ * @param game Game to inspect.
+ * @return 1 if the board is full, 0 otherwise.
+ */
+int isBoardFull(Game *game) {
+    return game->move_count >= NUM_CELLS;
+}
@@ -11,6 +11,8 @@
 #define MAX_SIZE 3        /**< Standard Tic-Tac-Toe board size */
 #define PORT 8080         /**< Default networking port */
 #define MAX_PLAYERS 10    /**< Maximum number of players */
+#define NUM_CELLS (MAX_SIZE * MAX_SIZE) /**< Number of cells on the board */
+#define EMPTY_CELL ' '    /**< Marker for an unplayed cell */
 
 /* ================== GAME STRUCTURES ================== */
 
@@ -35,6 +37,7 @@ typedef struct {
  char board[MAX_SIZE][MAX_SIZE]; /**< Game board state */
  int current_turn;       /**< 0 = Player X, 1 = Player O */
  int active;             /**< 1 = In Progress, 0 = Completed */
+ int move_count;         /**< Moves played so far (doubles as the move sequence number) */
 } Game;
 
 /* ================== FUNCTION PROTOTYPES ================== */
@@ -44,9 +47,11 @@ void initializeBoard(Game *game);
 void displayBoard(Game *game);
 int checkWin(Game *game, char symbol);
 int makeMove(Game *game, int position, char symbol);
+int isBoardFull(Game *game);
 
 /* Server & Client Networking */
 int isServerRunning();
 void promoteNewHost();
+int runStandby(const char *host_ip, int port);
 
 #endif
\ No newline at end of file